@@ -1,7 +1,9 @@
 # Dependency-free build for machines without CMake.
-#   make -f build.mk            # build both binaries into bin/
+#   make -f build.mk            # build the binaries into bin/
 #   make -f build.mk run-server # build and serve the web demo on :8080
+#   make -f build.mk test       # build and run the unit tests
 #   make -f build.mk clean
+#   make -f build.mk PROFILE=1  # with the training phase timers (clean first)
 #
 # Named build.mk rather than Makefile because .gitignore excludes "Makefile"
 # (a leftover from in-source CMake builds).
@@ -10,6 +12,10 @@ CXX      ?= g++
 CXXFLAGS ?= -std=c++17 -O2 -Wall -Wextra -Iinclude -Ithird_party
 LDFLAGS  ?= -pthread
 
+ifeq ($(PROFILE),1)
+CXXFLAGS += -DBLACKJACK_PROFILE
+endif
+
 BUILD := build/obj
 BIN   := bin
 
@@ -18,9 +24,12 @@ CORE_OBJ := $(CORE_SRC:%.cpp=$(BUILD)/%.o)
 
 CLI_OBJ    := $(BUILD)/src/main.o
 SERVER_OBJ := $(BUILD)/src/server/main.o
+LOADGEN_OBJ := $(BUILD)/src/loadgen/main.o
+BENCH_OBJ  := $(BUILD)/src/bench/main.o
+TEST_OBJ   := $(patsubst %.cpp,$(BUILD)/%.o,$(wildcard tests/*.cpp))
 
-.PHONY: all clean run-server run-cli
-all: $(BIN)/blackjack_ai $(BIN)/blackjack_server
+.PHONY: all clean run-server run-cli bench test
+all: $(BIN)/blackjack_ai $(BIN)/blackjack_server $(BIN)/blackjack_loadgen $(BIN)/blackjack_bench
 
 $(BIN)/blackjack_ai: $(CORE_OBJ) $(CLI_OBJ)
 	@mkdir -p $(@D)
@@ -30,6 +39,21 @@ $(BIN)/blackjack_server: $(CORE_OBJ) $(SERVER_OBJ)
 	@mkdir -p $(@D)
 	$(CXX) $(CXXFLAGS) -o $@ $^ $(LDFLAGS)
 
+$(BIN)/blackjack_bench: $(CORE_OBJ) $(BENCH_OBJ)
+	@mkdir -p $(@D)
+	$(CXX) $(CXXFLAGS) -o $@ $^ $(LDFLAGS)
+
+# The tests include headers by bare name, as tests/CMakeLists.txt sets them up.
+$(BUILD)/tests/%.o: CXXFLAGS += -Iinclude/core -Iinclude/ai -Iinclude/api -Isrc/api
+
+$(BIN)/blackjack_tests: $(CORE_OBJ) $(TEST_OBJ)
+	@mkdir -p $(@D)
+	$(CXX) $(CXXFLAGS) -o $@ $^ $(LDFLAGS)
+
+$(BIN)/blackjack_loadgen: $(LOADGEN_OBJ)
+	@mkdir -p $(@D)
+	$(CXX) $(CXXFLAGS) -o $@ $^ $(LDFLAGS)
+
 $(BUILD)/%.o: %.cpp
 	@mkdir -p $(@D)
 	$(CXX) $(CXXFLAGS) -MMD -MP -c $< -o $@
@@ -44,5 +68,11 @@ run-server: $(BIN)/blackjack_server
 run-cli: $(BIN)/blackjack_ai
 	./$(BIN)/blackjack_ai
 
+bench: $(BIN)/blackjack_bench
+	./$(BIN)/blackjack_bench --json bench.json
+
+test: $(BIN)/blackjack_tests
+	./$(BIN)/blackjack_tests
+
 clean:
 	rm -rf build $(BIN)
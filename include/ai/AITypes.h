@@ -23,10 +23,41 @@ struct State {
     }
 };
 
+// Bounds of the state space the agents learn over. Player sums below 4 cannot
+// be dealt and 21 is the last decision point; upcards run 2..11 (ace = 11).
+constexpr int MIN_STATE_PLAYER_SUM = 4;
+constexpr int MAX_STATE_PLAYER_SUM = 21;
+constexpr int MIN_STATE_UPCARD     = 2;
+constexpr int MAX_STATE_UPCARD     = 11;
+constexpr int STATE_COUNT =
+    (MAX_STATE_PLAYER_SUM - MIN_STATE_PLAYER_SUM + 1) * (MAX_STATE_UPCARD - MIN_STATE_UPCARD + 1) * 2;
+
+inline bool inStateSpace(const State& s) {
+    return s.playerSum >= MIN_STATE_PLAYER_SUM && s.playerSum <= MAX_STATE_PLAYER_SUM &&
+           s.dealerUpcard >= MIN_STATE_UPCARD && s.dealerUpcard <= MAX_STATE_UPCARD;
+}
+
+// Dense encoding of a state onto 0..STATE_COUNT-1. Only meaningful for states
+// inside the space; see inStateSpace.
+inline int stateIndex(const State& s) {
+    return (s.playerSum - MIN_STATE_PLAYER_SUM) * 20 + (s.dealerUpcard - MIN_STATE_UPCARD) * 2 + s.usableAce;
+}
+
+// Inverse of stateIndex.
+inline State stateAt(int index) {
+    return State{MIN_STATE_PLAYER_SUM + index / 20, MIN_STATE_UPCARD + (index % 20) / 2, (index % 2) != 0};
+}
+
+// What both agents play in a state they have never learned: hit below 17,
+// stand otherwise.
+inline Action fallbackAction(const State& s) {
+    return (s.playerSum < 17) ? Action::HIT : Action::STAND;
+}
+
 // Hash function for State (for unordered_map)
 struct StateHash {
     size_t operator()(const State& s) const {
-        return ((s.playerSum - 4) * 20 + (s.dealerUpcard - 2) * 2 + s.usableAce);
+        return static_cast<size_t>(stateIndex(s));
     }
 };
 
@@ -5,43 +5,26 @@
 #ifndef BLACKJACK_AI_MONTECARLOAI_H
 #define BLACKJACK_AI_MONTECARLOAI_H
 
-#include <unordered_map>
+#include <cstdint>
 #include <vector>
 #include <array>
 #include <string>
-#include <random>
 #include <utility>
 #include "AITypes.h"
-
-// State-Action pair for episode tracking
-struct StateAction {
-    State state;
-    Action action;
-
-    bool operator==(const StateAction& other) const {
-        return state == other.state && action == other.action;
-    }
-};
-
-struct StateActionHash {
-    size_t operator()(const StateAction& sa) const {
-        StateHash sh;
-        return sh(sa.state) * 3 + static_cast<int>(sa.action);
-    }
-};
+#include "StateTable.h"
+#include "PolicySnapshot.h"
+#include "../core/Random.h"
 
 class MonteCarloAI {
 private:
-    // Q-values: State → [Q(s,HIT), Q(s,STAND)]
-    std::unordered_map<State, std::array<double, 2>, StateHash> qTable;
-
-    // Returns: Sum of returns for each state-action pair
-    std::unordered_map<StateAction, double, StateActionHash> returns;
-
-    // Visit counts: Number of times each state-action pair was visited
-    std::unordered_map<StateAction, int, StateActionHash> visitCounts;
+    // Q-values: State → [Q(s,HIT), Q(s,STAND)], with the number of
+    // first visits to each pair in the same record. Q is the running sample
+    // mean of returns, so the visit count is all the update needs -- the sum
+    // of returns is never stored.
+    StateTable<QEntry> qTable;
 
     // Hyperparameters
+    static constexpr double EPSILON_FLOOR = 0.01;
     double epsilon;    // Exploration rate
     double gamma;      // Discount factor
 
@@ -49,9 +32,8 @@ private:
     int episodeCount;
     double totalReward;
 
-    // RNG
-    std::mt19937 rng;
-    std::uniform_real_distribution<double> dist;
+    // Exploration draws; a new agent takes the next Domain::Explore seed.
+    rng::Stream explore;
 
     // Episode storage
     struct Step {
@@ -85,10 +67,20 @@ public:
     void setEpsilon(double newEpsilon);
     void setGamma(double newGamma);
 
+    // Restart exploration from a fixed seed, for repeatable runs.
+    void reseed(std::uint64_t seed) { explore = rng::Stream(seed); }
+
     // Training utilities
     void decayEpsilon(double decayRate = 0.9995);
     void printStats() const;
     int getEpisodeCount() const { return episodeCount; }
+    double getEpsilon() const { return epsilon; }
+
+    // Epsilon after `episodes` more decays at `decayRate`, floor included.
+    double epsilonAfter(long long episodes, double decayRate) const;
+
+    // Frozen copy of the table, versioned by the episode count.
+    PolicySnapshot snapshot() const;
 
     // Get visit count for a state-action pair (for analysis)
     int getVisitCount(const State& state, Action action) const;
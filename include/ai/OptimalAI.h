@@ -0,0 +1,98 @@
+//
+// The exact hit/stand policy for this engine, computed rather than learned.
+//
+// Both learners estimate Q(s, HIT) and Q(s, STAND) from millions of sampled
+// hands. Under fixed rules those values can simply be worked out: the dealer's
+// final-total distribution for each upcard follows from the draw-to-17 rule,
+// standing is a comparison against it, and hitting is an expectation over the
+// next card -- so backward induction from 21 gives every state's Q exactly.
+// OptimalAI does that once, in its constructor, and then answers the same
+// questions the learners do.
+//
+// The rules are the engine's own (see rules::computeReward and
+// Dealer::playTurn): the dealer stands on soft 17 and never peeks, a natural
+// pays 3:2 unless the dealer also has one, and a dealer natural against a
+// player's drawn 21 is a push.
+//
+// With numDecks == INFINITE_DECK every card is drawn with its full-deck
+// probability and each state has one exact value. With a finite shoe, card
+// removal makes a hand's value depend on its composition, not just its total:
+// every composition is solved exactly against a freshly shuffled N-deck shoe,
+// and a state's Q is the average over the compositions that reach it, weighted
+// by how often they do under the policy being solved. The policy is refined
+// until no state's action changes (two or three passes in practice).
+//
+
+#ifndef BLACKJACK_AI_OPTIMALAI_H
+#define BLACKJACK_AI_OPTIMALAI_H
+
+#include "AITypes.h"
+#include "../core/Shoe.h"
+#include <array>
+#include <bitset>
+#include <functional>
+#include <memory>
+#include <string>
+
+class OptimalAI {
+public:
+    static constexpr int INFINITE_DECK = 0;
+
+    // Where the dealer ends up, given only the upcard.
+    struct DealerOdds {
+        std::array<double, 5> total{};   // final 17..21 (a natural counts as 21)
+        double natural = 0.0;            // the two-card 21 included in total[4]
+        double bust = 0.0;
+    };
+
+    struct Model;   // the solved composition graph; see OptimalAI.cpp
+
+private:
+    int decks;
+    std::shared_ptr<const Model> model;
+    std::array<std::array<double, 2>, STATE_COUNT> q{};
+    std::bitset<STATE_COUNT> reachable;   // states a hand can actually be in
+    std::array<DealerOdds, 10> dealer{};  // by upcard, 2..11
+    double ev = 0.0;
+    int passes = 0;
+    double solveMs = 0.0;
+
+public:
+    // Solves immediately. numDecks is INFINITE_DECK or clamped to the Shoe's
+    // range.
+    explicit OptimalAI(int numDecks = Shoe::DEFAULT_DECKS);
+
+    Action getBestAction(const State& state) const;
+    double getQValue(const State& state, Action action) const;
+
+    // Value of playing on optimally from this state: the better of the two Qs,
+    // or Q(STAND) at 21 where the engine stands for you.
+    double getStateValue(const State& state) const;
+
+    // False for states no hand can be in (soft totals below 12, for example);
+    // their Q-values are zero and the action is the learners' fallback.
+    bool hasValue(const State& state) const;
+
+    // Expected return per hand, naturals included, from a fresh shoe.
+    double expectedReturn() const { return ev; }
+
+    // The same, exactly, for any other hit/stand policy on this shoe -- a
+    // learner's greedy policy, or rules::basicStrategy. One pass over the
+    // solved hands, so it costs milliseconds where a simulation accurate to
+    // +-0.003 needs hundreds of thousands of hands.
+    double expectedReturn(const std::function<Action(const State&)>& policy) const;
+
+    const DealerOdds& dealerOdds(int upcard) const;
+
+    int numDecks() const { return decks; }
+    int solvePasses() const { return passes; }
+    double solveMillis() const { return solveMs; }
+
+    // Same formats as the learners' tables (CSV for ".csv" paths, binary
+    // otherwise), with visit counts of 0.
+    void saveQTable(const std::string& filename) const;
+    void printStats() const;
+    void printStrategy() const;
+};
+
+#endif //BLACKJACK_AI_OPTIMALAI_H
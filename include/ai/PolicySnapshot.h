@@ -0,0 +1,60 @@
+//
+// An immutable copy of an agent's table at one moment.
+//
+// Anything that wants to read a policy while the agent keeps learning -- actor
+// threads playing against a frozen policy, request handlers that should not
+// wait on a trainer -- reads one of these instead of the live table. It answers
+// the same questions the agents do (best action with the same unlearned
+// fallback, Q-values, visit counts) from plain arrays.
+//
+
+#ifndef BLACKJACK_AI_POLICYSNAPSHOT_H
+#define BLACKJACK_AI_POLICYSNAPSHOT_H
+
+#include "AITypes.h"
+#include "StateTable.h"
+#include <array>
+#include <bitset>
+#include <cstdint>
+
+struct PolicySnapshot {
+    // Caller-defined version, e.g. the agent's episode count when taken.
+    std::uint64_t version = 0;
+    std::array<std::array<double, 2>, STATE_COUNT> q{};
+    std::array<std::array<int, 2>, STATE_COUNT> visits{};
+    std::bitset<STATE_COUNT> learned;
+
+    static PolicySnapshot of(const StateTable<QEntry>& table, std::uint64_t version) {
+        PolicySnapshot snap;
+        snap.version = version;
+        table.forEach([&](const State& s, const QEntry& e) {
+            int i = stateIndex(s);
+            snap.learned.set(i);
+            snap.q[i] = {e.q[0], e.q[1]};
+            snap.visits[i] = {e.visits[0], e.visits[1]};
+        });
+        return snap;
+    }
+
+    bool hasLearned(const State& s) const {
+        return inStateSpace(s) && learned.test(stateIndex(s));
+    }
+
+    double qValue(const State& s, Action a) const {
+        return hasLearned(s) ? q[stateIndex(s)][static_cast<int>(a)] : 0.0;
+    }
+
+    int visitCount(const State& s, Action a) const {
+        return hasLearned(s) ? visits[stateIndex(s)][static_cast<int>(a)] : 0;
+    }
+
+    // Greedy action, with the agents' fallback for unlearned states.
+    Action best(const State& s) const {
+        if (!hasLearned(s)) return fallbackAction(s);
+        const auto& v = q[stateIndex(s)];
+        return v[static_cast<int>(Action::HIT)] > v[static_cast<int>(Action::STAND)]
+               ? Action::HIT : Action::STAND;
+    }
+};
+
+#endif //BLACKJACK_AI_POLICYSNAPSHOT_H
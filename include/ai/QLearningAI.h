@@ -6,26 +6,31 @@
 #define BLACKJACK_AI_QLEARNINGAI_H
 
 #include "AITypes.h"
-#include <unordered_map>
+#include "StateTable.h"
+#include "PolicySnapshot.h"
+#include "../core/Random.h"
 #include <array>
+#include <cstdint>
+#include <memory>
 #include <string>
-#include <random>
 
 
 class QLearningAI {
 private:
-    // Q-table: State → [Q(s,HIT), Q(s,STAND)]
-    std::unordered_map<State, std::array<double, 2>, StateHash> qTable;
-
-    // Visits per (state, action). Drives the decaying learning rate, and is
-    // worth having anyway as a confidence signal for analysis.
-    std::unordered_map<State, std::array<int, 2>, StateHash> visitCounts;
+    // Q-table: State → [Q(s,HIT), Q(s,STAND)], alongside the visits per
+    // (state, action). Visits drive the decaying learning rate, and are worth
+    // having anyway as a confidence signal for analysis.
+    //
+    // Held by pointer so that workers (see Worker) can share it and keep it
+    // alive. Copying a QLearningAI copies the table; only a Worker shares one.
+    std::shared_ptr<StateTable<QEntry>> qTable;
 
     // Exponent on the 1/n learning-rate schedule. Must stay in (0.5, 1] for
     // Robbins-Monro convergence; lower means faster forgetting.
     static constexpr double LEARNING_RATE_EXPONENT = 0.7;
 
     // Hyperparameters
+    static constexpr double EPSILON_FLOOR = 0.05;
     double alpha;      // Minimum learning rate. The step size is
                        // max(alpha, 1/visits^0.7), so alpha is the floor that
                        // keeps the agent adaptive rather than a constant rate.
@@ -38,13 +43,29 @@ private:
     int episodeCount;
     double totalReward;
 
-    // RNG
-    std::mt19937 rng;
-    std::uniform_real_distribution<double> dist;
+    // Exploration draws; a new agent takes the next Domain::Explore seed.
+    rng::Stream explore;
+
+    // The policy and update rule, shared with Worker.
+    static Action choose(const StateTable<QEntry>& table, const State& state,
+                         double epsilon, rng::Stream& explore);
+    static Action best(const StateTable<QEntry>& table, const State& state);
+    static void update(StateTable<QEntry>& table, double alpha, double gamma,
+                       const State& state, Action action, double reward,
+                       const State& nextState, bool isTerminal);
 
 public:
+    class Worker;
+
     QLearningAI(double alpha = 0.01, double gamma = 1.0, double epsilon = 1.0);
 
+    // Copies are independent: the table is copied with the rest. A moved-from
+    // agent has no table and may only be assigned to.
+    QLearningAI(const QLearningAI& other);
+    QLearningAI& operator=(const QLearningAI& other);
+    QLearningAI(QLearningAI&&) noexcept = default;
+    QLearningAI& operator=(QLearningAI&&) noexcept = default;
+
     // ε-greedy action selection
     Action chooseAction(const State& state);
 
@@ -72,8 +93,58 @@ public:
     // Training utilities
     void decayEpsilon(double decayRate = 0.9995);  // Gradual exploration decay
     void recordEpisode(double reward);
+    void recordEpisodes(int count, double reward);   // a batch run elsewhere
     void printStats() const;
     int getEpisodeCount() const { return episodeCount; }
+    double getEpsilon() const { return epsilon; }
+
+    // Epsilon after `episodes` more decays at `decayRate`, floor included --
+    // what decayEpsilon would reach one episode at a time.
+    double epsilonAfter(long long episodes, double decayRate) const;
+
+    // Restart exploration from a fixed seed, for repeatable runs.
+    void reseed(std::uint64_t seed) { explore = rng::Stream(seed); }
+
+    // A worker for parallel (Hogwild) training on this agent's table.
+    Worker worker(std::uint64_t seed);
+
+    // Frozen copy of the table, versioned by the episode count.
+    PolicySnapshot snapshot() const;
+};
+
+// A view for parallel (Hogwild) training: it shares its agent's table, so its
+// updates land in the same cells without any lock, but it explores with its
+// own RNG and epsilon. It keeps no episode stats; fold results back with
+// recordEpisodes / setEpsilon when the workers finish.
+//
+// The table is held by shared pointer, so a worker stays valid even if its
+// agent is reassigned under it -- its updates then go to the old table.
+class QLearningAI::Worker {
+private:
+    friend class QLearningAI;
+
+    std::shared_ptr<StateTable<QEntry>> qTable;
+    double alpha;
+    double gamma;
+    double epsilon;
+    rng::Stream explore;
+
+    Worker(std::shared_ptr<StateTable<QEntry>> table, double alpha, double gamma,
+           double epsilon, std::uint64_t seed);
+
+public:
+    Action chooseAction(const State& state);
+    Action getBestAction(const State& state) const;
+    void updateQValue(const State& state,
+                      Action action,
+                      double reward,
+                      const State& nextState,
+                      bool isTerminal);
+
+    void setEpsilon(double newEpsilon);
+    void decayEpsilon(double decayRate);
+    double getEpsilon() const { return epsilon; }
+    void reseed(std::uint64_t seed) { explore = rng::Stream(seed); }
 };
 
 #endif //BLACKJACK_AI_QLEARNINGAI_H
\ No newline at end of file
@@ -0,0 +1,116 @@
+//
+// Dense per-state storage for the agents' tables.
+//
+// The whole (playerSum, dealerUpcard, usableAce) space is 360 states, and
+// stateIndex already maps it onto 0..359, so a hash map buys nothing but probe
+// overhead on the hottest path in training. StateTable is a flat array indexed
+// by that encoding, plus a bitmask recording which states have ever been
+// written -- the same thing map membership used to mean, and what both agents'
+// "unlearned, fall back to the heuristic" check reads.
+//
+// Cells and mask words are relaxed atomics so that parallel (Hogwild) training
+// can update one table from many threads without a lock. Relaxed loads and
+// stores compile to plain moves on the platforms we target, so the serial path
+// pays nothing; the only read-modify-writes are visit-count increments and
+// first-time learned bits.
+//
+
+#ifndef BLACKJACK_AI_STATETABLE_H
+#define BLACKJACK_AI_STATETABLE_H
+
+#include "AITypes.h"
+#include <array>
+#include <atomic>
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+
+// A value several threads may read and write at once without synchronisation.
+// Copyable (by value), unlike std::atomic, so the records holding it stay
+// ordinary value types.
+template <typename T>
+class Relaxed {
+private:
+    std::atomic<T> v;
+
+public:
+    Relaxed(T x = T{}) : v(x) {}
+    Relaxed(const Relaxed& o) : v(o.load()) {}
+    Relaxed& operator=(const Relaxed& o) { store(o.load()); return *this; }
+    Relaxed& operator=(T x) { store(x); return *this; }
+
+    operator T() const { return load(); }
+    T load() const { return v.load(std::memory_order_relaxed); }
+    void store(T x) { v.store(x, std::memory_order_relaxed); }
+
+    // Integral T only.
+    T operator++() { return v.fetch_add(1, std::memory_order_relaxed) + 1; }
+    T fetchOr(T bits) { return v.fetch_or(bits, std::memory_order_relaxed); }
+};
+
+// One state's values for both actions, kept together so a decision or an
+// update touches a single record. Indexed by static_cast<int>(Action).
+struct QEntry {
+    std::array<Relaxed<double>, 2> q{};
+    std::array<Relaxed<int>, 2> visits{};
+};
+
+template <typename Entry>
+class StateTable {
+private:
+    static constexpr int WORDS = (STATE_COUNT + 63) / 64;
+
+    alignas(64) std::array<Entry, STATE_COUNT> entries{};
+    std::array<Relaxed<std::uint64_t>, WORDS> learned{};
+
+    bool isLearned(int i) const {
+        return (learned[i / 64].load() >> (i % 64)) & 1u;
+    }
+
+public:
+    // Entry for a state that has been written, or nullptr -- the equivalent of
+    // a failed map find(). Out-of-space states are simply never learned.
+    const Entry* find(const State& s) const {
+        if (!inStateSpace(s)) return nullptr;
+        int i = stateIndex(s);
+        return isLearned(i) ? &entries[i] : nullptr;
+    }
+
+    // Writable entry, marking the state learned (map operator[] semantics).
+    Entry& operator[](const State& s) {
+        if (!inStateSpace(s)) {
+            throw std::out_of_range("State outside the agent's state space");
+        }
+        int i = stateIndex(s);
+        if (!isLearned(i)) {
+            learned[i / 64].fetchOr(std::uint64_t{1} << (i % 64));
+        }
+        return entries[i];
+    }
+
+    bool contains(const State& s) const { return find(s) != nullptr; }
+
+    // Number of learned states.
+    std::size_t size() const {
+        std::size_t n = 0;
+        for (const auto& w : learned) n += std::bitset<64>(w.load()).count();
+        return n;
+    }
+    bool empty() const { return size() == 0; }
+
+    void clear() {
+        entries.fill(Entry{});
+        for (auto& w : learned) w = 0;
+    }
+
+    // Visits learned states in index order: f(const State&, const Entry&).
+    template <typename F>
+    void forEach(F f) const {
+        for (int i = 0; i < STATE_COUNT; ++i) {
+            if (isLearned(i)) f(stateAt(i), entries[i]);
+        }
+    }
+};
+
+#endif //BLACKJACK_AI_STATETABLE_H
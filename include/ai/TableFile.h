@@ -0,0 +1,79 @@
+//
+// Binary Q-table files.
+//
+// The CSV tables are readable and diffable, but loading one means tokenising
+// 720 rows through stringstream/stoi/stod, and saving overwrites the file in
+// place, so a reader racing a save can see half a table. The binary format is
+// the StateTable itself on disk: a fixed header, the learned-state bitmask and
+// one fixed-size record per state in stateIndex order. Loading maps the file,
+// checks the header and checksum, and copies the records across -- there is
+// nothing to parse. Saving writes a temporary file next to the target and
+// renames it over, so the target is always either the old table or the new one.
+//
+// Layout (native byte order; the header records it and a mismatch is refused):
+//
+//   FileHeader                 88 bytes
+//   uint64_t learned[6]        bit i set = state i has been learned
+//   StoredEntry entries[360]   q[HIT], q[STAND], visits[HIT], visits[STAND]
+//
+// Every layout parameter (state bounds, record size, mask words) is in the
+// header, so a table written against a different state space is rejected
+// rather than misread.
+//
+// CSV stays the interchange format: the agents pick the format from the file
+// name when saving (".csv" exports CSV) and from the first bytes when loading.
+//
+
+#ifndef BLACKJACK_AI_TABLEFILE_H
+#define BLACKJACK_AI_TABLEFILE_H
+
+#include "AITypes.h"
+#include "StateTable.h"
+#include <cstdint>
+#include <functional>
+#include <ostream>
+#include <string>
+
+namespace tablefile {
+
+constexpr std::uint32_t FORMAT_VERSION = 1;
+
+enum class AgentType : std::uint32_t { QLearning = 1, MonteCarlo = 2, Optimal = 3 };
+
+// Training state saved alongside the values.
+struct Meta {
+    AgentType agent = AgentType::QLearning;
+    std::uint64_t episodes = 0;
+    double epsilon = 0.0;
+    double totalReward = 0.0;
+};
+
+// True if `path` starts with the binary magic (and so is not a CSV).
+bool isBinary(const std::string& path);
+
+// Writes `path` atomically. False, with a message on stderr, on failure.
+bool save(const std::string& path, const Meta& meta, const StateTable<QEntry>& table);
+
+// Replaces `table` with the file's contents. On any mismatch -- magic,
+// version, byte order, layout, agent type, size or checksum -- returns false
+// with `error` set and leaves `table` and `meta` untouched.
+bool load(const std::string& path, AgentType expected, Meta& meta,
+          StateTable<QEntry>& table, std::string& error);
+
+// Temp-file-and-rename for any writer, so the CSV export gets the same
+// guarantee. `write` returns false to abandon the file. On POSIX the temp file
+// is fsynced before the rename and its directory after, so a crash or power
+// loss leaves the old table or the new one; on Windows the swap only protects
+// concurrent readers.
+bool writeAtomically(const std::string& path, const std::function<bool(std::ostream&)>& write);
+
+// True for paths the agents save as CSV.
+bool isCsvPath(const std::string& path);
+
+// `binaryPath` if it exists, else `csvPath`: how the front ends find the
+// table to load at startup.
+std::string preferBinary(const std::string& binaryPath, const std::string& csvPath);
+
+} // namespace tablefile
+
+#endif //BLACKJACK_AI_TABLEFILE_H
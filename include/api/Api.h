@@ -13,8 +13,11 @@
 #ifndef BLACKJACK_AI_API_H
 #define BLACKJACK_AI_API_H
 
+#include <cstddef>
+#include <cstdint>
 #include <map>
 #include <string>
+#include <string_view>
 
 namespace api {
 
@@ -26,23 +29,71 @@ struct Response {
     std::string contentType = "application/json";
     // When set, the server adds a Content-Disposition attachment header.
     std::string downloadName;
+    // When set, the body is one version of something that changes only when
+    // an agent republishes; the server sends it as an ETag so clients can
+    // revalidate instead of refetching. A 304 has this and no body.
+    std::string etag;
 };
 
 // Loads whatever Q-tables exist under data/. Safe to call once at startup.
 void init();
 
-// Routes one request. Unknown paths come back as 404.
-Response handle(const std::string& path, const Params& params);
+// How many interactive hands (/api/hand/new) may be open at once, and how long
+// one may sit idle before it expires. Defaults: 16,384 hands, ten minutes; a
+// zero leaves that limit as it is.
+void setHandLimits(std::size_t capacity, int idleSeconds);
 
-// Runs up to `budget` training episodes of the job started by POST /api/train,
-// emitting progress points as it goes. The native server calls this from a
-// worker thread; the WebAssembly build calls it from the browser's event loop,
-// a chunk at a time, because it has no threads to spare.
-void advanceTraining(long long budget);
+// Sets the master seed (see core/Random.h) and reseeds the hand table and the
+// agents' exploration from it. Call at startup, before serving: from then on
+// the seeds the server picks for itself -- a job or simulation without seed=,
+// the order new hands are dealt in -- follow from this one.
+void setSeed(std::uint64_t seed);
 
-// Episodes per progress point for the running job, or 0 when idle. The browser
-// uses it to size its chunks.
-long long trainingChunkSize();
+// Routes one request. Unknown paths come back as 404. `ifNoneMatch` is the
+// request's If-None-Match header, if any: a versioned response whose ETag it
+// names comes back as a bodiless 304.
+Response handle(const std::string& path, const Params& params,
+                const std::string& ifNoneMatch = std::string());
+
+// Runs queued and running training jobs (POST /api/train) a slice at a time
+// -- up to a job's next progress point -- until `budget` episodes have run or
+// nothing is left that this caller may run, and returns the episodes run.
+// Each agent trains one job at a time; across agents, slices go to the job
+// that has had the least run time for its priority. Safe to call from several
+// threads at once: the native server runs maxConcurrentJobs() workers on it,
+// and the WebAssembly build calls it from the browser's event loop, a budget
+// at a time, because it has no threads to spare.
+long long advanceTraining(long long budget);
+
+// How many jobs can train at once: one per trainable agent.
+unsigned maxConcurrentJobs();
+
+// Training as a stream of server-sent events (start, progress, finish,
+// cancel), for transports that can hold a response open. Events are numbered;
+// a reader keeps its own cursor and never blocks the trainer.
+//
+// Where a new stream starts: just after `lastEventId` (the Last-Event-ID of a
+// reconnecting EventSource) if given, else at the first event of the oldest
+// job still queued or running (or of the newest job, if none is), so a page
+// that connects mid-run still gets the whole series.
+std::uint64_t trainingEventsFrom(const std::string& lastEventId);
+
+// Appends every event from `cursor` on to `out` as SSE text and advances the
+// cursor. False if there was nothing new.
+bool readTrainingEvents(std::uint64_t& cursor, std::string& out);
+
+// The binary decision protocol, for co-located clients that cannot afford
+// HTTP and JSON per lookup (the native server speaks it on a Unix socket; see
+// the README). Takes one request payload -- version, agent, then N packed
+// state indices -- and appends one response payload to `out`: per state, the
+// action, learned flag and f32 Q-values from a single published copy of the
+// agent's table. Framing is the transport's business. Never throws; a bad
+// request gets a response with a nonzero status.
+void decidePacked(std::string_view request, std::string& out);
+
+// Largest request payload decidePacked accepts, so a transport can bound its
+// reads.
+std::size_t maxDecideRequestBytes();
 
 } // namespace api
 
@@ -0,0 +1,93 @@
+//
+// Actor/learner training.
+//
+// The alternative to Hogwild (Game::runParallelAIEpisodes): instead of every
+// thread writing the shared table, actor threads only *play*. Each deals from
+// its own shoe against a read-only PolicySnapshot, explores with its own RNG,
+// and pushes a compact record of the episode into a lock-free MPSC ring. One
+// learner -- the calling thread -- drains the ring in batches and applies the
+// records through the agent's ordinary update path (QLearningAI::updateQValue,
+// or MonteCarloAI's startEpisode / recordStep / endEpisode), then publishes a
+// fresh snapshot every `refreshEpisodes` learned episodes.
+//
+// Because there is exactly one writer, the learning-rate schedule and Monte
+// Carlo's first-visit bookkeeping are exactly what serial training does; the
+// only difference is that actors may be playing a slightly stale policy. That
+// staleness (actor lag) and the ring's backlog (queue depth) are reported so
+// the trade-off is visible.
+//
+// A pipeline is built once and run many times: a training job keeps one from
+// its first slice to its last, and between runs the actors sit parked with
+// their shoes and RNGs intact rather than being torn down and rebuilt. That
+// keeps thread start-up out of every slice, and keeps the queue and lag
+// figures measuring the steady state rather than warm-up.
+//
+
+#ifndef BLACKJACK_AI_ACTORLEARNER_H
+#define BLACKJACK_AI_ACTORLEARNER_H
+
+#include "Game.h"
+#include "Metrics.h"
+#include "Shoe.h"
+#include "../ai/QLearningAI.h"
+#include "../ai/MonteCarloAI.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+struct PipelineStats {
+    EpisodeTally tally;
+    double meanQueueDepth = 0.0;   // records waiting, sampled before each learner batch
+    std::size_t maxQueueDepth = 0;
+    double meanActorLag = 0.0;     // episodes learned since the snapshot an actor played
+    long long snapshots = 0;       // snapshots published during the run
+};
+
+class ActorLearner {
+public:
+    struct Config {
+        unsigned actors = 1;
+        int decks = Shoe::DEFAULT_DECKS;
+        std::size_t queueCapacity = 4096;
+        long long refreshEpisodes = 256;
+        // Actor a deals and explores from rng::derive(seed, a). How many
+        // episodes each actor plays, and the order the learner applies them
+        // in, are up to the threads, so the resulting table is not bit-for-bit
+        // repeatable the way a serial run's is.
+        std::uint64_t seed = 0;
+        // If set, held exclusively around each batch of updates, so readers of
+        // the agent see whole batches and never wait longer than one.
+        metrics::TimedSharedMutex* agentLock = nullptr;
+        // If set and it becomes true, actors stop taking new episodes and the
+        // current run ends once the learner has applied the ones already played.
+        const std::atomic<bool>* stop = nullptr;
+    };
+
+    // False where there are no threads to run actors on (the WebAssembly build).
+    static bool supported();
+
+    // Starts the actors, parked until the first run(). `ai` must outlive the
+    // pipeline, and nothing else may write it while a run is in progress.
+    ActorLearner(QLearningAI& ai, double epsilonDecay, const Config& cfg);
+    ActorLearner(MonteCarloAI& ai, double epsilonDecay, const Config& cfg);
+    ~ActorLearner();   // stops and joins the actors
+
+    ActorLearner(const ActorLearner&) = delete;
+    ActorLearner& operator=(const ActorLearner&) = delete;
+
+    // Runs `episodes` more episodes (fewer if stopped; tally.episodes says how
+    // many) and returns once all have been learned and the actors are parked
+    // again. The agent's epsilon follows the same per-episode decay as serial
+    // training, keyed to each episode's index, and is left where serial
+    // training would leave it. Stats cover this run only.
+    PipelineStats run(long long episodes);
+
+private:
+    struct Impl;
+    template <typename AI> class Pipeline;
+
+    std::unique_ptr<Impl> impl;
+};
+
+#endif //BLACKJACK_AI_ACTORLEARNER_H
@@ -0,0 +1,65 @@
+//
+// Append-only log with one writer and any number of lock-free readers.
+//
+// Items live in fixed-size segments that are allocated as the log grows and
+// never move or change once written, so a reader can hold a reference for as
+// long as the log lives. The writer stores an item, then publishes the new size
+// with a release store; a reader that loads the size (acquire) may read every
+// item below it without any further synchronization. Readers never block the
+// writer and never see a half-written item.
+//
+// The writer may change threads between appends, provided the hand-over itself
+// synchronizes (a mutex, a thread join).
+//
+
+#ifndef BLACKJACK_AI_APPENDLOG_H
+#define BLACKJACK_AI_APPENDLOG_H
+
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+
+template <typename T, std::size_t SegmentSize = 64, std::size_t MaxSegments = 64>
+class AppendLog {
+private:
+    std::array<std::atomic<T*>, MaxSegments> segments{};
+    std::atomic<std::size_t> count{0};
+
+public:
+    AppendLog() = default;
+    ~AppendLog() {
+        for (auto& s : segments) delete[] s.load(std::memory_order_relaxed);
+    }
+
+    AppendLog(const AppendLog&) = delete;
+    AppendLog& operator=(const AppendLog&) = delete;
+
+    static constexpr std::size_t capacity() { return SegmentSize * MaxSegments; }
+
+    // Writer only. False, storing nothing, once the log is full.
+    bool push(const T& v) {
+        std::size_t n = count.load(std::memory_order_relaxed);
+        if (n >= capacity()) return false;
+        std::atomic<T*>& seg = segments[n / SegmentSize];
+        T* items = seg.load(std::memory_order_relaxed);
+        if (items == nullptr) {
+            items = new T[SegmentSize];
+            seg.store(items, std::memory_order_relaxed);   // published by count below
+        }
+        items[n % SegmentSize] = v;
+        count.store(n + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Any thread. Items [0, size()) are complete and safe to read.
+    std::size_t size() const { return count.load(std::memory_order_acquire); }
+
+    // Any thread, for i below a size() it has loaded.
+    const T& operator[](std::size_t i) const {
+        assert(i < capacity());
+        return segments[i / SegmentSize].load(std::memory_order_relaxed)[i % SegmentSize];
+    }
+};
+
+#endif //BLACKJACK_AI_APPENDLOG_H
@@ -0,0 +1,114 @@
+//
+// Bounded lock-free single-producer, multi-reader broadcast ring.
+//
+// Where MpscRing hands each item to exactly one consumer, this one lets any
+// number of readers see every item, each at its own pace, without the writer
+// ever waiting for them. Items are numbered from 0; item n lives in slot
+// n % capacity until item n + capacity overwrites it. Each slot is a seqlock:
+// the writer marks it odd while it copies the item in and even (2n + 2) once
+// item n is complete, and a reader copies the item out and then checks that the
+// mark did not move underneath it. A reader that falls a whole ring behind is
+// told so (Lost) rather than handed a torn or newer item, and decides for
+// itself how to catch up.
+//
+// T must be trivially copyable: it is stored as relaxed atomic words, so
+// readers racing the writer are well-defined, merely discarded.
+//
+
+#ifndef BLACKJACK_AI_BROADCASTRING_H
+#define BLACKJACK_AI_BROADCASTRING_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <type_traits>
+
+template <typename T>
+class BroadcastRing {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "BroadcastRing items are copied as raw words");
+
+private:
+    static constexpr std::size_t WORDS = (sizeof(T) + 7) / 8;
+
+    struct Slot {
+        std::atomic<std::uint64_t> seq{0};
+        std::atomic<std::uint64_t> words[WORDS];
+    };
+
+    std::unique_ptr<Slot[]> slots;
+    std::size_t mask;
+
+    // Number of items written so far; written by the producer only.
+    alignas(64) std::atomic<std::uint64_t> next{0};
+
+    static std::size_t roundUp(std::size_t n) {
+        std::size_t p = 2;
+        while (p < n) p <<= 1;
+        return p;
+    }
+
+public:
+    enum class Read { Ok, Empty, Lost };
+
+    // Capacity is rounded up to a power of two.
+    explicit BroadcastRing(std::size_t capacity)
+        : slots(new Slot[roundUp(capacity)]), mask(roundUp(capacity) - 1) {}
+
+    BroadcastRing(const BroadcastRing&) = delete;
+    BroadcastRing& operator=(const BroadcastRing&) = delete;
+
+    std::size_t capacity() const { return mask + 1; }
+
+    // Producer only. Never blocks; the oldest item is overwritten. Returns the
+    // item's number.
+    std::uint64_t push(const T& v) {
+        std::uint64_t n = next.load(std::memory_order_relaxed);
+        Slot& slot = slots[n & mask];
+
+        std::uint64_t words[WORDS] = {};
+        std::memcpy(words, &v, sizeof(T));
+
+        slot.seq.store(2 * n + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        for (std::size_t i = 0; i < WORDS; ++i) {
+            slot.words[i].store(words[i], std::memory_order_relaxed);
+        }
+        slot.seq.store(2 * n + 2, std::memory_order_release);
+        next.store(n + 1, std::memory_order_release);
+        return n;
+    }
+
+    // Any thread. The number the next item will get.
+    std::uint64_t end() const { return next.load(std::memory_order_acquire); }
+
+    // Any thread. The oldest item still expected to be readable -- a hint, since
+    // the producer may overwrite it at any moment.
+    std::uint64_t oldest() const {
+        std::uint64_t n = end();
+        return n > capacity() ? n - capacity() : 0;
+    }
+
+    // Any thread. Copies item n into `out`: Empty if it has not been written
+    // yet, Lost if it has already been overwritten.
+    Read read(std::uint64_t n, T& out) const {
+        if (n >= end()) return Read::Empty;
+        const Slot& slot = slots[n & mask];
+        std::uint64_t before = slot.seq.load(std::memory_order_acquire);
+        if (before != 2 * n + 2) return Read::Lost;
+
+        std::uint64_t words[WORDS];
+        for (std::size_t i = 0; i < WORDS; ++i) {
+            words[i] = slot.words[i].load(std::memory_order_relaxed);
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.seq.load(std::memory_order_relaxed) != before) return Read::Lost;
+
+        std::memcpy(&out, words, sizeof(T));
+        return Read::Ok;
+    }
+};
+
+#endif //BLACKJACK_AI_BROADCASTRING_H
@@ -6,14 +6,14 @@
 #define BLACKJACK_AI_DEALER_H
 
 #include "Player.h"
-#include "Deck.h"
+#include "Shoe.h"
 #include <iostream>
 
 class Dealer: public Player {
 public:
     Dealer() : Player("Dealer", true) {};
 
-    void playTurn(Deck& deck);
+    void playTurn(Shoe& shoe);
     void showHand(bool hideFirstCard = true) const;
     void revealHand() const;
 
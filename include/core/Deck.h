@@ -5,9 +5,10 @@
 #ifndef BLACKJACK_AI_DECK_H
 #define BLACKJACK_AI_DECK_H
 #include "Card.h"
+#include "Random.h"
+#include <cstdint>
 #include <vector>
 #include <algorithm>
-#include <random>
 
 using namespace std;
 
@@ -16,11 +17,14 @@ class Deck {
 private:
     std::vector<Card> cards;
     int currentCardIndex;
+    rng::Stream stream;
 public:
     Deck();
 
     void generateDeck();
     void shuffleDeck();
+    // Shuffle from `seed` from here on (a new Deck takes the next Domain::Deck seed).
+    void reseed(std::uint64_t seed) { stream = rng::Stream(seed); }
     Card dealCard();
 
     bool isEmpty() const;
@@ -5,17 +5,40 @@
 #ifndef BLACKJACK_AI_GAME_H
 #define BLACKJACK_AI_GAME_H
 
-#include "Deck.h"
+#include "Shoe.h"
 #include "Player.h"
 #include "Dealer.h"
 #include "../ai/QLearningAI.h"
 #include "../ai/MonteCarloAI.h"
+#include <atomic>
+#include <cstdint>
 #include <vector>
 #include <string>
 
+// Outcome counts and total reward over a run of episodes.
+struct EpisodeTally {
+    long long episodes = 0;
+    long long wins = 0, losses = 0, pushes = 0;
+    double reward = 0.0;
+
+    void add(double r) {
+        ++episodes;
+        reward += r;
+        if (r > 0)      ++wins;
+        else if (r < 0) ++losses;
+        else            ++pushes;
+    }
+
+    void merge(const EpisodeTally& o) {
+        episodes += o.episodes;
+        wins += o.wins; losses += o.losses; pushes += o.pushes;
+        reward += o.reward;
+    }
+};
+
 class Game {
 private:
-    Deck deck;
+    Shoe shoe;
     Dealer dealer;
     std::vector<Player> players;
     int numPlayers;
@@ -26,8 +49,14 @@ private:
     // Helper: Calculate reward for AI
     double calculateReward(const Player& player) const;
 
+    // One Q-learning hand, for a QLearningAI or a QLearningAI::Worker.
+    template <typename Agent>
+    double playQEpisode(Agent& ai, bool training);
+
 public:
-    explicit Game(int numPlayers = 1);
+    explicit Game(int numPlayers = 1,
+                  int numDecks = Shoe::DEFAULT_DECKS,
+                  double penetration = Shoe::DEFAULT_PENETRATION);
 
     void initializeGame();
     void dealInitialCards();
@@ -37,17 +66,47 @@ public:
     void resetGame();
     void displayGameState(bool hideDealerCard = true) const;
 
+    Shoe& getShoe() { return shoe; }
+    const Shoe& getShoe() const { return shoe; }
+
     // Human gameplay
     void playRound();
 
     // AI Training
     void trainAI(QLearningAI& ai, int numEpisodes, bool verbose = false);
+    void trainAIParallel(QLearningAI& ai, int numEpisodes, unsigned threads, bool verbose = false);
     double playAIEpisode(QLearningAI& ai, bool training = true);
+    double playAIEpisode(QLearningAI::Worker& ai, bool training = true);
     void evaluateAI(QLearningAI& ai, int numGames);
 
     void trainMonteCarlo(MonteCarloAI& ai, int numEpisodes, bool verbose = false);
     double playMonteCarloEpisode(MonteCarloAI& ai, bool training = true);
     void evaluateMonteCarlo(MonteCarloAI& ai, int numGames);
+
+    // Hogwild-style parallel Q-learning. `threads` workers (0 = every core)
+    // each play on their own Game and shoe through a QLearningAI::Worker,
+    // so all updates land in ai's table without a lock. Episodes are claimed
+    // in small batches from one shared counter, and each batch's epsilon is
+    // taken from the global episode index, so the decay schedule matches
+    // trainAI's one-episode-at-a-time decay.
+    //
+    // Each batch also reseeds the worker's shoe and exploration from
+    // (seed, batch index), so the same seed deals the same hands and explores
+    // the same way at any thread count. The table is still not bit-for-bit
+    // repeatable with more than one worker: which update lands first is up to
+    // the threads.
+    //
+    // ai's own counters are left alone so the caller can fold the result back
+    // under whatever lock it uses: ai.recordEpisodes(tally) and
+    // ai.setEpsilon(ai.epsilonAfter(tally.episodes, epsilonDecay)).
+    //
+    // If `stop` is given and becomes true, each worker finishes the episode it
+    // is playing and returns; tally.episodes says how many were played.
+    static EpisodeTally runParallelAIEpisodes(QLearningAI& ai, long long numEpisodes,
+                                              unsigned threads, double epsilonDecay,
+                                              std::uint64_t seed,
+                                              int numDecks = Shoe::DEFAULT_DECKS,
+                                              const std::atomic<bool>* stop = nullptr);
 };
 
 #endif //BLACKJACK_AI_GAME_H
\ No newline at end of file
@@ -11,11 +11,17 @@
 // encoding and payout via rules::. It never touches stdin, unlike Game's
 // constructor.
 //
+// Cards come from a caller-owned Shoe so that consecutive hands deal through
+// the same shoe, as at a real table. The shoe must outlive the session.
+//
+// A session can be dealt again once its hand is over, reusing its card
+// storage, so a server can pool sessions instead of allocating one per hand.
+//
 
 #ifndef BLACKJACK_AI_HANDSESSION_H
 #define BLACKJACK_AI_HANDSESSION_H
 
-#include "Deck.h"
+#include "Shoe.h"
 #include "Dealer.h"
 #include "Player.h"
 #include "Rules.h"
@@ -24,7 +30,7 @@
 
 class HandSession {
 private:
-    Deck deck;
+    Shoe* shoe = nullptr;
     Dealer dealer;
     Player player;
     bool settled;
@@ -33,8 +39,14 @@ private:
     void settle();
 
 public:
+    explicit HandSession(Shoe& shoe);
+
+    // An empty, already-settled session, for a pool to deal() into later.
     HandSession();
 
+    // Start a new hand from `shoe`, discarding whatever this session held.
+    void deal(Shoe& shoe);
+
     // The tuple the agent actually sees.
     State state() const;
 
@@ -0,0 +1,188 @@
+//
+// Process-wide metrics: counters, gauges and fixed-bucket histograms, exposed
+// in the Prometheus text format.
+//
+// Recording never takes a lock. Counters and histograms are split into
+// cache-line-sized shards and each thread writes only the shard it was
+// assigned on first use, with relaxed atomics, so threads recording the same
+// metric do not bounce one cache line between them. Reading sums the shards;
+// a scrape taken while threads record is not an instant snapshot, but every
+// value in it is one that was recorded.
+//
+// Metrics are registered once, by name and labels, and live as long as the
+// process: callers look one up (under the registry's lock) where they are set
+// up and keep the reference, so the recording path never sees the registry.
+//
+
+#ifndef BLACKJACK_AI_METRICS_H
+#define BLACKJACK_AI_METRICS_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace metrics {
+
+using Labels = std::vector<std::pair<std::string, std::string>>;
+
+constexpr std::size_t SHARDS = 16;
+
+// This thread's shard, assigned round-robin on its first recording.
+std::size_t shardIndex();
+
+class Counter {
+private:
+    struct alignas(64) Cell {
+        std::atomic<std::uint64_t> value{0};
+    };
+    std::array<Cell, SHARDS> cells;
+
+public:
+    void add(std::uint64_t n = 1) {
+        cells[shardIndex()].value.fetch_add(n, std::memory_order_relaxed);
+    }
+    std::uint64_t value() const;
+};
+
+// A value set outright, by whoever knows it (not sharded: last write wins).
+class Gauge {
+private:
+    std::atomic<double> current{0.0};
+
+public:
+    void set(double v) { current.store(v, std::memory_order_relaxed); }
+    double value() const { return current.load(std::memory_order_relaxed); }
+};
+
+class Histogram {
+public:
+    static constexpr std::size_t MAX_BOUNDS = 24;
+
+    // Upper bounds, ascending; an implicit +Inf bucket follows the last.
+    explicit Histogram(const std::vector<double>& bounds);
+
+    void observe(double v) {
+        std::size_t b = 0;
+        while (b < bounds.size() && v > bounds[b]) ++b;
+        Shard& s = shards[shardIndex()];
+        s.counts[b].fetch_add(1, std::memory_order_relaxed);
+        if (v != 0.0) {
+            // Only this shard's threads add here, so the loop almost never retries.
+            double sum = s.sum.load(std::memory_order_relaxed);
+            while (!s.sum.compare_exchange_weak(sum, sum + v, std::memory_order_relaxed)) {}
+        }
+    }
+
+    struct Totals {
+        std::vector<std::uint64_t> cumulative;   // per bound, then +Inf (= count)
+        double sum = 0.0;
+    };
+    Totals totals() const;
+    const std::vector<double>& upperBounds() const { return bounds; }
+
+private:
+    struct alignas(64) Shard {
+        std::array<std::atomic<std::uint64_t>, MAX_BOUNDS + 1> counts{};
+        std::atomic<double> sum{0.0};
+    };
+    std::vector<double> bounds;
+    std::array<Shard, SHARDS> shards;
+};
+
+// Bucket bounds for request latencies, 10 us to 10 s, and for lock waits and
+// holds, 1 us to 1 s; in seconds, as Prometheus expects.
+const std::vector<double>& latencyBuckets();
+const std::vector<double>& lockBuckets();
+
+class Registry {
+public:
+    // The process's registry; /api/metrics renders this one.
+    static Registry& global();
+
+    // The metric with this name and labels, created on first request. Asking
+    // again returns the same one; asking for a name already registered as
+    // another type throws std::logic_error.
+    Counter& counter(const std::string& name, const std::string& help, const Labels& labels = {});
+    Gauge& gauge(const std::string& name, const std::string& help, const Labels& labels = {});
+    Histogram& histogram(const std::string& name, const std::string& help,
+                         const std::vector<double>& bounds, const Labels& labels = {});
+
+    // Every metric in the Prometheus text exposition format (version 0.0.4),
+    // families in name order.
+    std::string render() const;
+
+private:
+    enum class Type { Counter, Gauge, Histogram };
+    struct Series {
+        std::string labels;   // rendered: {k="v",...}, or empty
+        std::unique_ptr<Counter> counter;
+        std::unique_ptr<Gauge> gauge;
+        std::unique_ptr<Histogram> histogram;
+    };
+    struct Family {
+        Type type;
+        std::string help;
+        std::vector<Series> series;
+    };
+
+    mutable std::mutex mu;
+    std::map<std::string, Family> families;
+
+    Series& series(const std::string& name, const std::string& help, Type type,
+                   const Labels& labels);
+};
+
+// Seconds since `start`, for observing durations.
+inline double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// A shared_mutex that reports how long its lockers wait and hold it. Usable
+// with std::unique_lock and std::shared_lock like the mutex it wraps. Until
+// instrument() is called it records nothing.
+//
+// An uncontended acquisition costs one try_lock more than the bare mutex and
+// records a zero wait without reading the clock. Exclusive holds are timed one
+// acquisition in HOLD_SAMPLE, since a trainer may take the lock once per
+// episode; shared holds, which only saves and progress reads take, every time.
+class TimedSharedMutex {
+public:
+    static constexpr unsigned HOLD_SAMPLE = 16;
+
+    void instrument(Registry& registry, const std::string& waitName,
+                    const std::string& holdName, const Labels& labels);
+
+    void lock();
+    bool try_lock();
+    void unlock();
+    void lock_shared();
+    bool try_lock_shared();
+    void unlock_shared();
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    std::shared_mutex mu;
+    Histogram* waitExclusive = nullptr;
+    Histogram* waitShared = nullptr;
+    Histogram* holdExclusive = nullptr;
+    Histogram* holdShared = nullptr;
+
+    // Guarded by the exclusive lock itself.
+    unsigned acquisitions = 0;
+    Clock::time_point heldSince;
+    bool timingHold = false;
+};
+
+} // namespace metrics
+
+#endif //BLACKJACK_AI_METRICS_H
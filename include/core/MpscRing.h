@@ -0,0 +1,98 @@
+//
+// Bounded lock-free multi-producer, single-consumer ring buffer.
+//
+// Each slot carries a sequence number (Vyukov's bounded queue): a producer
+// claims a position with one compare-and-swap on the tail and publishes the
+// slot by bumping its sequence; the single consumer reads slots in order and
+// hands them back the same way. Nobody ever blocks -- a full ring makes
+// tryPush fail and an empty one makes tryPop fail, and the caller decides
+// whether to yield, drop or retry.
+//
+
+#ifndef BLACKJACK_AI_MPSCRING_H
+#define BLACKJACK_AI_MPSCRING_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+template <typename T>
+class MpscRing {
+private:
+    struct Slot {
+        std::atomic<std::size_t> seq;
+        T value;
+    };
+
+    std::unique_ptr<Slot[]> slots;
+    std::size_t mask;
+
+    // Producers and the consumer sit on separate cache lines.
+    alignas(64) std::atomic<std::size_t> tail{0};
+    alignas(64) std::atomic<std::size_t> head{0};   // written by the consumer only
+
+    static std::size_t roundUp(std::size_t n) {
+        std::size_t p = 2;
+        while (p < n) p <<= 1;
+        return p;
+    }
+
+public:
+    // Capacity is rounded up to a power of two.
+    explicit MpscRing(std::size_t capacity)
+        : slots(new Slot[roundUp(capacity)]), mask(roundUp(capacity) - 1) {
+        for (std::size_t i = 0; i <= mask; ++i) {
+            slots[i].seq.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    MpscRing(const MpscRing&) = delete;
+    MpscRing& operator=(const MpscRing&) = delete;
+
+    // Any thread. False when the ring is full.
+    bool tryPush(const T& v) {
+        std::size_t pos = tail.load(std::memory_order_relaxed);
+        for (;;) {
+            Slot& slot = slots[pos & mask];
+            std::size_t seq = slot.seq.load(std::memory_order_acquire);
+            auto dif = static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos);
+            if (dif == 0) {
+                if (tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    slot.value = v;
+                    slot.seq.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (dif < 0) {
+                return false;
+            } else {
+                pos = tail.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Consumer thread only. False when the ring is empty.
+    bool tryPop(T& out) {
+        std::size_t pos = head.load(std::memory_order_relaxed);
+        Slot& slot = slots[pos & mask];
+        std::size_t seq = slot.seq.load(std::memory_order_acquire);
+        if (static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos + 1) < 0) {
+            return false;
+        }
+        out = slot.value;
+        slot.seq.store(pos + mask + 1, std::memory_order_release);
+        head.store(pos + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    // Records claimed but not yet consumed. Approximate while producers run.
+    std::size_t depth() const {
+        std::size_t t = tail.load(std::memory_order_relaxed);
+        std::size_t h = head.load(std::memory_order_relaxed);
+        return t > h ? t - h : 0;
+    }
+
+    std::size_t capacity() const { return mask + 1; }
+};
+
+#endif //BLACKJACK_AI_MPSCRING_H
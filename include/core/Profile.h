@@ -0,0 +1,163 @@
+//
+// Phase timers for the episode hot path, and Chrome trace export.
+//
+// PROFILE_SCOPE(Phase) times the rest of the enclosing block as one phase of
+// an episode -- dealing, state encoding, the agent's decision, the player's
+// draws, the dealer's playout, settling, the learning update -- and adds it
+// to the Recorder attached to the calling thread. Whoever runs a training job
+// attaches a Recorder for it; threads with none attached (request handlers,
+// evaluation) record nothing.
+//
+// The timers cost two clock reads each, a real fraction of a microsecond-long
+// episode, so they are compiled in only when BLACKJACK_PROFILE is defined
+// (cmake -DBLACKJACK_PROFILE=ON, or make -f build.mk PROFILE=1). Otherwise
+// PROFILE_SCOPE expands to nothing and every Recorder stays empty; the types
+// remain so that callers compile the same either way.
+//
+// A Recorder can also keep a trace of one episode in every `traceEvery`: each
+// phase as a complete event ("ph":"X") in the Chrome trace-event format, which
+// chrome://tracing and Perfetto open directly.
+//
+// A Recorder belongs to one thread at a time. Code that fans an episode loop
+// out to worker threads gives each worker a fork() of the caller's Recorder
+// and merges them back, in worker order, once the workers are done.
+//
+
+#ifndef BLACKJACK_AI_PROFILE_H
+#define BLACKJACK_AI_PROFILE_H
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace profile {
+
+#ifdef BLACKJACK_PROFILE
+constexpr bool ENABLED = true;
+#else
+constexpr bool ENABLED = false;
+#endif
+
+enum class Phase : std::uint8_t {
+    Episode,    // one whole episode; the phases below nest inside it
+    Deal,       // clearing the table and the initial four cards
+    Encode,     // hand -> State
+    Decide,     // the agent choosing an action
+    Draw,       // the player's hits
+    Dealer,     // the dealer's playout
+    Settle,     // payout
+    Update,     // the Q-learning / Monte Carlo update
+    Schedule,   // advanceTraining picking and releasing a job
+    Publish,    // copying the table for readers
+};
+constexpr std::size_t PHASE_COUNT = 10;
+
+const char* name(Phase p);
+
+using Clock = std::chrono::steady_clock;
+
+struct PhaseTotal {
+    long long count = 0;
+    long long nanos = 0;
+};
+
+struct TraceEvent {
+    Phase phase;
+    std::uint32_t tid;
+    long long startNs;   // since the process's trace epoch
+    long long durNs;
+};
+
+class Recorder {
+public:
+    static constexpr std::size_t MAX_TRACE_EVENTS = 200000;
+
+    // traceEvery = 0 keeps totals only.
+    explicit Recorder(long long traceEvery = 0, std::uint32_t tid = 0);
+
+    // A recorder for a worker of this one's run: same tracing, its own tid.
+    Recorder fork(std::uint32_t tid) const { return Recorder(traceEvery, tid); }
+    void merge(const Recorder& other);
+
+    // An Episode scope calls this as it opens, so the phases inside it know
+    // whether their episode is one being traced.
+    void openEpisode() {
+        inEpisode = true;
+        sampling = traceEvery > 0 && episodes % traceEvery == 0;
+    }
+    void record(Phase p, Clock::time_point start, Clock::time_point end);
+
+    const std::array<PhaseTotal, PHASE_COUNT>& totals() const { return phases; }
+    const PhaseTotal& total(Phase p) const { return phases[static_cast<std::size_t>(p)]; }
+    bool tracing() const { return traceEvery > 0; }
+    std::size_t traceEvents() const { return events.size(); }
+
+    // The phase table, one line per phase that ran: count, total time, mean,
+    // and share of episode time.
+    std::string table() const;
+
+    // The sampled episodes as Chrome trace-event JSON.
+    std::string chromeTrace() const;
+
+private:
+    std::array<PhaseTotal, PHASE_COUNT> phases{};
+    std::vector<TraceEvent> events;
+    long long traceEvery;
+    std::uint32_t tid;
+    long long episodes = 0;
+    long long loose = 0;     // phases timed outside any episode
+    bool inEpisode = false;
+    bool sampling = false;   // the open episode is being traced
+};
+
+// The Recorder attached to this thread, or null.
+Recorder* current();
+
+// Attaches a Recorder to this thread for the lifetime of the object (null
+// detaches), restoring whatever was attached before.
+class Attach {
+public:
+    explicit Attach(Recorder* r);
+    ~Attach();
+    Attach(const Attach&) = delete;
+    Attach& operator=(const Attach&) = delete;
+
+private:
+    Recorder* previous;
+};
+
+class Scope {
+public:
+    explicit Scope(Phase p) : recorder(current()), phase(p) {
+        if (!recorder) return;
+        if (p == Phase::Episode) recorder->openEpisode();
+        start = Clock::now();
+    }
+    ~Scope() {
+        if (recorder) recorder->record(phase, start, Clock::now());
+    }
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+private:
+    Recorder* recorder;
+    Phase phase;
+    Clock::time_point start;
+};
+
+} // namespace profile
+
+#define PROFILE_CONCAT_(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_(a, b)
+
+#ifdef BLACKJACK_PROFILE
+#define PROFILE_SCOPE(phase) \
+    ::profile::Scope PROFILE_CONCAT(profileScope_, __LINE__)(::profile::Phase::phase)
+#else
+#define PROFILE_SCOPE(phase) static_cast<void>(0)
+#endif
+
+#endif //BLACKJACK_AI_PROFILE_H
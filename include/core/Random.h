@@ -0,0 +1,107 @@
+//
+// Seeded random streams: one master seed per process, and independent streams
+// derived from it for every shoe, agent, training job and simulation task.
+//
+// Nothing draws entropy of its own. A stream is counter-based (splitmix64):
+// its nth output is a fixed function of (key, n), so a stream is just a key
+// and a position, copying one is free, and streams under different keys are
+// independent. Keys form a tree -- (master, Domain::Job, job id), then (job
+// seed, slice), then (slice seed, block) -- so what a stream produces depends
+// only on where it sits in that tree, never on which thread got there first.
+// That is what lets work split into fixed tasks replay bit for bit at any
+// thread count.
+//
+// Shuffles and bounded draws are done here rather than with std::shuffle and
+// std::uniform_int_distribution, whose algorithms differ between standard
+// libraries; the native build and the WebAssembly one (libc++) deal the same
+// shoe from the same seed.
+//
+// The master seed is drawn from std::random_device on first use unless set
+// before (the CLI's --seed, the server's SEED). Everything that takes a seed=
+// parameter reports the one it used, so any run can be replayed.
+//
+
+#ifndef BLACKJACK_AI_RANDOM_H
+#define BLACKJACK_AI_RANDOM_H
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <utility>
+
+namespace rng {
+
+// splitmix64's finalizer: a bijection that scatters nearby inputs.
+inline std::uint64_t mix(std::uint64_t z) {
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+// The key of child stream `id` under `seed`. Differs from the parent stream's
+// own outputs, so a key may be both drawn from and derived from.
+inline std::uint64_t derive(std::uint64_t seed, std::uint64_t id) {
+    return mix(mix(seed ^ 0xD1B54A32D192ED03ULL) + 0x9E3779B97F4A7C15ULL * (id + 1));
+}
+
+// A UniformRandomBitGenerator, so <random> distributions accept it too.
+class Stream {
+public:
+    using result_type = std::uint64_t;
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return ~result_type{0}; }
+
+    explicit Stream(std::uint64_t key = 0) : key_(key) {}
+
+    result_type operator()() { return mix(key_ + 0x9E3779B97F4A7C15ULL * ++position_); }
+
+    // Uniform in [0, 1), from the top 53 bits.
+    double uniform() { return static_cast<double>((*this)() >> 11) * 0x1.0p-53; }
+
+    // Uniform in [0, n), unbiased (Lemire's multiply-and-reject). n > 0.
+    std::uint32_t below(std::uint32_t n) {
+        std::uint64_t m = ((*this)() >> 32) * n;
+        if (static_cast<std::uint32_t>(m) < n) {
+            std::uint32_t threshold = (0u - n) % n;
+            while (static_cast<std::uint32_t>(m) < threshold) m = ((*this)() >> 32) * n;
+        }
+        return static_cast<std::uint32_t>(m >> 32);
+    }
+
+    // Fisher-Yates over [first, last), fewer than 2^32 elements.
+    template <typename RandomIt>
+    void shuffle(RandomIt first, RandomIt last) {
+        for (auto i = std::distance(first, last); i > 1; --i) {
+            using std::swap;
+            swap(first[i - 1], first[below(static_cast<std::uint32_t>(i))]);
+        }
+    }
+
+    std::uint64_t key() const { return key_; }
+    std::uint64_t position() const { return position_; }
+
+private:
+    std::uint64_t key_;
+    std::uint64_t position_ = 0;
+};
+
+// What a seed is for, so that one master seed gives each kind of consumer
+// its own subtree.
+enum class Domain : std::uint64_t { Shoe = 1, Explore, Job, Simulate, Hand, Deck };
+
+// Replaces the master seed and restarts every domain's nextSeed() count.
+// Objects already built keep the streams they had.
+void setMasterSeed(std::uint64_t seed);
+std::uint64_t masterSeed();
+
+// derive(derive(master, domain), id).
+std::uint64_t seedFor(Domain d, std::uint64_t id);
+
+// seedFor(d, n) for the nth caller in domain d since the master seed was set:
+// for things built without an identity of their own (a default Shoe, a fresh
+// agent, an unseeded simulation). Reproducible wherever that order is.
+std::uint64_t nextSeed(Domain d);
+
+} // namespace rng
+
+#endif //BLACKJACK_AI_RANDOM_H
@@ -0,0 +1,70 @@
+//
+// A multi-deck dealing shoe with a cut card.
+//
+// Game used to build a fresh Deck and shuffle it before every hand, which is
+// both slower than it needs to be (a shuffle and a random_device read per
+// episode) and unlike any real table. A Shoe persists across hands: it is
+// shuffled once, dealt from until the cut card comes out, and only then
+// reshuffled -- between hands, never in the middle of one.
+//
+
+#ifndef BLACKJACK_AI_SHOE_H
+#define BLACKJACK_AI_SHOE_H
+
+#include "Card.h"
+#include "Random.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class Shoe {
+private:
+    std::vector<Card> cards;
+    std::size_t next;
+    std::size_t handStart;   // first card of the hand in play; before it, discards
+    std::size_t cutCard;     // index at which the cut card sits
+    int decks;
+    double penetration;      // fraction of the shoe dealt before reshuffling
+    rng::Stream stream;
+
+    void build();
+
+public:
+    static constexpr int MIN_DECKS = 1;
+    static constexpr int MAX_DECKS = 8;
+    static constexpr int DEFAULT_DECKS = 6;
+    static constexpr double DEFAULT_PENETRATION = 0.75;
+
+    // Deck count is clamped to [MIN_DECKS, MAX_DECKS] and penetration to
+    // [0.25, 0.95]; a hand still running when the shoe empties is finished
+    // from the reshuffled discards (see dealCard). The shoe shuffles from the
+    // next Domain::Shoe seed; reseed() to pick one.
+    explicit Shoe(int numDecks = DEFAULT_DECKS, double penetration = DEFAULT_PENETRATION);
+
+    // Gather every card back and shuffle. Called automatically; exposed for
+    // callers that want a fresh shoe on demand.
+    void shuffle();
+
+    // Replace the random stream and reshuffle, making every deal from here on
+    // a pure function of the seed. Parallel simulations give each task its own
+    // seeded shoe so results do not depend on which thread ran it.
+    void reseed(std::uint64_t seed);
+
+    // Call before dealing a hand. Reshuffles if the cut card came out during
+    // the previous one, and reports whether it did.
+    bool startHand();
+
+    // Deals the next card. If the shoe runs dry mid-hand (only plausible with a
+    // single deck and deep penetration) the discards -- every card dealt before
+    // this hand -- are shuffled and dealt from, as a dealer would; the cards
+    // on the table stay where they are.
+    Card dealCard();
+
+    bool cutCardReached() const { return next >= cutCard; }
+    std::size_t remaining() const { return cards.size() - next; }
+    std::size_t size() const { return cards.size(); }
+    int numDecks() const { return decks; }
+    double getPenetration() const { return penetration; }
+};
+
+#endif //BLACKJACK_AI_SHOE_H
@@ -0,0 +1,67 @@
+//
+// A small work-stealing thread pool for data-parallel loops.
+//
+// parallelFor(count, body) runs body(i) for every i in [0, count). The index
+// range is split into one contiguous run per participant; each participant
+// takes indices from the front of its own run and, once that is empty, steals
+// from the back of someone else's. The calling thread participates too, so a
+// pool with zero workers (the single-threaded WebAssembly build) simply runs
+// the loop inline.
+//
+// Which thread runs which index is not deterministic. Callers that need
+// reproducible results must make body(i) depend only on i -- its own seed, its
+// own accumulator -- and combine per-index results in index order afterwards.
+//
+
+#ifndef BLACKJACK_AI_TASKPOOL_H
+#define BLACKJACK_AI_TASKPOOL_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class TaskPool {
+private:
+    struct Job;
+
+    std::vector<std::thread> workers;
+    std::mutex mu;
+    std::condition_variable wake;
+    std::deque<std::shared_ptr<Job>> jobs;   // jobs that may still have unclaimed work
+    bool stopping = false;
+
+    void workerLoop(unsigned slot);
+
+public:
+    // threads is the number of background workers; 0 means one fewer than the
+    // hardware concurrency, since the caller of parallelFor also works.
+    explicit TaskPool(unsigned threads = 0);
+    ~TaskPool();
+
+    TaskPool(const TaskPool&) = delete;
+    TaskPool& operator=(const TaskPool&) = delete;
+
+    // Threads that can work on one loop: the workers plus the caller.
+    unsigned concurrency() const { return static_cast<unsigned>(workers.size()) + 1; }
+
+    // Runs body(i) for i in [0, count) and returns once every call has
+    // finished. maxThreads caps how many threads share this loop (0 = all).
+    // The first exception thrown by body is rethrown here, after the loop
+    // drains.
+    void parallelFor(std::size_t count,
+                     const std::function<void(std::size_t)>& body,
+                     unsigned maxThreads = 0);
+
+    // Process-wide pool shared by the API's evaluation and training paths.
+    static TaskPool& shared();
+
+    // Hardware threads available to this process; 1 where there are no threads.
+    static unsigned hardwareThreads();
+};
+
+#endif //BLACKJACK_AI_TASKPOOL_H
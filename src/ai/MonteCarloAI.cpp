@@ -3,17 +3,21 @@
 //
 
 #include "../../include/ai/MonteCarloAI.h"
+#include "../../include/ai/TableFile.h"
+#include "../../include/core/Profile.h"
+#include <cstdint>
 #include <fstream>
 #include <sstream>
 #include <iostream>
 #include <algorithm>
 #include <iomanip>
-#include <unordered_set>
+#include <bitset>
+#include <cmath>
 
 MonteCarloAI::MonteCarloAI(double epsilon, double gamma)
     : epsilon(epsilon), gamma(gamma),
       episodeCount(0), totalReward(0.0),
-      rng(std::random_device{}()), dist(0.0, 1.0) {
+      explore(rng::nextSeed(rng::Domain::Explore)) {
 
     currentEpisode.reserve(20); // Pre-allocate for typical episode length
 }
@@ -31,6 +35,8 @@ void MonteCarloAI::recordStep(const State& state, Action action, double reward)
 }
 
 void MonteCarloAI::endEpisode(double finalReward) {
+    PROFILE_SCOPE(Update);
+
     // Add final reward to last step if episode exists
     if (!currentEpisode.empty()) {
         currentEpisode.back().reward = finalReward;
@@ -52,8 +58,10 @@ void MonteCarloAI::updateFromEpisode() {
         return;
     }
 
-    // Track which state-action pairs we've already seen (first-visit MC)
-    std::unordered_set<StateAction, StateActionHash> visited;
+    // Track which state-action pairs we've already seen (first-visit MC).
+    // Indexed like the table, two bits per state; lives on the stack, so an
+    // episode's update allocates nothing.
+    std::bitset<STATE_COUNT * 2> visited;
 
     // Calculate returns backwards through the episode
     double G = 0.0; // Return (cumulative discounted reward)
@@ -65,37 +73,31 @@ void MonteCarloAI::updateFromEpisode() {
         // Update return with discounted reward
         G = step.reward + gamma * G;
 
-        // Create state-action pair
-        StateAction sa;
-        sa.state = step.state;
-        sa.action = step.action;
+        const int a = static_cast<int>(step.action);
+        const int sa = stateIndex(step.state) * 2 + a;
 
         // First-visit MC: only update if this is the first occurrence
-        if (visited.find(sa) == visited.end()) {
-            visited.insert(sa);
+        if (!visited.test(sa)) {
+            visited.set(sa);
 
-            // Update returns sum
-            returns[sa] += G;
+            QEntry& entry = qTable[step.state];
 
             // Increment visit count
-            visitCounts[sa]++;
+            int N = ++entry.visits[a];
 
             // Update Q-value using incremental mean
             // Q(s,a) ← Q(s,a) + (1/N) * [G - Q(s,a)]
-            int N = visitCounts[sa];
-            double oldQ = qTable[step.state][static_cast<int>(step.action)];
-            double newQ = oldQ + (1.0 / N) * (G - oldQ);
-
-            qTable[step.state][static_cast<int>(step.action)] = newQ;
+            double oldQ = entry.q[a];
+            entry.q[a] = oldQ + (1.0 / N) * (G - oldQ);
         }
     }
 }
 
 Action MonteCarloAI::chooseAction(const State& state) {
     // ε-greedy policy
-    if (dist(rng) < epsilon) {
+    if (explore.uniform() < epsilon) {
         // Explore: random action
-        return (dist(rng) < 0.5) ? Action::HIT : Action::STAND;
+        return (explore.uniform() < 0.5) ? Action::HIT : Action::STAND;
     } else {
         // Exploit: best known action
         return getBestAction(state);
@@ -104,12 +106,13 @@ Action MonteCarloAI::chooseAction(const State& state) {
 
 Action MonteCarloAI::getBestAction(const State& state) const {
     // If state not in Q-table, use heuristic
-    if (qTable.find(state) == qTable.end()) {
+    const auto* entry = qTable.find(state);
+    if (entry == nullptr) {
         // Basic heuristic: hit if < 17, stand otherwise
-        return (state.playerSum < 17) ? Action::HIT : Action::STAND;
+        return fallbackAction(state);
     }
 
-    const auto& qValues = qTable.at(state);
+    const auto& qValues = entry->q;
 
     // Return action with highest Q-value
     return (qValues[static_cast<int>(Action::HIT)] > qValues[static_cast<int>(Action::STAND)])
@@ -117,43 +120,61 @@ Action MonteCarloAI::getBestAction(const State& state) const {
 }
 
 void MonteCarloAI::saveQTable(const std::string& filename) const {
-    std::ofstream file(filename);
-
-    if (!file.is_open()) {
-        std::cerr << "Error: Could not open file " << filename << " for writing.\n";
+    if (!tablefile::isCsvPath(filename)) {
+        tablefile::Meta meta;
+        meta.agent = tablefile::AgentType::MonteCarlo;
+        meta.episodes = static_cast<std::uint64_t>(episodeCount);
+        meta.epsilon = epsilon;
+        meta.totalReward = totalReward;
+        if (tablefile::save(filename, meta, qTable)) {
+            std::cout << "Monte Carlo Q-table saved to " << filename
+                      << " (" << qTable.size() << " states, binary)\n";
+        }
         return;
     }
 
-    // Write header
-    file << "playerSum,dealerUpcard,usableAce,action,qValue,visitCount\n";
-
-    // Write Q-table entries
-    for (const auto& [state, qValues] : qTable) {
-        for (int a = 0; a < 2; ++a) {
-            StateAction sa;
-            sa.state = state;
-            sa.action = static_cast<Action>(a);
-
-            int visits = 0;
-            if (visitCounts.find(sa) != visitCounts.end()) {
-                visits = visitCounts.at(sa);
+    // CSV export, written to a temporary file and renamed over the target.
+    bool ok = tablefile::writeAtomically(filename, [&](std::ostream& file) {
+        // Write header
+        file << "playerSum,dealerUpcard,usableAce,action,qValue,visitCount\n";
+
+        // Write Q-table entries
+        qTable.forEach([&](const State& state, const QEntry& entry) {
+            for (int a = 0; a < 2; ++a) {
+                file << state.playerSum << ","
+                     << state.dealerUpcard << ","
+                     << state.usableAce << ","
+                     << a << ","
+                     << std::fixed << std::setprecision(6) << entry.q[a] << ","
+                     << entry.visits[a] << "\n";
             }
+        });
+        return static_cast<bool>(file);
+    });
 
-            file << state.playerSum << ","
-                 << state.dealerUpcard << ","
-                 << state.usableAce << ","
-                 << a << ","
-                 << std::fixed << std::setprecision(6) << qValues[a] << ","
-                 << visits << "\n";
-        }
+    if (ok) {
+        std::cout << "Monte Carlo Q-table saved to " << filename << " (" << qTable.size() << " states)\n";
     }
-
-    file.close();
-    std::cout << "Monte Carlo Q-table saved to " << filename
-              << " (" << qTable.size() << " states)\n";
 }
 
 void MonteCarloAI::loadQTable(const std::string& filename) {
+    // Binary tables map straight into the state table, training state included.
+    if (tablefile::isBinary(filename)) {
+        tablefile::Meta meta;
+        std::string error;
+        if (!tablefile::load(filename, tablefile::AgentType::MonteCarlo, meta, qTable, error)) {
+            std::cerr << "Warning: Could not load " << filename << ": " << error << "\n";
+            std::cerr << "Keeping the current Q-table.\n";
+            return;
+        }
+        episodeCount = static_cast<int>(meta.episodes);
+        epsilon = meta.epsilon;
+        totalReward = meta.totalReward;
+        std::cout << "Monte Carlo Q-table loaded from " << filename << " (" << qTable.size()
+                  << " states, " << episodeCount << " episodes)\n";
+        return;
+    }
+
     std::ifstream file(filename);
 
     if (!file.is_open()) {
@@ -163,8 +184,6 @@ void MonteCarloAI::loadQTable(const std::string& filename) {
     }
 
     qTable.clear();
-    returns.clear();
-    visitCounts.clear();
 
     std::string line;
     std::getline(file, line); // Skip header
@@ -199,16 +218,15 @@ void MonteCarloAI::loadQTable(const std::string& filename) {
         std::getline(ss, token, ',');
         visits = std::stoi(token);
 
-        qTable[state][action] = qValue;
-
-        StateAction sa;
-        sa.state = state;
-        sa.action = static_cast<Action>(action);
-        visitCounts[sa] = visits;
+        // Rows outside the state space cannot come from this engine; skip
+        // them rather than let one bad line abort the load.
+        if (!inStateSpace(state) || action < 0 || action > 1) {
+            continue;
+        }
 
-        // Reconstruct returns sum from Q-value and visit count
-        // Since Q = sum(returns) / N, then sum(returns) = Q * N
-        returns[sa] = qValue * visits;
+        QEntry& entry = qTable[state];
+        entry.q[action] = qValue;
+        entry.visits[action] = visits;
 
         loadedStates++;
     }
@@ -219,10 +237,11 @@ void MonteCarloAI::loadQTable(const std::string& filename) {
 }
 
 double MonteCarloAI::getQValue(const State& state, Action action) const {
-    if (qTable.find(state) == qTable.end()) {
+    const auto* entry = qTable.find(state);
+    if (entry == nullptr) {
         return 0.0;
     }
-    return qTable.at(state)[static_cast<int>(action)];
+    return entry->q[static_cast<int>(action)];
 }
 
 void MonteCarloAI::setEpsilon(double newEpsilon) {
@@ -238,18 +257,23 @@ void MonteCarloAI::decayEpsilon(double decayRate) {
     // control is on-policy, so it converges to the best epsilon-soft policy
     // rather than the optimal one. More exploration here means a worse greedy
     // policy to extract, not just wider coverage.
-    epsilon = std::max(0.01, epsilon * decayRate);
+    epsilon = std::max(EPSILON_FLOOR, epsilon * decayRate);
 }
 
-int MonteCarloAI::getVisitCount(const State& state, Action action) const {
-    StateAction sa;
-    sa.state = state;
-    sa.action = action;
+double MonteCarloAI::epsilonAfter(long long episodes, double decayRate) const {
+    return std::max(EPSILON_FLOOR, epsilon * std::pow(decayRate, static_cast<double>(episodes)));
+}
 
-    if (visitCounts.find(sa) == visitCounts.end()) {
+PolicySnapshot MonteCarloAI::snapshot() const {
+    return PolicySnapshot::of(qTable, static_cast<std::uint64_t>(episodeCount));
+}
+
+int MonteCarloAI::getVisitCount(const State& state, Action action) const {
+    const QEntry* entry = qTable.find(state);
+    if (entry == nullptr) {
         return 0;
     }
-    return visitCounts.at(sa);
+    return entry->visits[static_cast<int>(action)];
 }
 
 void MonteCarloAI::printStats() const {
@@ -266,15 +290,19 @@ void MonteCarloAI::printStats() const {
     std::cout << "Gamma (discount): " << gamma << "\n";
 
     // Calculate total visits
-    int totalVisits = 0;
-    for (const auto& [sa, count] : visitCounts) {
-        totalVisits += count;
-    }
+    long long totalVisits = 0;
+    int visitedPairs = 0;
+    qTable.forEach([&](const State&, const QEntry& entry) {
+        for (int count : entry.visits) {
+            totalVisits += count;
+            if (count > 0) ++visitedPairs;
+        }
+    });
     std::cout << "Total state-action visits: " << totalVisits << "\n";
 
-    if (!visitCounts.empty()) {
+    if (visitedPairs > 0) {
         std::cout << "Avg visits per state-action: "
-                  << (totalVisits / static_cast<double>(visitCounts.size())) << "\n";
+                  << (totalVisits / static_cast<double>(visitedPairs)) << "\n";
     }
 
     std::cout << "=================================\n\n";
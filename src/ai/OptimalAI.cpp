@@ -0,0 +1,578 @@
+//
+// Exact solver behind OptimalAI; see OptimalAI.h.
+//
+// Hands are solved per dealer upcard as a graph of card *compositions* (how
+// many of each value the player holds), since with a finite shoe that, not the
+// total, fixes the odds of every later card. Each node knows its next-card
+// probabilities and children, so evaluating any hit/stand policy is one pass
+// from the highest hard total down: every draw raises the hard total (aces
+// counted as 1), so children are always finished before their parents.
+//
+
+#include "../../include/ai/OptimalAI.h"
+#include "../../include/ai/StateTable.h"
+#include "../../include/ai/TableFile.h"
+#include "../../include/core/Rules.h"
+#include "../../include/core/TaskPool.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+// Card values are indexed 0..9 for ace (counted 1) through ten.
+constexpr int VALUES = 10;
+
+// Refinement passes for finite shoes; see OptimalAI.h. Two normally suffice.
+constexpr int MAX_PASSES = 8;
+
+using Counts = std::array<std::uint8_t, VALUES>;
+
+std::uint64_t keyOf(const Counts& c) {
+    std::uint64_t k = 0;
+    for (int v = 0; v < VALUES; ++v) k = (k << 5) | c[v];
+    return k;
+}
+
+// What is left to draw from. Infinite shoes ignore removal.
+struct CardsLeft {
+    std::array<int, VALUES> left{};
+    int size = 0;
+    bool infinite = false;
+
+    static CardsLeft full(int decks) {
+        CardsLeft s;
+        s.infinite = (decks == OptimalAI::INFINITE_DECK);
+        for (int v = 0; v < VALUES; ++v) s.left[v] = (v == 9 ? 16 : 4) * std::max(1, decks);
+        s.size = 52 * std::max(1, decks);
+        return s;
+    }
+
+    double prob(int v) const {
+        if (infinite) return (v == 9 ? 4.0 : 1.0) / 13.0;
+        return left[v] > 0 ? static_cast<double>(left[v]) / size : 0.0;
+    }
+    void take(int v) { if (!infinite) { --left[v]; --size; } }
+    void put(int v)  { if (!infinite) { ++left[v]; ++size; } }
+};
+
+int handValue(int hard, bool ace) {
+    return (ace && hard + 10 <= 21) ? hard + 10 : hard;
+}
+
+// Dealer::playTurn from a partial hand: draw while below 17, aces soft when
+// they fit, so soft 17 stands.
+void dealerFrom(int hard, bool ace, int cards, double p, CardsLeft& s,
+                OptimalAI::DealerOdds& out) {
+    if (hard > 21) { out.bust += p; return; }
+    int value = handValue(hard, ace);
+    if (value >= 17) {
+        out.total[value - 17] += p;
+        if (cards == 2 && value == 21) out.natural += p;
+        return;
+    }
+    for (int v = 0; v < VALUES; ++v) {
+        double pv = s.prob(v);
+        if (pv == 0.0) continue;
+        s.take(v);
+        dealerFrom(hard + v + 1, ace || v == 0, cards + 1, p * pv, s, out);
+        s.put(v);
+    }
+}
+
+// With an infinite deck the rest of the dealer's hand depends only on where
+// it stands now, so after the hole card it is memoised on (hard total, ace).
+using DealerMemo = std::array<std::array<std::unique_ptr<OptimalAI::DealerOdds>, 2>, 32>;
+
+const OptimalAI::DealerOdds& dealerAfterTwo(int hard, bool ace, const CardsLeft& s,
+                                            DealerMemo& memo) {
+    auto& slot = memo[hard][ace];
+    if (slot) return *slot;
+    slot = std::make_unique<OptimalAI::DealerOdds>();
+    OptimalAI::DealerOdds& d = *slot;
+    int value = handValue(hard, ace);
+    if (hard > 21) {
+        d.bust = 1.0;
+    } else if (value >= 17) {
+        d.total[value - 17] = 1.0;
+    } else {
+        for (int v = 0; v < VALUES; ++v) {
+            double pv = s.prob(v);
+            const OptimalAI::DealerOdds& next = dealerAfterTwo(hard + v + 1, ace || v == 0, s, memo);
+            for (int t = 0; t < 5; ++t) d.total[t] += pv * next.total[t];
+            d.bust += pv * next.bust;
+        }
+    }
+    return d;
+}
+
+OptimalAI::DealerOdds dealerOddsFor(int up, CardsLeft& s) {
+    OptimalAI::DealerOdds d;
+    if (!s.infinite) {
+        dealerFrom(up + 1, up == 0, 1, 1.0, s, d);
+        return d;
+    }
+    DealerMemo memo;
+    for (int v = 0; v < VALUES; ++v) {
+        double pv = s.prob(v);
+        int hard = up + v + 2;
+        bool ace = up == 0 || v == 0;
+        const OptimalAI::DealerOdds& next = dealerAfterTwo(hard, ace, s, memo);
+        for (int t = 0; t < 5; ++t) d.total[t] += pv * next.total[t];
+        d.bust += pv * next.bust;
+        if (handValue(hard, ace) == 21) d.natural += pv;
+    }
+    return d;
+}
+
+// The dealer's draws after the upcard, grouped by which cards were drawn.
+//
+// Re-running dealerFrom against every player composition's shoe walks ~60,000
+// ordered draw sequences each time, which makes a six-deck solve take seconds.
+// But the probability of a particular sequence from a shoe S is
+//     prod_v S_v (S_v - 1) ... (S_v - m_v + 1)  /  |S| (|S| - 1) ... (|S| - n + 1)
+// which depends only on the *multiset* of cards drawn (m_v of each value, n
+// in all), and so does where the dealer ends up. Enumerating the multisets and
+// how many valid orders each has once per upcard turns every later shoe into
+// a few thousand short products.
+struct DealerPaths {
+    struct Path {
+        double orders = 0.0;       // draw orders that stop exactly here
+        int cards = 0;
+        int outcome = 0;           // 0..4 = final 17..21, 5 = bust
+        bool natural = false;
+        std::uint8_t distinct = 0;
+        std::array<std::uint8_t, VALUES> value{}, count{};   // first `distinct` used
+    };
+    std::vector<Path> paths;
+    int maxCards = 0;
+
+    explicit DealerPaths(int up) {
+        std::unordered_map<std::uint64_t, std::size_t> index;
+        Counts drawn{};
+        walk(up + 1, up == 0, 0, drawn, index);
+    }
+
+    OptimalAI::DealerOdds odds(const CardsLeft& s) const {
+        // Falling factorials of each value's count, and of the shoe size.
+        std::array<std::array<double, 22>, VALUES> fall;
+        for (int v = 0; v < VALUES; ++v) {
+            fall[v][0] = 1.0;
+            for (int m = 1; m <= 21; ++m) {
+                fall[v][m] = fall[v][m - 1] * std::max(0, s.left[v] - m + 1);
+            }
+        }
+        std::array<double, 22> size{};
+        size[0] = 1.0;
+        for (int n = 1; n <= maxCards; ++n) size[n] = size[n - 1] * (s.size - n + 1);
+
+        OptimalAI::DealerOdds d;
+        for (const Path& p : paths) {
+            double pr = p.orders / size[p.cards];
+            for (int i = 0; i < p.distinct; ++i) pr *= fall[p.value[i]][p.count[i]];
+            if (p.outcome == 5) d.bust += pr;
+            else d.total[p.outcome] += pr;
+            if (p.natural) d.natural += pr;
+        }
+        return d;
+    }
+
+private:
+    void walk(int hard, bool ace, int cards, Counts& drawn,
+              std::unordered_map<std::uint64_t, std::size_t>& index) {
+        int value = handValue(hard, ace);
+        if (hard <= 21 && value < 17) {
+            for (int v = 0; v < VALUES; ++v) {
+                ++drawn[v];
+                walk(hard + v + 1, ace || v == 0, cards + 1, drawn, index);
+                --drawn[v];
+            }
+            return;
+        }
+        auto it = index.find(keyOf(drawn));
+        if (it == index.end()) {
+            Path p;
+            p.cards = cards;
+            p.outcome = hard > 21 ? 5 : value - 17;
+            p.natural = (cards == 1 && value == 21);
+            for (int v = 0; v < VALUES; ++v) {
+                if (drawn[v] == 0) continue;
+                p.value[p.distinct] = static_cast<std::uint8_t>(v);
+                p.count[p.distinct] = drawn[v];
+                ++p.distinct;
+            }
+            it = index.emplace(keyOf(drawn), paths.size()).first;
+            paths.push_back(p);
+            maxCards = std::max(maxCards, cards);
+        }
+        paths[it->second].orders += 1.0;
+    }
+};
+
+// rules::computeReward for a player who stands on `total` without a natural.
+// The dealer's natural is just 21 here.
+double standValue(int total, const OptimalAI::DealerOdds& d) {
+    double win = d.bust, lose = 0.0;
+    for (int t = 17; t <= 21; ++t) {
+        if (t < total) win += d.total[t - 17];
+        else if (t > total) lose += d.total[t - 17];
+    }
+    return win - lose;
+}
+
+// A state's (Q(HIT), Q(STAND)) from its weighted sums; see the solve loop.
+std::array<double, 2> stateQ(const std::array<double, 6>& a) {
+    if (a[0] > 0.0) return {a[1] / a[0], a[2] / a[0]};
+    if (a[3] > 0.0) return {a[4] / a[3], a[5] / a[3]};
+    return {0.0, 0.0};
+}
+
+State stateOf(int hard, bool ace, int up) {
+    return State{handValue(hard, ace), up == 0 ? 11 : up + 1, ace && hard + 10 <= 21};
+}
+
+} // namespace
+
+struct OptimalAI::Model {
+    struct Node {
+        int hard = 0;            // aces counted as 1
+        int total = 0;
+        int state = 0;           // stateIndex
+        bool natural = false;
+        double stand = 0.0;      // standing payout; a natural's 3:2 (or push)
+        double initial = 0.0;    // P(dealt as the first two cards | upcard)
+        std::array<double, VALUES> p{};    // next-card probabilities
+        std::array<int, VALUES> child{};   // node index, or -1 for a bust
+    };
+
+    struct Upcard {
+        double prob = 0.0;
+        std::vector<Node> nodes;   // ascending hard total
+    };
+
+    std::array<Upcard, VALUES> up;
+
+    // Upcards are independent, so each is built as its own pool task.
+    explicit Model(int decks) {
+        TaskPool::shared().parallelFor(VALUES, [&](std::size_t i) {
+            int u = static_cast<int>(i);
+            CardsLeft shoe = CardsLeft::full(decks);
+            up[u].prob = shoe.prob(u);
+            shoe.take(u);
+            build(up[u], u, shoe);
+        });
+    }
+
+private:
+    // Every composition of two or more cards totalling 21 or less, with its
+    // stand value against what is left.
+    static void build(Upcard& out, int u, CardsLeft& shoe) {
+        std::vector<Counts> hands;
+        Counts c{};
+        collect(hands, c, 0, 0, 0, shoe);
+        std::sort(hands.begin(), hands.end(), [](const Counts& a, const Counts& b) {
+            return hardOf(a) < hardOf(b);
+        });
+
+        std::unordered_map<std::uint64_t, int> index;
+        index.reserve(hands.size() * 2);
+        for (std::size_t i = 0; i < hands.size(); ++i) index[keyOf(hands[i])] = static_cast<int>(i);
+
+        OptimalAI::DealerOdds shared;
+        std::unique_ptr<DealerPaths> paths;
+        if (shoe.infinite) shared = dealerOddsFor(u, shoe);
+        else paths = std::make_unique<DealerPaths>(u);
+
+        out.nodes.resize(hands.size());
+        for (std::size_t i = 0; i < hands.size(); ++i) {
+            const Counts& h = hands[i];
+            Node& n = out.nodes[i];
+            int cards = 0;
+            for (int v = 0; v < VALUES; ++v) cards += h[v];
+            n.hard = hardOf(h);
+            n.total = handValue(n.hard, h[0] > 0);
+            n.state = stateIndex(stateOf(n.hard, h[0] > 0, u));
+            n.natural = (cards == 2 && n.total == 21);
+
+            for (int v = 0; v < VALUES; ++v) for (int k = 0; k < h[v]; ++k) shoe.take(v);
+
+            OptimalAI::DealerOdds d = shoe.infinite ? shared : paths->odds(shoe);
+            n.stand = n.natural ? 1.5 * (1.0 - d.natural) : standValue(n.total, d);
+
+            for (int v = 0; v < VALUES; ++v) {
+                n.p[v] = shoe.prob(v);
+                n.child[v] = -1;
+                if (n.total >= 21 || n.hard + v + 1 > 21 || n.p[v] == 0.0) continue;
+                Counts next = h;
+                ++next[v];
+                n.child[v] = index.at(keyOf(next));
+            }
+
+            for (int v = 0; v < VALUES; ++v) for (int k = 0; k < h[v]; ++k) shoe.put(v);
+
+            if (cards == 2) {
+                // Either card may come first.
+                int a = -1, b = -1;
+                for (int v = 0; v < VALUES; ++v) {
+                    for (int k = 0; k < h[v]; ++k) (a < 0 ? a : b) = v;
+                }
+                double pa = shoe.prob(a);
+                shoe.take(a);
+                double pab = pa * shoe.prob(b);
+                shoe.put(a);
+                n.initial = (a == b) ? pab : 2.0 * pab;
+            }
+        }
+    }
+
+    static int hardOf(const Counts& c) {
+        int h = 0;
+        for (int v = 0; v < VALUES; ++v) h += c[v] * (v + 1);
+        return h;
+    }
+
+    // Multisets in non-decreasing value order, so each is generated once; the
+    // shoe bounds how many of a value fit. Not every one is reachable (a hand
+    // stops at 21 whatever order its cards came in), but those simply never
+    // receive any weight.
+    static void collect(std::vector<Counts>& out, Counts& c, int from, int hard, int cards,
+                        CardsLeft& shoe) {
+        if (cards >= 2) out.push_back(c);
+        for (int v = from; v < VALUES; ++v) {
+            if (hard + v + 1 > 21) break;
+            if (shoe.prob(v) == 0.0) continue;
+            ++c[v];
+            shoe.take(v);
+            collect(out, c, v, hard + v + 1, cards + 1, shoe);
+            shoe.put(v);
+            --c[v];
+        }
+    }
+};
+
+OptimalAI::OptimalAI(int numDecks)
+    : decks(numDecks == INFINITE_DECK
+                ? INFINITE_DECK
+                : std::max(Shoe::MIN_DECKS, std::min(Shoe::MAX_DECKS, numDecks))) {
+    auto start = std::chrono::steady_clock::now();
+
+    model = std::make_shared<const Model>(decks);
+
+    CardsLeft shoe = CardsLeft::full(decks);
+    for (int u = 0; u < VALUES; ++u) {
+        shoe.take(u);
+        dealer[u == 0 ? 9 : u - 1] = dealerOddsFor(u, shoe);
+        shoe.put(u);
+    }
+
+    // Start from the published chart; each pass re-weights compositions by how
+    // often the current policy reaches them, then re-decides every state from
+    // the top down.
+    std::array<Action, STATE_COUNT> policy{};
+    for (int i = 0; i < STATE_COUNT; ++i) policy[i] = rules::basicStrategy(stateAt(i));
+
+    for (passes = 1; passes <= MAX_PASSES; ++passes) {
+        std::array<Action, STATE_COUNT> next = policy;
+        // Per state: reach weight, w*qHit, w*qStand under the policy, then the
+        // same with every earlier card taken as a hit -- used for states the
+        // policy never reaches, so they still get a value.
+        std::array<std::array<double, 6>, STATE_COUNT> acc{};
+        reachable.reset();
+        ev = 0.0;
+
+        for (const Model::Upcard& up : model->up) {
+            const auto& nodes = up.nodes;
+            std::vector<double> weight(nodes.size()), raw(nodes.size()), value(nodes.size());
+            std::vector<std::array<double, 2>> nodeQ(nodes.size());
+
+            for (std::size_t i = 0; i < nodes.size(); ++i) {
+                const Model::Node& n = nodes[i];
+                weight[i] += n.initial;
+                raw[i] += n.initial;
+                if (n.total >= 21) continue;
+                bool hits = policy[n.state] == Action::HIT;
+                for (int v = 0; v < VALUES; ++v) {
+                    if (n.child[v] < 0) continue;
+                    raw[n.child[v]] += raw[i] * n.p[v];
+                    if (hits) weight[n.child[v]] += weight[i] * n.p[v];
+                }
+            }
+
+            // Descending hard total, one total at a time: every node of a total
+            // is valued before any of its states is decided.
+            std::size_t end = nodes.size();
+            while (end > 0) {
+                std::size_t begin = end;
+                while (begin > 0 && nodes[begin - 1].hard == nodes[end - 1].hard) --begin;
+
+                for (std::size_t i = begin; i < end; ++i) {
+                    const Model::Node& n = nodes[i];
+                    double hit = 0.0;
+                    for (int v = 0; v < VALUES; ++v) {
+                        if (n.p[v] == 0.0) continue;
+                        hit += n.p[v] * (n.child[v] < 0 ? -1.0 : value[n.child[v]]);
+                    }
+                    nodeQ[i] = {hit, n.stand};
+                    if (n.natural) continue;
+                    auto& a = acc[n.state];
+                    a[0] += weight[i]; a[1] += weight[i] * hit; a[2] += weight[i] * n.stand;
+                    a[3] += raw[i];    a[4] += raw[i] * hit;    a[5] += raw[i] * n.stand;
+                }
+                for (std::size_t i = begin; i < end; ++i) {
+                    const Model::Node& n = nodes[i];
+                    if (n.natural) continue;
+                    std::array<double, 2> sq = stateQ(acc[n.state]);
+                    next[n.state] = (n.total < 21 && sq[0] > sq[1]) ? Action::HIT : Action::STAND;
+                }
+                for (std::size_t i = begin; i < end; ++i) {
+                    const Model::Node& n = nodes[i];
+                    value[i] = (n.natural || next[n.state] == Action::STAND) ? nodeQ[i][1]
+                                                                             : nodeQ[i][0];
+                    ev += up.prob * n.initial * value[i];
+                }
+                end = begin;
+            }
+        }
+
+        for (int i = 0; i < STATE_COUNT; ++i) {
+            q[i] = stateQ(acc[i]);
+            if (acc[i][3] > 0.0) reachable.set(i);
+        }
+
+        bool stable = (next == policy);
+        policy = next;
+        if (stable) break;
+    }
+    passes = std::min(passes, MAX_PASSES);
+
+    solveMs = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - start).count();
+}
+
+double OptimalAI::expectedReturn(const std::function<Action(const State&)>& policy) const {
+    std::array<Action, STATE_COUNT> act{};
+    for (int i = 0; i < STATE_COUNT; ++i) act[i] = policy(stateAt(i));
+
+    // The solve loop with the decisions fixed: one pass, nothing to aggregate.
+    double total = 0.0;
+    for (const Model::Upcard& up : model->up) {
+        const auto& nodes = up.nodes;
+        std::vector<double> value(nodes.size());
+        for (std::size_t i = nodes.size(); i-- > 0;) {
+            const Model::Node& n = nodes[i];
+            if (n.natural || n.total >= 21 || act[n.state] == Action::STAND) {
+                value[i] = n.stand;
+            } else {
+                double hit = 0.0;
+                for (int v = 0; v < VALUES; ++v) {
+                    if (n.p[v] == 0.0) continue;
+                    hit += n.p[v] * (n.child[v] < 0 ? -1.0 : value[n.child[v]]);
+                }
+                value[i] = hit;
+            }
+            total += up.prob * n.initial * value[i];
+        }
+    }
+    return total;
+}
+
+bool OptimalAI::hasValue(const State& state) const {
+    return inStateSpace(state) && reachable.test(stateIndex(state));
+}
+
+Action OptimalAI::getBestAction(const State& state) const {
+    if (!hasValue(state)) return fallbackAction(state);
+    if (state.playerSum >= 21) return Action::STAND;
+    const auto& v = q[stateIndex(state)];
+    return v[static_cast<int>(Action::HIT)] > v[static_cast<int>(Action::STAND)]
+           ? Action::HIT : Action::STAND;
+}
+
+double OptimalAI::getQValue(const State& state, Action action) const {
+    return hasValue(state) ? q[stateIndex(state)][static_cast<int>(action)] : 0.0;
+}
+
+double OptimalAI::getStateValue(const State& state) const {
+    return getQValue(state, getBestAction(state));
+}
+
+const OptimalAI::DealerOdds& OptimalAI::dealerOdds(int upcard) const {
+    int u = std::max(MIN_STATE_UPCARD, std::min(MAX_STATE_UPCARD, upcard));
+    return dealer[u - MIN_STATE_UPCARD];
+}
+
+void OptimalAI::saveQTable(const std::string& filename) const {
+    bool ok;
+    if (tablefile::isCsvPath(filename)) {
+        ok = tablefile::writeAtomically(filename, [&](std::ostream& file) {
+            file << "playerSum,dealerUpcard,usableAce,action,qValue,visitCount\n";
+            for (int i = 0; i < STATE_COUNT; ++i) {
+                if (!reachable.test(i)) continue;
+                State s = stateAt(i);
+                for (int a = 0; a < 2; ++a) {
+                    file << s.playerSum << "," << s.dealerUpcard << "," << s.usableAce << ","
+                         << a << "," << std::fixed << std::setprecision(6) << q[i][a] << ",0\n";
+                }
+            }
+            return static_cast<bool>(file);
+        });
+    } else {
+        StateTable<QEntry> table;
+        for (int i = 0; i < STATE_COUNT; ++i) {
+            if (!reachable.test(i)) continue;
+            table[stateAt(i)].q = {q[i][0], q[i][1]};
+        }
+        tablefile::Meta meta;
+        meta.agent = tablefile::AgentType::Optimal;
+        ok = tablefile::save(filename, meta, table);
+    }
+
+    if (ok) {
+        std::cout << "Optimal Q-table saved to " << filename << " (" << reachable.count() << " states)\n";
+    }
+}
+
+void OptimalAI::printStats() const {
+    std::cout << "\n=== Optimal Strategy (exact) ===\n";
+    if (decks == INFINITE_DECK) std::cout << "Shoe: infinite deck\n";
+    else std::cout << "Shoe: " << decks << " deck(s), freshly shuffled\n";
+    std::cout << "Expected return per hand: " << std::fixed << std::setprecision(5) << ev << "\n";
+    std::cout << "States solved: " << reachable.count() << "\n";
+    std::cout << "Solved in " << std::setprecision(1) << solveMs << " ms ("
+              << passes << " pass" << (passes == 1 ? "" : "es") << ")\n\n";
+
+    std::cout << "Dealer final totals by upcard (%):\n";
+    std::cout << "Up  |   17    18    19    20    21  (natural)  bust\n";
+    for (int up = MIN_STATE_UPCARD; up <= MAX_STATE_UPCARD; ++up) {
+        const DealerOdds& d = dealerOdds(up);
+        std::cout << (up == 11 ? " A" : (up < 10 ? " " : "") + std::to_string(up)) << "  |"
+                  << std::setprecision(1);
+        for (double p : d.total) std::cout << std::setw(6) << 100.0 * p;
+        std::cout << "  (" << std::setw(5) << 100.0 * d.natural << ")  "
+                  << std::setw(5) << 100.0 * d.bust << "\n";
+    }
+    std::cout << "================================\n\n";
+}
+
+void OptimalAI::printStrategy() const {
+    auto row = [&](int sum, bool soft) {
+        std::cout << (soft ? "Soft " : "Hard ") << std::setw(2) << sum << " |";
+        for (int up = MIN_STATE_UPCARD; up <= MAX_STATE_UPCARD; ++up) {
+            State s{sum, up, soft};
+            std::cout << "  " << (getBestAction(s) == Action::HIT ? 'H' : 'S');
+        }
+        std::cout << "\n";
+    };
+
+    std::cout << "\nOptimal hit/stand chart (H = hit, S = stand)\n";
+    std::cout << "        |  2  3  4  5  6  7  8  9 10  A\n";
+    for (int sum = 4; sum <= 20; ++sum) row(sum, false);
+    for (int sum = 12; sum <= 20; ++sum) row(sum, true);
+    std::cout << "\n";
+}
@@ -3,64 +3,102 @@
 //
 
 #include "../../include/ai/QLearningAI.h"
+#include "../../include/core/Profile.h"
+#include "../../include/ai/TableFile.h"
+#include <cstdint>
 #include <fstream>
 #include <sstream>
 #include <iostream>
 #include <algorithm>
-#include <iomanip>
+#include <iomanip>
 #include <cmath>
+#include <utility>
 
 QLearningAI::QLearningAI(double alpha, double gamma, double epsilon)
-    : alpha(alpha), gamma(gamma), epsilon(epsilon),
+    : qTable(std::make_shared<StateTable<QEntry>>()),
+      alpha(alpha), gamma(gamma), epsilon(epsilon),
       episodeCount(0), totalReward(0.0),
-      rng(std::random_device{}()), dist(0.0, 1.0) {
+      explore(rng::nextSeed(rng::Domain::Explore)) {
 
-    // Initialize Q-table with zeros (optional - unordered_map defaults to 0)
-    // We'll use lazy initialization: Q-values default to 0.0 on first access
+    // The table starts zeroed with nothing marked learned; a state only counts
+    // as learned once it has been updated or loaded.
+}
+
+QLearningAI::QLearningAI(const QLearningAI& other)
+    : qTable(std::make_shared<StateTable<QEntry>>(*other.qTable)),
+      alpha(other.alpha), gamma(other.gamma), epsilon(other.epsilon),
+      episodeCount(other.episodeCount), totalReward(other.totalReward),
+      explore(other.explore) {
+}
+
+QLearningAI& QLearningAI::operator=(const QLearningAI& other) {
+    if (this != &other) {
+        QLearningAI copy(other);
+        *this = std::move(copy);
+    }
+    return *this;
 }
 
 Action QLearningAI::chooseAction(const State& state) {
+    return choose(*qTable, state, epsilon, explore);
+}
+
+Action QLearningAI::getBestAction(const State& state) const {
+    return best(*qTable, state);
+}
+
+void QLearningAI::updateQValue(const State& state,
+                                 Action action,
+                                 double reward,
+                                 const State& nextState,
+                                 bool isTerminal) {
+    update(*qTable, alpha, gamma, state, action, reward, nextState, isTerminal);
+}
+
+Action QLearningAI::choose(const StateTable<QEntry>& table, const State& state,
+                           double epsilon, rng::Stream& explore) {
     // ε-greedy policy
-    if (dist(rng) < epsilon) {
+    if (explore.uniform() < epsilon) {
         // Explore: random action
-        return (dist(rng) < 0.5) ? Action::HIT : Action::STAND;
+        return (explore.uniform() < 0.5) ? Action::HIT : Action::STAND;
     } else {
         // Exploit: best known action
-        return getBestAction(state);
+        return best(table, state);
     }
 }
 
-Action QLearningAI::getBestAction(const State& state) const {
+Action QLearningAI::best(const StateTable<QEntry>& table, const State& state) {
     // If state not in Q-table, default to STAND (conservative)
-    if (qTable.find(state) == qTable.end()) {
+    const QEntry* entry = table.find(state);
+    if (entry == nullptr) {
         // Basic heuristic: hit if < 17, stand otherwise
-        return (state.playerSum < 17) ? Action::HIT : Action::STAND;
+        return fallbackAction(state);
     }
 
-    const auto& qValues = qTable.at(state);
+    const auto& qValues = entry->q;
 
     // Return action with highest Q-value
     return (qValues[static_cast<int>(Action::HIT)] > qValues[static_cast<int>(Action::STAND)])
            ? Action::HIT : Action::STAND;
 }
 
-void QLearningAI::updateQValue(const State& state,
-                                 Action action,
-                                 double reward,
-                                 const State& nextState,
-                                 bool isTerminal) {
+void QLearningAI::update(StateTable<QEntry>& table, double alpha, double gamma,
+                         const State& state, Action action, double reward,
+                         const State& nextState, bool isTerminal) {
+    PROFILE_SCOPE(Update);
 
     // Get current Q-value (defaults to 0.0 if not in table)
-    double currentQ = qTable[state][static_cast<int>(action)];
+    QEntry& entry = table[state];
+    const int a = static_cast<int>(action);
+    double currentQ = entry.q[a];
 
     double maxNextQ = 0.0;
 
     if (!isTerminal) {
         // Find max Q-value for next state
-        if (qTable.find(nextState) != qTable.end()) {
-            const auto& nextQValues = qTable[nextState];
-            maxNextQ = std::max(nextQValues[static_cast<int>(Action::HIT)],
-                               nextQValues[static_cast<int>(Action::STAND)]);
+        if (const QEntry* next = table.find(nextState)) {
+            maxNextQ = std::max<double>(next->q[static_cast<int>(Action::HIT)],
+                                        next->q[static_cast<int>(Action::STAND)]);
         }
     }
     // If terminal, maxNextQ stays 0.0
@@ -78,53 +116,80 @@ void QLearningAI::updateQValue(const State& state,
     // converge. 1/n does that but forgets too slowly to track the moving
     // bootstrap target, so the exponent is backed off to 0.7 -- still summable,
     // still adaptive. (Monte Carlo's exact 1/N sample mean is the same idea.)
-    int n = ++visitCounts[state][static_cast<int>(action)];
+    int n = ++entry.visits[a];
     double lr = std::max(alpha, 1.0 / std::pow(n, LEARNING_RATE_EXPONENT));
 
     // Q-learning update: Q(s,a) ← Q(s,a) + α[r + γ max Q(s',a') - Q(s,a)]
     double newQ = currentQ + lr * (reward + gamma * maxNextQ - currentQ);
 
-    qTable[state][static_cast<int>(action)] = newQ;
+    entry.q[a] = newQ;
 }
 
 int QLearningAI::getVisitCount(const State& state, Action action) const {
-    auto it = visitCounts.find(state);
-    if (it == visitCounts.end()) {
+    const QEntry* entry = qTable->find(state);
+    if (entry == nullptr) {
         return 0;
     }
-    return it->second[static_cast<int>(action)];
+    return entry->visits[static_cast<int>(action)];
 }
 
 void QLearningAI::saveQTable(const std::string& filename) const {
-    std::ofstream file(filename);
-
-    if (!file.is_open()) {
-        std::cerr << "Error: Could not open file " << filename << " for writing.\n";
+    if (!tablefile::isCsvPath(filename)) {
+        tablefile::Meta meta;
+        meta.agent = tablefile::AgentType::QLearning;
+        meta.episodes = static_cast<std::uint64_t>(episodeCount);
+        meta.epsilon = epsilon;
+        meta.totalReward = totalReward;
+        if (tablefile::save(filename, meta, *qTable)) {
+            std::cout << "Q-table saved to " << filename
+                      << " (" << qTable->size() << " states, binary)\n";
+        }
         return;
     }
 
-    // Write header. visitCount is a sixth column; the loader still accepts
-    // five-column files written before it existed.
-    file << "playerSum,dealerUpcard,usableAce,action,qValue,visitCount\n";
-
-    // Write Q-table entries
-    for (const auto& [state, qValues] : qTable) {
-        auto visits = visitCounts.find(state);
-        for (int a = 0; a < 2; ++a) {
-            file << state.playerSum << ","
-                 << state.dealerUpcard << ","
-                 << state.usableAce << ","
-                 << a << ","
-                 << std::fixed << std::setprecision(6) << qValues[a] << ","
-                 << (visits == visitCounts.end() ? 0 : visits->second[a]) << "\n";
-        }
+    // CSV export, written to a temporary file and renamed over the target.
+    bool ok = tablefile::writeAtomically(filename, [&](std::ostream& file) {
+        // Write header. visitCount is a sixth column; the loader still accepts
+        // five-column files written before it existed.
+        file << "playerSum,dealerUpcard,usableAce,action,qValue,visitCount\n";
+
+        // Write Q-table entries
+        qTable->forEach([&](const State& state, const QEntry& entry) {
+            for (int a = 0; a < 2; ++a) {
+                file << state.playerSum << ","
+                     << state.dealerUpcard << ","
+                     << state.usableAce << ","
+                     << a << ","
+                     << std::fixed << std::setprecision(6) << entry.q[a] << ","
+                     << entry.visits[a] << "\n";
+            }
+        });
+        return static_cast<bool>(file);
+    });
+
+    if (ok) {
+        std::cout << "Q-table saved to " << filename << " (" << qTable->size() << " states)\n";
     }
-
-    file.close();
-    std::cout << "Q-table saved to " << filename << " (" << qTable.size() << " states)\n";
 }
 
 void QLearningAI::loadQTable(const std::string& filename) {
+    // Binary tables map straight into the state table, training state included.
+    if (tablefile::isBinary(filename)) {
+        tablefile::Meta meta;
+        std::string error;
+        if (!tablefile::load(filename, tablefile::AgentType::QLearning, meta, *qTable, error)) {
+            std::cerr << "Warning: Could not load " << filename << ": " << error << "\n";
+            std::cerr << "Keeping the current Q-table.\n";
+            return;
+        }
+        episodeCount = static_cast<int>(meta.episodes);
+        epsilon = meta.epsilon;
+        totalReward = meta.totalReward;
+        std::cout << "Q-table loaded from " << filename << " (" << qTable->size()
+                  << " states, " << episodeCount << " episodes)\n";
+        return;
+    }
+
     std::ifstream file(filename);
 
     if (!file.is_open()) {
@@ -133,8 +198,7 @@ void QLearningAI::loadQTable(const std::string& filename) {
         return;
     }
 
-    qTable.clear();
-    visitCounts.clear();
+    qTable->clear();
 
     std::string line;
     std::getline(file, line); // Skip header
@@ -165,13 +229,20 @@ void QLearningAI::loadQTable(const std::string& filename) {
         std::getline(ss, token, ',');
         qValue = std::stod(token);
 
-        qTable[state][action] = qValue;
+        // Rows outside the state space cannot come from this engine; skip
+        // them rather than let one bad line abort the load.
+        if (!inStateSpace(state) || action < 0 || action > 1) {
+            continue;
+        }
+
+        QEntry& entry = (*qTable)[state];
+        entry.q[action] = qValue;
 
         // Sixth column is optional: files saved before visit counts existed
         // simply resume with a count of zero, which restarts the learning-rate
         // schedule for that pair rather than failing to load.
         if (std::getline(ss, token, ',') && !token.empty()) {
-            visitCounts[state][action] = std::stoi(token);
+            entry.visits[action] = std::stoi(token);
         }
 
         loadedStates++;
@@ -182,10 +253,11 @@ void QLearningAI::loadQTable(const std::string& filename) {
 }
 
 double QLearningAI::getQValue(const State& state, Action action) const {
-    if (qTable.find(state) == qTable.end()) {
+    const QEntry* entry = qTable->find(state);
+    if (entry == nullptr) {
         return 0.0;
     }
-    return qTable.at(state)[static_cast<int>(action)];
+    return entry->q[static_cast<int>(action)];
 }
 
 void QLearningAI::setEpsilon(double newEpsilon) {
@@ -205,7 +277,11 @@ void QLearningAI::decayEpsilon(double decayRate) {
     // to -- it only buys state coverage. Keeping a 5% floor means rare states
     // (low totals, soft hands) keep getting revisited instead of freezing at
     // whatever noise they held when epsilon bottomed out.
-    epsilon = std::max(0.05, epsilon * decayRate);
+    epsilon = std::max(EPSILON_FLOOR, epsilon * decayRate);
+}
+
+double QLearningAI::epsilonAfter(long long episodes, double decayRate) const {
+    return std::max(EPSILON_FLOOR, epsilon * std::pow(decayRate, static_cast<double>(episodes)));
 }
 
 void QLearningAI::recordEpisode(double reward) {
@@ -213,6 +289,49 @@ void QLearningAI::recordEpisode(double reward) {
     totalReward += reward;
 }
 
+void QLearningAI::recordEpisodes(int count, double reward) {
+    episodeCount += count;
+    totalReward += reward;
+}
+
+PolicySnapshot QLearningAI::snapshot() const {
+    return PolicySnapshot::of(*qTable, static_cast<std::uint64_t>(episodeCount));
+}
+
+QLearningAI::Worker QLearningAI::worker(std::uint64_t seed) {
+    return Worker(qTable, alpha, gamma, epsilon, seed);
+}
+
+QLearningAI::Worker::Worker(std::shared_ptr<StateTable<QEntry>> table, double alpha,
+                            double gamma, double epsilon, std::uint64_t seed)
+    : qTable(std::move(table)), alpha(alpha), gamma(gamma), epsilon(epsilon),
+      explore(seed) {
+}
+
+Action QLearningAI::Worker::chooseAction(const State& state) {
+    return choose(*qTable, state, epsilon, explore);
+}
+
+Action QLearningAI::Worker::getBestAction(const State& state) const {
+    return best(*qTable, state);
+}
+
+void QLearningAI::Worker::updateQValue(const State& state,
+                                       Action action,
+                                       double reward,
+                                       const State& nextState,
+                                       bool isTerminal) {
+    update(*qTable, alpha, gamma, state, action, reward, nextState, isTerminal);
+}
+
+void QLearningAI::Worker::setEpsilon(double newEpsilon) {
+    epsilon = std::max(0.0, std::min(1.0, newEpsilon));
+}
+
+void QLearningAI::Worker::decayEpsilon(double decayRate) {
+    epsilon = std::max(EPSILON_FLOOR, epsilon * decayRate);
+}
+
 void QLearningAI::printStats() const {
     std::cout << "\n=== Q-Learning AI Statistics ===\n";
     std::cout << "Episodes trained: " << episodeCount << "\n";
@@ -223,7 +342,7 @@ void QLearningAI::printStats() const {
     }
 
     std::cout << "Current epsilon: " << std::fixed << std::setprecision(4) << epsilon << "\n";
-    std::cout << "Q-table size: " << qTable.size() << " states\n";
+    std::cout << "Q-table size: " << qTable->size() << " states\n";
     std::cout << "Alpha (learning rate): " << alpha << "\n";
     std::cout << "Gamma (discount): " << gamma << "\n";
     std::cout << "================================\n\n";
@@ -0,0 +1,281 @@
+//
+// Binary Q-table files; see TableFile.h.
+//
+
+#include "../../include/ai/TableFile.h"
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <type_traits>
+#include <vector>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace tablefile {
+namespace {
+
+constexpr char MAGIC[8] = {'B', 'J', 'Q', 'T', 'A', 'B', 'L', 'E'};
+constexpr std::uint32_t BYTE_ORDER_MARK = 0x01020304u;
+constexpr int MASK_WORDS = (STATE_COUNT + 63) / 64;
+
+struct FileHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t byteOrder;      // BYTE_ORDER_MARK as the writer saw it
+    std::uint32_t headerBytes;
+    std::uint32_t agentType;
+    std::uint32_t stateCount;
+    std::int32_t minPlayerSum, maxPlayerSum, minUpcard, maxUpcard;
+    std::uint32_t entryBytes;
+    std::uint32_t maskWords;
+    std::uint32_t reserved;
+    std::uint64_t episodes;
+    double epsilon;
+    double totalReward;
+    std::uint64_t checksum;       // FNV-1a over everything after the header
+};
+
+struct StoredEntry {
+    double q[2];
+    std::int32_t visits[2];
+};
+
+static_assert(std::is_trivially_copyable<FileHeader>::value, "header is written raw");
+static_assert(sizeof(FileHeader) == 88, "header layout changed: bump FORMAT_VERSION");
+static_assert(sizeof(StoredEntry) == 24, "entry layout changed: bump FORMAT_VERSION");
+
+constexpr std::size_t PAYLOAD_BYTES =
+    MASK_WORDS * sizeof(std::uint64_t) + STATE_COUNT * sizeof(StoredEntry);
+
+std::uint64_t fnv1a(const unsigned char* p, std::size_t n) {
+    std::uint64_t h = 0xcbf29ce484222325ULL;
+    for (std::size_t i = 0; i < n; ++i) {
+        h ^= p[i];
+        h *= 0x100000001b3ULL;
+    }
+    return h;
+}
+
+// A read-only view of a whole file: mmap where there is one, a plain read
+// otherwise.
+class MappedFile {
+private:
+    const unsigned char* ptr = nullptr;
+    std::size_t len = 0;
+#ifndef _WIN32
+    bool mapped = false;
+#endif
+    std::vector<unsigned char> copy;
+
+public:
+    explicit MappedFile(const std::string& path) {
+#ifndef _WIN32
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return;
+        struct stat st;
+        if (::fstat(fd, &st) == 0 && st.st_size > 0) {
+            void* m = ::mmap(nullptr, static_cast<std::size_t>(st.st_size), PROT_READ,
+                             MAP_PRIVATE, fd, 0);
+            if (m != MAP_FAILED) {
+                ptr = static_cast<const unsigned char*>(m);
+                len = static_cast<std::size_t>(st.st_size);
+                mapped = true;
+            }
+        }
+        ::close(fd);
+        if (mapped) return;
+#endif
+        std::ifstream in(path, std::ios::binary);
+        if (!in) return;
+        copy.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+        ptr = copy.data();
+        len = copy.size();
+    }
+
+    ~MappedFile() {
+#ifndef _WIN32
+        if (mapped) ::munmap(const_cast<unsigned char*>(ptr), len);
+#endif
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool ok() const { return ptr != nullptr; }
+    const unsigned char* data() const { return ptr; }
+    std::size_t size() const { return len; }
+};
+
+#ifndef _WIN32
+// fsync on a fresh descriptor for `path`, a file or a directory.
+bool syncPath(const std::string& path, int flags) {
+    int fd = ::open(path.c_str(), flags);
+    if (fd < 0) return false;
+    bool ok = ::fsync(fd) == 0;
+    ::close(fd);
+    return ok;
+}
+
+std::string parentDirectory(const std::string& path) {
+    std::string::size_type slash = path.find_last_of('/');
+    if (slash == std::string::npos) return ".";
+    return slash == 0 ? "/" : path.substr(0, slash);
+}
+#endif
+
+} // namespace
+
+bool isBinary(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    char head[sizeof(MAGIC)] = {};
+    return in.read(head, sizeof(head)) && std::memcmp(head, MAGIC, sizeof(MAGIC)) == 0;
+}
+
+bool isCsvPath(const std::string& path) {
+    return path.size() >= 4 && path.compare(path.size() - 4, 4, ".csv") == 0;
+}
+
+std::string preferBinary(const std::string& binaryPath, const std::string& csvPath) {
+    return std::ifstream(binaryPath).good() ? binaryPath : csvPath;
+}
+
+bool writeAtomically(const std::string& path, const std::function<bool(std::ostream&)>& write) {
+    // Unique per call, so two saves of one path never share a temp file.
+    static std::atomic<unsigned> counter{0};
+    std::string tmp = path + ".tmp" + std::to_string(counter.fetch_add(1));
+#ifndef _WIN32
+    tmp += "." + std::to_string(::getpid());
+#endif
+
+    {
+        std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+        if (!out.is_open()) {
+            std::cerr << "Error: Could not open file " << tmp << " for writing.\n";
+            return false;
+        }
+        if (!write(out) || !out.flush()) {
+            out.close();
+            std::remove(tmp.c_str());
+            std::cerr << "Error: Failed writing " << tmp << ".\n";
+            return false;
+        }
+    }
+
+#ifndef _WIN32
+    // The contents must reach the disk before the rename does, or a crash can
+    // leave `path` naming an empty or partial file.
+    if (!syncPath(tmp, O_WRONLY)) {
+        std::remove(tmp.c_str());
+        std::cerr << "Error: Could not flush " << tmp << " to disk.\n";
+        return false;
+    }
+#endif
+
+#ifdef _WIN32
+    // rename() does not replace an existing file on Windows.
+    std::remove(path.c_str());
+#endif
+    if (std::rename(tmp.c_str(), path.c_str()) != 0) {
+        std::remove(tmp.c_str());
+        std::cerr << "Error: Could not replace " << path << ".\n";
+        return false;
+    }
+#ifndef _WIN32
+    // And the rename itself lives in the directory. Some filesystems cannot
+    // sync a directory; the file is in place either way, so this is best effort.
+    syncPath(parentDirectory(path), O_RDONLY);
+#endif
+    return true;
+}
+
+bool save(const std::string& path, const Meta& meta, const StateTable<QEntry>& table) {
+    std::vector<unsigned char> payload(PAYLOAD_BYTES, 0);
+    auto* mask = reinterpret_cast<std::uint64_t*>(payload.data());
+    auto* entries = reinterpret_cast<StoredEntry*>(payload.data() + MASK_WORDS * sizeof(std::uint64_t));
+
+    table.forEach([&](const State& s, const QEntry& e) {
+        int i = stateIndex(s);
+        mask[i / 64] |= std::uint64_t{1} << (i % 64);
+        entries[i] = StoredEntry{{e.q[0], e.q[1]}, {e.visits[0], e.visits[1]}};
+    });
+
+    FileHeader h{};
+    std::memcpy(h.magic, MAGIC, sizeof(MAGIC));
+    h.version      = FORMAT_VERSION;
+    h.byteOrder    = BYTE_ORDER_MARK;
+    h.headerBytes  = sizeof(FileHeader);
+    h.agentType    = static_cast<std::uint32_t>(meta.agent);
+    h.stateCount   = STATE_COUNT;
+    h.minPlayerSum = MIN_STATE_PLAYER_SUM;
+    h.maxPlayerSum = MAX_STATE_PLAYER_SUM;
+    h.minUpcard    = MIN_STATE_UPCARD;
+    h.maxUpcard    = MAX_STATE_UPCARD;
+    h.entryBytes   = sizeof(StoredEntry);
+    h.maskWords    = MASK_WORDS;
+    h.episodes     = meta.episodes;
+    h.epsilon      = meta.epsilon;
+    h.totalReward  = meta.totalReward;
+    h.checksum     = fnv1a(payload.data(), payload.size());
+
+    return writeAtomically(path, [&](std::ostream& out) {
+        out.write(reinterpret_cast<const char*>(&h), sizeof(h));
+        out.write(reinterpret_cast<const char*>(payload.data()),
+                  static_cast<std::streamsize>(payload.size()));
+        return static_cast<bool>(out);
+    });
+}
+
+bool load(const std::string& path, AgentType expected, Meta& meta,
+          StateTable<QEntry>& table, std::string& error) {
+    MappedFile file(path);
+    if (!file.ok()) { error = "cannot open " + path; return false; }
+    if (file.size() < sizeof(FileHeader)) { error = "file too short"; return false; }
+
+    FileHeader h;
+    std::memcpy(&h, file.data(), sizeof(h));
+    if (std::memcmp(h.magic, MAGIC, sizeof(MAGIC)) != 0) { error = "not a binary Q-table"; return false; }
+    if (h.version != FORMAT_VERSION) { error = "unsupported format version " + std::to_string(h.version); return false; }
+    if (h.byteOrder != BYTE_ORDER_MARK) { error = "written with a different byte order"; return false; }
+    if (h.headerBytes != sizeof(FileHeader) || h.stateCount != STATE_COUNT ||
+        h.minPlayerSum != MIN_STATE_PLAYER_SUM || h.maxPlayerSum != MAX_STATE_PLAYER_SUM ||
+        h.minUpcard != MIN_STATE_UPCARD || h.maxUpcard != MAX_STATE_UPCARD ||
+        h.entryBytes != sizeof(StoredEntry) || h.maskWords != MASK_WORDS) {
+        error = "state-space layout does not match this build";
+        return false;
+    }
+    if (h.agentType != static_cast<std::uint32_t>(expected)) { error = "table belongs to a different agent"; return false; }
+    if (file.size() != sizeof(FileHeader) + PAYLOAD_BYTES) { error = "file size does not match its header"; return false; }
+
+    const unsigned char* payload = file.data() + sizeof(FileHeader);
+    if (fnv1a(payload, PAYLOAD_BYTES) != h.checksum) { error = "checksum mismatch"; return false; }
+
+    // memcpy out of the mapping: it carries no alignment guarantee for doubles.
+    std::uint64_t mask[MASK_WORDS];
+    std::memcpy(mask, payload, sizeof(mask));
+    const unsigned char* records = payload + sizeof(mask);
+
+    table.clear();
+    for (int i = 0; i < STATE_COUNT; ++i) {
+        if (!((mask[i / 64] >> (i % 64)) & 1u)) continue;
+        StoredEntry e;
+        std::memcpy(&e, records + static_cast<std::size_t>(i) * sizeof(StoredEntry), sizeof(e));
+        QEntry& dst = table[stateAt(i)];
+        dst.q = {e.q[0], e.q[1]};
+        dst.visits = {e.visits[0], e.visits[1]};
+    }
+
+    meta.agent       = expected;
+    meta.episodes    = h.episodes;
+    meta.epsilon     = h.epsilon;
+    meta.totalReward = h.totalReward;
+    return true;
+}
+
+} // namespace tablefile
@@ -8,20 +8,41 @@
 
 #include "../../include/api/Api.h"
 #include "Json.h"
+#include "Binary.h"
+#include "HandStore.h"
 
+#include "../../include/core/ActorLearner.h"
+#include "../../include/core/AppendLog.h"
+#include "../../include/core/BroadcastRing.h"
 #include "../../include/core/Game.h"
 #include "../../include/core/HandSession.h"
+#include "../../include/core/Metrics.h"
+#include "../../include/core/Profile.h"
+#include "../../include/core/Random.h"
 #include "../../include/core/Rules.h"
+#include "../../include/core/TaskPool.h"
 #include "../../include/ai/QLearningAI.h"
 #include "../../include/ai/MonteCarloAI.h"
+#include "../../include/ai/OptimalAI.h"
+#include "../../include/ai/TableFile.h"
 
 #include <algorithm>
+#include <atomic>
+#include <bitset>
+#include <charconv>
+#include <chrono>
 #include <cmath>
-#include <fstream>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iomanip>
+#include <iterator>
 #include <map>
 #include <memory>
 #include <mutex>
+#include <random>
 #include <shared_mutex>
+#include <sstream>
 #include <string>
 #include <vector>
 
@@ -44,38 +65,151 @@ constexpr double MC_EPSILON_DECAY = 0.9995;    // MonteCarloAI::decayEpsilon def
 // to train it should not restart exploration from scratch.
 constexpr double EPSILON_AFTER_LOAD = 0.05;
 
-constexpr int MIN_PLAYER_SUM = 4;
-constexpr int MAX_PLAYER_SUM = 21;
-constexpr int MIN_UPCARD     = 2;
-constexpr int MAX_UPCARD     = 11;
+constexpr int MIN_PLAYER_SUM = MIN_STATE_PLAYER_SUM;
+constexpr int MAX_PLAYER_SUM = MAX_STATE_PLAYER_SUM;
+constexpr int MIN_UPCARD     = MIN_STATE_UPCARD;
+constexpr int MAX_UPCARD     = MAX_STATE_UPCARD;
 
 constexpr int MAX_SIMULATE_GAMES = 500000;
+constexpr int SIMULATE_TASK_GAMES = 5000;   // games per parallel evaluation task
+constexpr int MAX_BATCH_HANDS    = 10000;    // per /api/hands/batch response
+constexpr int MAX_DECIDE_STATES  = 4096;     // per /api/decide request
 constexpr int MAX_TRAIN_EPISODES = 5000000;
-constexpr int MAX_OPEN_HANDS     = 200;
 constexpr int PROGRESS_POINTS    = 200;
 
+// Training republishes the agent's reader view this often, in episodes, unless
+// /api/train says otherwise (publish=). A 360-state copy costs a few
+// microseconds, so this trades nothing measurable for freshness.
+constexpr long long DEFAULT_PUBLISH_EPISODES = 2000;
+
+// Training events kept for /api/train/events readers: a job emits at most
+// PROGRESS_POINTS + 4, so this holds the last few jobs whole.
+constexpr std::size_t TRAIN_EVENT_CAPACITY = 1024;
+
+// Training jobs. Running jobs share the workers in proportion to priority;
+// among queued jobs for one agent, higher priority goes first.
+constexpr int MIN_PRIORITY      = 1;
+constexpr int MAX_PRIORITY      = 10;
+constexpr int DEFAULT_PRIORITY  = 5;
+constexpr int MAX_ACTIVE_JOBS   = 32;   // queued or running
+constexpr int MAX_FINISHED_JOBS = 16;   // kept for their progress series
+
+// Seeds the server picks itself are cut to 53 bits, so a JavaScript client
+// can hand one back as seed= without losing it.
+std::uint64_t drawSeed(rng::Domain d) {
+    return rng::nextSeed(d) >> 11;
+}
+
+// Streams under a job's seed.
+constexpr std::uint64_t JOB_EXPLORE = 0;   // the agent's exploration, serial mode
+constexpr std::uint64_t JOB_SHOE    = 1;   // the job's shoe, serial mode
+constexpr std::uint64_t JOB_SLICES  = 2;   // parallel slices, keyed by first episode
+
+// ---------------------------------------------------------------------------
+// Metrics shared by the agents and the basic-strategy baseline
+// ---------------------------------------------------------------------------
+
+metrics::Counter& simulatedGamesFor(const std::string& agent) {
+    return metrics::Registry::global().counter(
+        "blackjack_simulate_games_total", "Games played by /api/simulate and /api/compare.",
+        {{"agent", agent}});
+}
+
+metrics::Histogram& simulateSecondsFor(const std::string& agent) {
+    return metrics::Registry::global().histogram(
+        "blackjack_simulate_seconds", "Time to play one simulation, in seconds.",
+        metrics::latencyBuckets(), {{"agent", agent}});
+}
+
+metrics::Histogram& tableSecondsFor(const std::string& agent, const std::string& op) {
+    return metrics::Registry::global().histogram(
+        "blackjack_table_io_seconds", "Time to save or load an agent's table, in seconds.",
+        metrics::latencyBuckets(), {{"agent", agent}, {"op", op}});
+}
+
 // ---------------------------------------------------------------------------
 // Agent handles
 //
 // QLearningAI and MonteCarloAI share an identical const inference surface
-// (getBestAction / getQValue) but have no common base class, so these thin
-// adapters unify them for the API. Neither AI class is modified.
+// (getBestAction / getQValue) but have no common base class, so these
+// adapters unify them for the API. What only the server needs -- the lock, the
+// published view, metrics and the parallel-training hooks -- lives here
+// rather than in the AI classes.
 // ---------------------------------------------------------------------------
 
+// An agent as request handlers see it: a copy of the table and the counters
+// the summaries report, taken under the agent lock and then never modified.
+// publish() swaps a new one in whole (read-copy-update), so a reader loads one
+// pointer and never touches Agent::mu: a request costs the same whether or not
+// a trainer holds the lock, and the trainer never waits for a reader. Readers
+// holding an old view keep it alive until they are done.
+//
+// A view is also the cache key for everything serialized from it: the policy
+// grid, the CSV export and the status summary are built by the first request
+// that needs them and reused until the next publication replaces the view.
+struct Published {
+    PolicySnapshot policy;              // policy.version = publication number
+    std::bitset<STATE_COUNT> learned;   // Agent::hasLearned, state by state
+    int episodes = 0;
+    double epsilon = 0.0;
+    bool tableLoaded = false;
+
+    struct Cached {
+        std::once_flag once;
+        std::string text;
+    };
+    mutable Cached policyJson, policyColumns, policyBinary, csv, summaryJson;
+
+    template <typename Build>
+    const std::string& cached(Cached& c, Build build) const {
+        std::call_once(c.once, [&] { c.text = build(); });
+        return c.text;
+    }
+
+    Action best(const State& s) const { return policy.best(s); }
+    double qValue(const State& s, Action a) const { return policy.qValue(s, a); }
+    int visitCount(const State& s, Action a) const { return policy.visitCount(s, a); }
+    bool hasLearned(const State& s) const {
+        return inStateSpace(s) && learned.test(stateIndex(s));
+    }
+    int learnedStateCount() const { return static_cast<int>(learned.count()); }
+};
+
 struct Agent {
-    // Reads (policy, simulate, save) take a shared lock; training and
-    // reset/load take it exclusively. In the single-threaded WebAssembly build
-    // these are uncontended no-ops.
-    mutable std::shared_mutex mu;
+    // Guards the live table. Training and reset/load take it exclusively;
+    // save and the trainer's own progress reads take it shared. Request
+    // handlers read view() instead. In the single-threaded WebAssembly build
+    // these are uncontended no-ops. Waits and holds go to /api/metrics.
+    mutable metrics::TimedSharedMutex mu;
     std::string id;
     std::string label;
-    std::string tablePath;
+    std::string tablePath;   // binary table (see TableFile.h)
+    std::string csvPath;     // CSV fallback when there is no binary table yet
     double epsilon;
     bool tableLoaded = false;
-
-    Agent(std::string id_, std::string label_, std::string path_, double eps)
+    // Set by /api/reset while it replaces the table; the scheduler claims no
+    // job for the agent meanwhile. Guarded by gSchedMu.
+    bool resetting = false;
+
+    // This agent's series in /api/metrics.
+    metrics::Counter& trainedEpisodes;
+    metrics::Counter& simulatedGames;
+    metrics::Histogram& simulateSeconds;
+    metrics::Histogram& saveSeconds;
+    metrics::Histogram& loadSeconds;
+
+    Agent(std::string id_, std::string label_, std::string path_, std::string csv_, double eps)
         : id(std::move(id_)), label(std::move(label_)),
-          tablePath(std::move(path_)), epsilon(eps) {}
+          tablePath(std::move(path_)), csvPath(std::move(csv_)), epsilon(eps),
+          trainedEpisodes(metrics::Registry::global().counter(
+              "blackjack_training_episodes_total", "Training episodes run.", {{"agent", id}})),
+          simulatedGames(simulatedGamesFor(id)),
+          simulateSeconds(simulateSecondsFor(id)),
+          saveSeconds(tableSecondsFor(id, "save")),
+          loadSeconds(tableSecondsFor(id, "load")) {
+        mu.instrument(metrics::Registry::global(), "blackjack_agent_lock_wait_seconds",
+                      "blackjack_agent_lock_hold_seconds", {{"agent", id}});
+    }
     virtual ~Agent() = default;
 
     virtual Action best(const State&) const = 0;
@@ -84,7 +218,14 @@ struct Agent {
     virtual bool hasLearned(const State&) const = 0;
     virtual int episodes() const = 0;
 
-    virtual void save() const = 0;
+    // The format follows the extension: ".csv" exports CSV, anything else is
+    // the binary table.
+    virtual void saveTo(const std::string& path) const = 0;
+    void save() const {
+        auto start = std::chrono::steady_clock::now();
+        saveTo(tablePath);
+        saveSeconds.observe(metrics::secondsSince(start));
+    }
     virtual void load() = 0;
     virtual void reset() = 0;
     virtual void setEpsilon(double e) = 0;
@@ -94,6 +235,62 @@ struct Agent {
     virtual double runEpisode(Game& game, bool training) = 0;
     virtual void afterTrainingEpisode(double reward) = 0;
 
+    // Restarts exploration from `seed`. Caller holds mu.
+    virtual void reseed(std::uint64_t) {}
+
+    // Multi-threaded training for agents that support it. Runs without
+    // holding mu -- the workers share the table lock-free -- and takes it only
+    // to fold the results back. Stops within an episode once `stop` is set;
+    // the tally says how many ran. Every hand dealt and every exploration
+    // draw comes from `seed`. Returns false, having run nothing, otherwise.
+    virtual bool trainParallel(long long, unsigned, int, std::uint64_t, const std::atomic<bool>*,
+                               EpisodeTally&) { return false; }
+
+    // Actor/learner training (see ActorLearner.h) through `pipeline`, which is
+    // built on the first call and kept by the caller for the rest of the job.
+    // The learner takes mu per batch of updates, so readers wait at most one
+    // batch. Returns false, having run nothing, where the pipeline is
+    // unavailable.
+    virtual bool trainActorLearner(std::unique_ptr<ActorLearner>&, long long, unsigned, int,
+                                   std::uint64_t, const std::atomic<bool>*, PipelineStats&) {
+        return false;
+    }
+
+    // False for agents whose table is computed rather than learned.
+    virtual bool trainable() const { return true; }
+
+    // A copy of the table for Published. Caller holds mu.
+    virtual PolicySnapshot snapshot() const = 0;
+
+    // Replaces the reader view with the table as it is now. Caller holds mu.
+    void publish() {
+        PROFILE_SCOPE(Publish);
+        auto view = std::make_shared<Published>();
+        view->policy = snapshot();
+        view->policy.version = publications.fetch_add(1) + 1;
+        for (int i = 0; i < STATE_COUNT; ++i) {
+            if (hasLearned(stateAt(i))) view->learned.set(i);
+        }
+        view->episodes = episodes();
+        view->epsilon = epsilon;
+        view->tableLoaded = tableLoaded;
+        std::atomic_store(&published, std::shared_ptr<const Published>(std::move(view)));
+    }
+
+    // The latest published view. The first call publishes one, so an agent
+    // that is never trained (or is solved lazily) still has a view.
+    std::shared_ptr<const Published> view() const {
+        std::shared_ptr<const Published> v = std::atomic_load(&published);
+        if (v) return v;
+        std::unique_lock<metrics::TimedSharedMutex> lk(mu);
+        v = std::atomic_load(&published);
+        if (!v) {
+            const_cast<Agent*>(this)->publish();
+            v = std::atomic_load(&published);
+        }
+        return v;
+    }
+
     int learnedStateCount() const {
         int count = 0;
         for (int sum = MIN_PLAYER_SUM; sum <= MAX_PLAYER_SUM; ++sum) {
@@ -105,12 +302,16 @@ struct Agent {
         }
         return count;
     }
+
+private:
+    std::shared_ptr<const Published> published;   // std::atomic_load/store only
+    std::atomic<std::uint64_t> publications{0};
 };
 
 struct QAgent : Agent {
     QLearningAI ai{Q_ALPHA, Q_GAMMA, Q_EPSILON_START};
 
-    QAgent() : Agent("q", "Q-Learning", "data/q_table.csv", Q_EPSILON_START) {}
+    QAgent() : Agent("q", "Q-Learning", "data/q_table.bin", "data/q_table.csv", Q_EPSILON_START) {}
 
     Action best(const State& s) const override { return ai.getBestAction(s); }
     double qValue(const State& s, Action a) const override { return ai.getQValue(s, a); }
@@ -121,14 +322,16 @@ struct QAgent : Agent {
     }
 
     int episodes() const override { return ai.getEpisodeCount(); }
+    PolicySnapshot snapshot() const override { return ai.snapshot(); }
 
-    void save() const override { ai.saveQTable(tablePath); }
+    void saveTo(const std::string& path) const override { ai.saveQTable(path); }
     void load() override {
-        ai.loadQTable(tablePath);
+        ai.loadQTable(tablefile::preferBinary(tablePath, csvPath));
         if (learnedStateCount() > 0) {
             tableLoaded = true;
-            epsilon = EPSILON_AFTER_LOAD;
-            ai.setEpsilon(EPSILON_AFTER_LOAD);
+            // A binary table carries its own schedule; a CSV only the values.
+            if (ai.getEpisodeCount() == 0) ai.setEpsilon(EPSILON_AFTER_LOAD);
+            epsilon = ai.getEpsilon();
         }
     }
     void reset() override {
@@ -137,6 +340,7 @@ struct QAgent : Agent {
         tableLoaded = false;
     }
     void setEpsilon(double e) override { epsilon = e; ai.setEpsilon(e); }
+    void reseed(std::uint64_t seed) override { ai.reseed(seed); }
 
     double runEpisode(Game& game, bool training) override {
         return game.playAIEpisode(ai, training);
@@ -148,12 +352,43 @@ struct QAgent : Agent {
         // drifts to zero while the agent is still exploring at 5%.
         epsilon = std::max(Q_EPSILON_FLOOR, epsilon * Q_EPSILON_DECAY);
     }
+
+    bool trainParallel(long long episodes, unsigned threads, int decks, std::uint64_t seed,
+                       const std::atomic<bool>* stop, EpisodeTally& out) override {
+        out = Game::runParallelAIEpisodes(ai, episodes, threads, Q_EPSILON_DECAY, seed, decks,
+                                          stop);
+        std::unique_lock<metrics::TimedSharedMutex> lk(mu);
+        ai.recordEpisodes(static_cast<int>(out.episodes), out.reward);
+        ai.setEpsilon(ai.epsilonAfter(out.episodes, Q_EPSILON_DECAY));
+        epsilon = ai.getEpsilon();
+        return true;
+    }
+
+    bool trainActorLearner(std::unique_ptr<ActorLearner>& pipeline, long long episodes,
+                           unsigned actors, int decks, std::uint64_t seed,
+                           const std::atomic<bool>* stop, PipelineStats& out) override {
+        if (!ActorLearner::supported()) return false;
+        if (!pipeline) {
+            ActorLearner::Config cfg;
+            cfg.actors = actors;
+            cfg.decks = decks;
+            cfg.seed = seed;
+            cfg.agentLock = &mu;
+            cfg.stop = stop;
+            pipeline = std::make_unique<ActorLearner>(ai, Q_EPSILON_DECAY, cfg);
+        }
+        out = pipeline->run(episodes);
+        std::unique_lock<metrics::TimedSharedMutex> lk(mu);
+        epsilon = ai.getEpsilon();
+        return true;
+    }
 };
 
 struct MCAgent : Agent {
     MonteCarloAI ai{MC_EPSILON_START, MC_GAMMA};
 
-    MCAgent() : Agent("mc", "Monte Carlo", "data/mc_q_table.csv", MC_EPSILON_START) {}
+    MCAgent() : Agent("mc", "Monte Carlo", "data/mc_q_table.bin",
+                         "data/mc_q_table.csv", MC_EPSILON_START) {}
 
     Action best(const State& s) const override { return ai.getBestAction(s); }
     double qValue(const State& s, Action a) const override { return ai.getQValue(s, a); }
@@ -164,14 +399,16 @@ struct MCAgent : Agent {
     }
 
     int episodes() const override { return ai.getEpisodeCount(); }
+    PolicySnapshot snapshot() const override { return ai.snapshot(); }
 
-    void save() const override { ai.saveQTable(tablePath); }
+    void saveTo(const std::string& path) const override { ai.saveQTable(path); }
     void load() override {
-        ai.loadQTable(tablePath);
+        ai.loadQTable(tablefile::preferBinary(tablePath, csvPath));
         if (learnedStateCount() > 0) {
             tableLoaded = true;
-            epsilon = EPSILON_AFTER_LOAD;
-            ai.setEpsilon(EPSILON_AFTER_LOAD);
+            // A binary table carries its own schedule; a CSV only the values.
+            if (ai.getEpisodeCount() == 0) ai.setEpsilon(EPSILON_AFTER_LOAD);
+            epsilon = ai.getEpsilon();
         }
     }
     void reset() override {
@@ -180,6 +417,7 @@ struct MCAgent : Agent {
         tableLoaded = false;
     }
     void setEpsilon(double e) override { epsilon = e; ai.setEpsilon(e); }
+    void reseed(std::uint64_t seed) override { ai.reseed(seed); }
 
     double runEpisode(Game& game, bool training) override {
         return game.playMonteCarloEpisode(ai, training);
@@ -188,13 +426,97 @@ struct MCAgent : Agent {
         ai.decayEpsilon(MC_EPSILON_DECAY);
         epsilon = std::max(MC_EPSILON_FLOOR, epsilon * MC_EPSILON_DECAY);
     }
+
+    bool trainActorLearner(std::unique_ptr<ActorLearner>& pipeline, long long episodes,
+                           unsigned actors, int decks, std::uint64_t seed,
+                           const std::atomic<bool>* stop, PipelineStats& out) override {
+        if (!ActorLearner::supported()) return false;
+        if (!pipeline) {
+            ActorLearner::Config cfg;
+            cfg.actors = actors;
+            cfg.decks = decks;
+            cfg.seed = seed;
+            cfg.agentLock = &mu;
+            cfg.stop = stop;
+            pipeline = std::make_unique<ActorLearner>(ai, MC_EPSILON_DECAY, cfg);
+        }
+        out = pipeline->run(episodes);
+        std::unique_lock<metrics::TimedSharedMutex> lk(mu);
+        epsilon = ai.getEpsilon();
+        return true;
+    }
+};
+
+// Solved policies by deck count (OptimalAI::INFINITE_DECK included). A solve
+// is a fraction of a second for a finite shoe, so each is done once, on first
+// use, and shared.
+std::shared_ptr<const OptimalAI> optimalFor(int decks) {
+    static std::mutex mu;
+    static std::map<int, std::shared_ptr<const OptimalAI>> solved;
+    std::lock_guard<std::mutex> lk(mu);
+    auto& slot = solved[decks];
+    if (!slot) slot = std::make_shared<const OptimalAI>(decks);
+    return slot;
+}
+
+// The exact solution for the server's shoe, as a third agent: the ground truth
+// the learners are measured against. Nothing to train, load or reset.
+struct OptimalAgent : Agent {
+    OptimalAgent()
+        : Agent("optimal", "Optimal (exact)", "data/optimal_q_table.bin",
+                "data/optimal_q_table.csv", 0.0) {}
+
+    const OptimalAI& solver() const {
+        std::call_once(once, [this] { ai = optimalFor(Shoe::DEFAULT_DECKS); });
+        return *ai;
+    }
+
+    Action best(const State& s) const override { return solver().getBestAction(s); }
+    double qValue(const State& s, Action a) const override { return solver().getQValue(s, a); }
+    int visitCount(const State&, Action) const override { return 0; }
+    bool hasLearned(const State& s) const override { return solver().hasValue(s); }
+    int episodes() const override { return 0; }
+
+    PolicySnapshot snapshot() const override {
+        const OptimalAI& o = solver();
+        PolicySnapshot snap;
+        for (int i = 0; i < STATE_COUNT; ++i) {
+            State s = stateAt(i);
+            if (!o.hasValue(s)) continue;
+            snap.learned.set(i);
+            snap.q[i] = {o.getQValue(s, Action::HIT), o.getQValue(s, Action::STAND)};
+        }
+        return snap;
+    }
+
+    void saveTo(const std::string& path) const override { solver().saveQTable(path); }
+    void load() override {}
+    void reset() override {}
+    void setEpsilon(double) override {}
+    bool trainable() const override { return false; }
+
+    // Greedy play only; there is nothing to learn from the hand.
+    double runEpisode(Game& game, bool) override {
+        const OptimalAI& o = solver();
+        HandSession h(game.getShoe());
+        while (h.playerCanAct() && o.getBestAction(h.state()) == Action::HIT) h.hit();
+        if (!h.finished()) h.stand();
+        return h.reward();
+    }
+    void afterTrainingEpisode(double) override {}
+
+private:
+    mutable std::once_flag once;
+    mutable std::shared_ptr<const OptimalAI> ai;
 };
 
-QAgent  gQ;
-MCAgent gMC;
+QAgent       gQ;
+MCAgent      gMC;
+OptimalAgent gOpt;
 
 Agent* agentFor(const std::string& id) {
     if (id == "mc") return &gMC;
+    if (id == "optimal") return &gOpt;
     if (id == "q" || id.empty()) return &gQ;
     return nullptr;
 }
@@ -209,46 +531,183 @@ struct ProgressPoint {
     double avgReward;    // over the rolling window
     double epsilon;
     int statesLearned;
+    // Actor/learner runs only (zero otherwise), averaged over the window.
+    double queueDepth;   // episodes waiting in the queue for the learner
+    double actorLag;     // episodes learned since the policy the actors played
 };
 
+// serial: one episode at a time under the agent lock. hogwild: Q-learning
+// workers share the table lock-free (Game::runParallelAIEpisodes).
+// actor-learner: actor threads play, one learner applies (ActorLearner).
+enum class TrainMode { Serial, Hogwild, ActorLearner };
+
+const char* trainModeName(TrainMode m) {
+    switch (m) {
+        case TrainMode::Serial:       return "serial";
+        case TrainMode::Hogwild:      return "hogwild";
+        case TrainMode::ActorLearner: return "actor-learner";
+    }
+    return "serial";
+}
+
+// queued: waiting for its agent (one job trains an agent at a time) or for a
+// worker. running: has started, and takes turns with the other running jobs.
+enum class JobState { Queued, Running, Finished, Cancelled };
+
+const char* jobStateName(JobState s) {
+    switch (s) {
+        case JobState::Queued:    return "queued";
+        case JobState::Running:   return "running";
+        case JobState::Finished:  return "finished";
+        case JobState::Cancelled: return "cancelled";
+    }
+    return "queued";
+}
+
+bool isActive(JobState s) { return s == JobState::Queued || s == JobState::Running; }
+
 struct TrainingJob {
-    std::mutex mu;
-    bool running = false;
-    bool cancel = false;
+    // Fixed when the job is submitted, before any other thread can see it.
+    int id = 0;
     std::string agentId;
     Agent* agent = nullptr;
-    long long done = 0;
     long long total = 0;
     long long chunk = 1;
-    std::vector<ProgressPoint> points;
+    int decks = Shoe::DEFAULT_DECKS;
+    long long publishEvery = DEFAULT_PUBLISH_EPISODES;
+    bool resetFirst = false;   // applied when the job starts, not when it queues
+    bool setEpsilon = false;
+    double epsilon = 0.0;
+    std::uint64_t seed = 0;         // every hand and exploration draw derives from it
+    std::uint64_t firstEvent = 0;   // its "queued" event in gEvents
+
+    // What readers see, all lock-free: /api/status, /api/train/progress and
+    // the job list never wait for a slice. A job's last point is appended
+    // before its state leaves Running (release), so a reader that loads the
+    // state first and sees the job ended also sees every point.
+    std::atomic<JobState> state{JobState::Queued};   // changed under gSchedMu
+    std::atomic<int> priority{DEFAULT_PRIORITY};     // changed under gSchedMu
+    std::atomic<double> runSeconds{0.0};             // changed under gSchedMu
+    std::atomic<long long> done{0};
+    std::atomic<TrainMode> mode{TrainMode::Serial};
+    std::atomic<unsigned> threads{1};   // hogwild workers, or actor-learner actors
+    AppendLog<ProgressPoint> points;
+
+    // Set by /api/train/stop; the trainer checks it between episodes.
+    std::atomic<bool> cancel{false};
+
+    // Scheduler bookkeeping, guarded by gSchedMu.
+    double vtime = 0.0;        // run seconds, divided by priority
+    bool claimed = false;      // a worker is running a slice of it
+
+    // Trainer state, touched only by the worker that has claimed the job.
+    // Claims change hands under gSchedMu, so each worker sees the last one's
+    // writes.
+    long long sincePublish = 0;   // episodes trained since the agent last published
     std::unique_ptr<Game> game;
+    // Actor/learner jobs: the actors, parked between slices, until the job ends.
+    std::unique_ptr<ActorLearner> pipeline;
+    // Phase timings (and the trace, if asked for) for the whole job. Reported
+    // once the job has ended; see Profile.h.
+    profile::Recorder profile;
 
     // Rolling window since the last progress point.
     long long wins = 0, losses = 0, pushes = 0;
     double reward = 0.0;
+    // Episode-weighted sums from actor/learner slices.
+    double queueDepthSum = 0.0, actorLagSum = 0.0;
+    long long pipelineEpisodes = 0;
+
+    void resetWindow() {
+        wins = losses = pushes = 0;
+        reward = 0.0;
+        queueDepthSum = actorLagSum = 0.0;
+        pipelineEpisodes = 0;
+    }
+};
 
-    void resetWindow() { wins = losses = pushes = 0; reward = 0.0; }
+// Every job by id: the active ones and the last MAX_FINISHED_JOBS finished.
+// Workers claim a job here and hand it back after a slice; gSchedMu is never
+// held while training. Readers use gJobList, a copy of the map's values
+// republished (read-copy-update, as agents publish their tables) whenever a
+// job is added or dropped, so they never take gSchedMu either.
+using JobList = std::vector<std::shared_ptr<TrainingJob>>;
+
+std::mutex gSchedMu;
+std::map<int, std::shared_ptr<TrainingJob>> gJobs;
+int gNextJobId = 1;
+std::shared_ptr<const JobList> gJobList = std::make_shared<const JobList>();   // atomic_load/store only
+
+// Caller holds gSchedMu.
+void publishJobs() {
+    auto list = std::make_shared<JobList>();
+    list->reserve(gJobs.size());
+    for (const auto& entry : gJobs) list->push_back(entry.second);
+    std::atomic_store(&gJobList, std::shared_ptr<const JobList>(std::move(list)));
+}
+
+std::shared_ptr<const JobList> jobList() { return std::atomic_load(&gJobList); }
+
+// Job lifecycle and progress as a stream, for /api/train/events. Several
+// workers may push at once, so they take turns on gEventsMu -- the ring's
+// single producer is whoever holds it -- but readers never take a lock, and a
+// slow one cannot hold a trainer up: it just falls behind and is told so.
+enum class TrainEventKind : std::uint8_t { Queued, Start, Progress, Finish, Cancel };
+
+struct TrainEvent {
+    TrainEventKind kind;
+    char agent[8];
+    int job;
+    int priority;
+    TrainMode mode;
+    unsigned threads;
+    long long done, total, chunk, publishEvery;
+    ProgressPoint point;   // Progress only
 };
 
-TrainingJob gJob;
+BroadcastRing<TrainEvent> gEvents(TRAIN_EVENT_CAPACITY);
+std::mutex gEventsMu;
+
+std::uint64_t pushEvent(const TrainingJob& job, TrainEventKind kind, int priority,
+                        const ProgressPoint* point = nullptr) {
+    TrainEvent e{};
+    e.kind = kind;
+    std::memcpy(e.agent, job.agentId.data(), std::min(job.agentId.size(), sizeof(e.agent) - 1));
+    e.job          = job.id;
+    e.priority     = priority;
+    e.mode         = job.mode.load(std::memory_order_relaxed);
+    e.threads      = job.threads.load(std::memory_order_relaxed);
+    e.done         = job.done.load(std::memory_order_relaxed);
+    e.total        = job.total;
+    e.chunk        = job.chunk;
+    e.publishEvery = job.publishEvery;
+    if (point) e.point = *point;
+    std::lock_guard<std::mutex> lk(gEventsMu);
+    return gEvents.push(e);
+}
 
-void emitPoint() {
-    long long n = gJob.wins + gJob.losses + gJob.pushes;
+// Trainer only.
+void emitPoint(TrainingJob& job, int priority) {
+    long long n = job.wins + job.losses + job.pushes;
     int learned;
     {
-        std::shared_lock<std::shared_mutex> lk(gJob.agent->mu);
-        learned = gJob.agent->learnedStateCount();
+        std::shared_lock<metrics::TimedSharedMutex> lk(job.agent->mu);
+        learned = job.agent->learnedStateCount();
     }
     ProgressPoint p;
-    p.episode       = gJob.done;
-    p.winRate       = (gJob.wins + gJob.losses) > 0
-                          ? static_cast<double>(gJob.wins) / (gJob.wins + gJob.losses)
+    p.episode       = job.done.load(std::memory_order_relaxed);
+    p.winRate       = (job.wins + job.losses) > 0
+                          ? static_cast<double>(job.wins) / (job.wins + job.losses)
                           : 0.0;
-    p.avgReward     = n > 0 ? gJob.reward / static_cast<double>(n) : 0.0;
-    p.epsilon       = gJob.agent->epsilon;
+    p.avgReward     = n > 0 ? job.reward / static_cast<double>(n) : 0.0;
+    p.epsilon       = job.agent->epsilon;
     p.statesLearned = learned;
-    gJob.points.push_back(p);
-    gJob.resetWindow();
+    double pe = static_cast<double>(job.pipelineEpisodes);
+    p.queueDepth    = pe > 0 ? job.queueDepthSum / pe : 0.0;
+    p.actorLag      = pe > 0 ? job.actorLagSum / pe : 0.0;
+    job.points.push(p);   // room for 4096; a job makes at most 2 * PROGRESS_POINTS
+    job.resetWindow();
+    pushEvent(job, TrainEventKind::Progress, priority, &p);
 }
 
 // ---------------------------------------------------------------------------
@@ -284,26 +743,24 @@ const char* suitName(Suit s) {
     return "?";
 }
 
-std::string cardJson(const Card& c) {
-    return json::Writer()
-        .kv("rank", rankName(c.getRank()))
-        .kv("suit", suitName(c.getSuit()))
-        .kv("value", c.getValue())
-        .done();
-}
-
-std::string handJson(const std::vector<Card>& hand) {
-    json::Writer w(true);
-    for (const Card& c : hand) w.raw(cardJson(c));
-    return w.done();
+void writeHand(json::Writer& w, const char* key, const std::vector<Card>& hand) {
+    w.karr(key);
+    for (const Card& c : hand) {
+        w.obj()
+            .kv("rank", rankName(c.getRank()))
+            .kv("suit", suitName(c.getSuit()))
+            .kv("value", c.getValue())
+            .end();
+    }
+    w.end();
 }
 
-std::string stateJson(const State& s) {
-    return json::Writer()
+void writeState(json::Writer& w, const char* key, const State& s) {
+    w.kobj(key)
         .kv("playerSum", s.playerSum)
         .kv("dealerUpcard", s.dealerUpcard)
         .kv("usableAce", s.usableAce)
-        .done();
+        .end();
 }
 
 const char* outcomeFor(const HandSession& h) {
@@ -316,14 +773,29 @@ const char* outcomeFor(const HandSession& h) {
     return "push";
 }
 
-// Full snapshot of a hand. The dealer's *second* card is withheld until the
-// hand settles: the agent's state conditions on dealerHand[0], so that is the
-// card shown face up.
-std::string handJsonFull(int id, const HandSession& h, const Agent& agent) {
-    json::Writer w;
-    w.kv("handId", id);
-    w.kv("agent", agent.id);
+// One decision as the policy sees it, into the object `w` has open.
+void writeDecisionFields(json::Writer& w, const Published& view, const State& s) {
+    double qHit   = view.qValue(s, Action::HIT);
+    double qStand = view.qValue(s, Action::STAND);
+    w.kv("action", view.best(s) == Action::HIT ? "hit" : "stand")
+     .kv("qHit", qHit)
+     .kv("qStand", qStand)
+     .kv("margin", qHit - qStand)
+     // Unlearned states fall back to a fixed "hit below 17" heuristic
+     // inside both agents -- worth surfacing rather than hiding.
+     .kv("learned", view.hasLearned(s));
+}
 
+// The same as a keyed member, for a hand snapshot or an autoplay step.
+void writeDecision(json::Writer& w, const char* key, const Published& view, const State& s) {
+    writeDecisionFields(w.kobj(key), view, s);
+    w.end();
+}
+
+// Full snapshot of a hand, into an open object. The dealer's *second* card is
+// withheld until the hand settles: the agent's state conditions on
+// dealerHand[0], so that is the card shown face up.
+void writeHandSnapshot(json::Writer& w, const HandSession& h, const Published& view) {
     std::vector<Card> dealerVisible;
     const auto& dh = h.dealerHand();
     if (h.finished()) {
@@ -331,8 +803,8 @@ std::string handJsonFull(int id, const HandSession& h, const Agent& agent) {
     } else if (!dh.empty()) {
         dealerVisible.push_back(dh[0]);
     }
-    w.kraw("playerHand", handJson(h.playerHand()));
-    w.kraw("dealerHand", handJson(dealerVisible));
+    writeHand(w, "playerHand", h.playerHand());
+    writeHand(w, "dealerHand", dealerVisible);
     w.kv("dealerHiddenCards", static_cast<int>(dh.size() - dealerVisible.size()));
     w.kv("playerValue", h.playerValue());
     w.kv("dealerValue", h.finished() ? h.dealerValue() : (dh.empty() ? 0 : dh[0].getValue()));
@@ -347,43 +819,224 @@ std::string handJsonFull(int id, const HandSession& h, const Agent& agent) {
     }
 
     State s = h.state();
-    w.kraw("state", stateJson(s));
-
-    double qHit, qStand;
-    Action rec;
-    bool learned;
-    {
-        std::shared_lock<std::shared_mutex> lk(agent.mu);
-        qHit    = agent.qValue(s, Action::HIT);
-        qStand  = agent.qValue(s, Action::STAND);
-        rec     = agent.best(s);
-        learned = agent.hasLearned(s);
-    }
-    w.kraw("policy", json::Writer()
-        .kv("action", rec == Action::HIT ? "hit" : "stand")
-        .kv("qHit", qHit)
-        .kv("qStand", qStand)
-        .kv("margin", qHit - qStand)
-        // Unlearned states fall back to a fixed "hit below 17" heuristic
-        // inside both agents -- worth surfacing rather than hiding.
-        .kv("learned", learned)
-        .done());
+    writeState(w, "state", s);
+    writeDecision(w, "policy", view, s);
+}
 
+std::string handJsonFull(long long id, const HandSession& h, const Agent& agent) {
+    static json::SizeHint hint;
+    json::Writer w(hint);
+    w.kv("handId", id);
+    w.kv("agent", agent.id);
+    writeHandSnapshot(w, h, *agent.view());
     return w.done();
 }
 
+// Plays a dealt hand out greedily from one published view, as simulate() and
+// the autoplay endpoints do: hit while the policy says so and the player can,
+// then stand. `decided` sees each state and the action chosen for it, before
+// the action is applied.
+template <typename Decided>
+void playOut(HandSession& h, const Published& view, Decided&& decided) {
+    while (h.playerCanAct()) {
+        State s = h.state();
+        Action a = view.best(s);
+        decided(s, a);
+        if (a == Action::STAND) break;
+        h.hit();
+    }
+    if (!h.finished()) h.stand();
+}
+
+// As of the agent's last publication, like every other read.
 std::string agentSummaryJson(const Agent& a) {
-    std::shared_lock<std::shared_mutex> lk(a.mu);
-    return json::Writer()
-        .kv("id", a.id)
-        .kv("label", a.label)
-        .kv("episodes", a.episodes())
-        .kv("statesLearned", a.learnedStateCount())
-        .kv("statesPossible", (MAX_PLAYER_SUM - MIN_PLAYER_SUM + 1) * (MAX_UPCARD - MIN_UPCARD + 1) * 2)
-        .kv("epsilon", a.epsilon)
-        .kv("tableLoaded", a.tableLoaded)
-        .kv("tablePath", a.tablePath)
-        .done();
+    std::shared_ptr<const Published> view = a.view();
+    return view->cached(view->summaryJson, [&] {
+        return json::Writer()
+            .kv("id", a.id)
+            .kv("label", a.label)
+            .kv("episodes", view->episodes)
+            .kv("statesLearned", view->learnedStateCount())
+            .kv("statesPossible", (MAX_PLAYER_SUM - MIN_PLAYER_SUM + 1) * (MAX_UPCARD - MIN_UPCARD + 1) * 2)
+            .kv("epsilon", view->epsilon)
+            .kv("tableLoaded", view->tableLoaded)
+            .kv("tablePath", a.tablePath)
+            .kv("policyVersion", static_cast<long long>(view->policy.version))
+            .done();
+    });
+}
+
+// The full grid behind GET /api/policy.
+std::string policyJson(const Agent& agent, const Published& view) {
+    static json::SizeHint hint;
+    json::Writer w(hint);
+    w.kv("agent", agent.id)
+     .kv("label", agent.label)
+     .kv("version", static_cast<long long>(view.policy.version))
+     .karr("cells");
+    for (int sum = MIN_PLAYER_SUM; sum <= MAX_PLAYER_SUM; ++sum) {
+        for (int up = MIN_UPCARD; up <= MAX_UPCARD; ++up) {
+            for (int ace = 0; ace <= 1; ++ace) {
+                State s{sum, up, ace != 0};
+                double qh = view.qValue(s, Action::HIT);
+                double qs = view.qValue(s, Action::STAND);
+                int visits = view.visitCount(s, Action::HIT)
+                           + view.visitCount(s, Action::STAND);
+                w.obj()
+                    .kv("playerSum", sum)
+                    .kv("dealerUpcard", up)
+                    .kv("usableAce", ace != 0)
+                    .kv("action", view.best(s) == Action::HIT ? "hit" : "stand")
+                    .kv("basic", rules::basicStrategy(s) == Action::HIT ? "hit" : "stand")
+                    .kv("qHit", qh)
+                    .kv("qStand", qs)
+                    .kv("margin", qh - qs)
+                    .kv("learned", view.hasLearned(s))
+                    .kv("visits", visits)
+                    .end();
+            }
+        }
+    }
+    return w.done();
+}
+
+// format= on /api/policy and /api/train/progress. Rows is the original array
+// of objects. Columns carries the same data as parallel arrays, so no key name
+// is repeated per cell or point. Binary is a packed little-endian layout
+// (below) for clients that poll hard enough for parse time to matter.
+enum class Format { Rows, Columns, Binary };
+
+bool parseFormat(const std::string& s, Format& out) {
+    if (s.empty() || s == "json") out = Format::Rows;
+    else if (s == "columns")      out = Format::Columns;
+    else if (s == "binary")       out = Format::Binary;
+    else return false;
+    return true;
+}
+
+constexpr std::uint16_t BINARY_FORMAT_VERSION = 1;
+
+// The grid as parallel arrays, in the rows' order -- which is stateIndex
+// order. Flags are 0/1, and margin is left to the client (qHit - qStand).
+std::string policyColumnsJson(const Agent& agent, const Published& view) {
+    static json::SizeHint hint;
+    json::Writer w(hint);
+    w.kv("agent", agent.id)
+     .kv("label", agent.label)
+     .kv("version", static_cast<long long>(view.policy.version))
+     .kv("format", "columns")
+     .kv("count", STATE_COUNT);
+    auto column = [&](const char* key, auto value) {
+        w.karr(key);
+        for (int i = 0; i < STATE_COUNT; ++i) value(stateAt(i));
+        w.end();
+    };
+    column("playerSum",    [&](const State& s) { w.i(s.playerSum); });
+    column("dealerUpcard", [&](const State& s) { w.i(s.dealerUpcard); });
+    column("usableAce",    [&](const State& s) { w.i(s.usableAce ? 1 : 0); });
+    column("hit",          [&](const State& s) { w.i(view.best(s) == Action::HIT ? 1 : 0); });
+    column("basicHit",     [&](const State& s) { w.i(rules::basicStrategy(s) == Action::HIT ? 1 : 0); });
+    column("qHit",         [&](const State& s) { w.n(view.qValue(s, Action::HIT)); });
+    column("qStand",       [&](const State& s) { w.n(view.qValue(s, Action::STAND)); });
+    column("learned",      [&](const State& s) { w.i(view.hasLearned(s) ? 1 : 0); });
+    column("visits",       [&](const State& s) {
+        w.i(view.visitCount(s, Action::HIT) + view.visitCount(s, Action::STAND));
+    });
+    return w.done();
+}
+
+// Binary policy grid, N = 360 cells in stateIndex order:
+//
+//   0        4   magic "BJPG"
+//   4        2   format version (1)
+//   6        2   header bytes (24)
+//   8        4   N
+//   12       4   reserved
+//   16       8   policy version
+//   24       8N  qHit, f64
+//   24+8N    8N  qStand, f64
+//   24+16N   4N  visits (HIT + STAND), u32
+//   24+20N   N   playerSum, u8
+//   24+21N   N   dealerUpcard, u8
+//   24+22N   N   flags, u8: 1 usableAce, 2 action is hit, 4 basic is hit, 8 learned
+//
+// Every column starts on a multiple of its element size, so a Float64Array or
+// Uint32Array can be laid over the buffer without copying.
+std::string policyBinary(const Published& view) {
+    binary::Writer w(24 + 23 * STATE_COUNT);
+    w.bytes("BJPG", 4)
+     .u16(BINARY_FORMAT_VERSION)
+     .u16(24)
+     .u32(STATE_COUNT)
+     .u32(0)
+     .u64(view.policy.version);
+    for (int i = 0; i < STATE_COUNT; ++i) w.f64(view.qValue(stateAt(i), Action::HIT));
+    for (int i = 0; i < STATE_COUNT; ++i) w.f64(view.qValue(stateAt(i), Action::STAND));
+    for (int i = 0; i < STATE_COUNT; ++i) {
+        State s = stateAt(i);
+        w.u32(static_cast<std::uint32_t>(view.visitCount(s, Action::HIT) +
+                                         view.visitCount(s, Action::STAND)));
+    }
+    for (int i = 0; i < STATE_COUNT; ++i) w.u8(static_cast<std::uint8_t>(stateAt(i).playerSum));
+    for (int i = 0; i < STATE_COUNT; ++i) w.u8(static_cast<std::uint8_t>(stateAt(i).dealerUpcard));
+    for (int i = 0; i < STATE_COUNT; ++i) {
+        State s = stateAt(i);
+        w.u8(static_cast<std::uint8_t>((s.usableAce ? 1 : 0) |
+                                       (view.best(s) == Action::HIT ? 2 : 0) |
+                                       (rules::basicStrategy(s) == Action::HIT ? 4 : 0) |
+                                       (view.hasLearned(s) ? 8 : 0)));
+    }
+    return w.done();
+}
+
+// The published table in the agents' CSV layout (see QLearningAI::saveQTable).
+std::string csvOf(const PolicySnapshot& policy) {
+    std::ostringstream out;
+    out << "playerSum,dealerUpcard,usableAce,action,qValue,visitCount\n";
+    for (int i = 0; i < STATE_COUNT; ++i) {
+        if (!policy.learned.test(i)) continue;
+        State s = stateAt(i);
+        for (int a = 0; a < 2; ++a) {
+            out << s.playerSum << "," << s.dealerUpcard << "," << s.usableAce << ","
+                << a << "," << std::fixed << std::setprecision(6) << policy.q[i][a] << ","
+                << policy.visits[i][a] << "\n";
+        }
+    }
+    return out.str();
+}
+
+// Versions restart at 1 with the process, so the ETag also names the process:
+// a validator from before a restart must not match a different table.
+const std::string& instanceTag() {
+    static const std::string tag = [] {
+        std::ostringstream out;
+        out << std::hex << std::random_device{}();
+        return out.str();
+    }();
+    return tag;
+}
+
+std::string etagFor(const Agent& agent, const Published& view, const char* kind) {
+    return "\"" + agent.id + "-" + kind + "-" + instanceTag() + "-" +
+           std::to_string(view.policy.version) + "\"";
+}
+
+// If-None-Match is "*" or a comma-separated list of (possibly weak) tags.
+bool etagMatches(const std::string& ifNoneMatch, const std::string& etag) {
+    std::size_t pos = 0;
+    while (pos < ifNoneMatch.size()) {
+        std::size_t end = ifNoneMatch.find(',', pos);
+        if (end == std::string::npos) end = ifNoneMatch.size();
+        std::size_t b = ifNoneMatch.find_first_not_of(" \t", pos);
+        std::size_t e = ifNoneMatch.find_last_not_of(" \t", end - 1);
+        if (b != std::string::npos && b < end && e != std::string::npos && e >= b) {
+            std::string tag = ifNoneMatch.substr(b, e - b + 1);
+            if (tag.compare(0, 2, "W/") == 0) tag.erase(0, 2);
+            if (tag == "*" || tag == etag) return true;
+        }
+        pos = end + 1;
+    }
+    return false;
 }
 
 // ---------------------------------------------------------------------------
@@ -403,7 +1056,14 @@ struct Tally {
         else            ++pushes;
     }
 
-    std::string json(const std::string& id, const std::string& label, int games) const {
+    void merge(const Tally& o) {
+        wins += o.wins; losses += o.losses; pushes += o.pushes; blackjacks += o.blackjacks;
+        total += o.total;
+        totalSq += o.totalSq;
+    }
+
+    std::string json(const std::string& id, const std::string& label, int games,
+                     std::uint64_t seed) const {
         int decided = wins + losses;
         double ev = games > 0 ? total / games : 0.0;
         // Standard error on the mean reward: the demo compares policies whose
@@ -424,45 +1084,342 @@ struct Tally {
             // Win rate excludes pushes, matching Game::evaluateAI's reporting.
             .kv("winRate", decided > 0 ? static_cast<double>(wins) / decided : 0.0)
             .kv("winRateAllHands", games > 0 ? static_cast<double>(wins) / games : 0.0)
+            .kv("seed", static_cast<long long>(seed))
             .done();
     }
 };
 
-std::string simulate(Agent& agent, int games) {
-    Game game(0);   // 0 players: Game's constructor reads names from stdin otherwise
-    Tally t;
-    {
-        std::shared_lock<std::shared_mutex> lk(agent.mu);
+struct SimOptions {
+    int games = 0;
+    int decks = Shoe::DEFAULT_DECKS;
+    std::uint64_t seed = 0;
+    unsigned threads = 0;      // 0 = the whole shared pool
+};
+
+// Splits an evaluation into fixed-size tasks on the shared pool. Tasks, not
+// threads, are the unit of determinism: each plays its games on its own shoe
+// seeded from (seed, task index), and the per-task tallies are merged in task
+// order, so one seed reproduces the same result at any thread count.
+Tally runTasks(const SimOptions& o,
+               const std::function<Tally(std::uint64_t seed, int games)>& task) {
+    std::size_t tasks = (static_cast<std::size_t>(o.games) + SIMULATE_TASK_GAMES - 1) / SIMULATE_TASK_GAMES;
+    std::vector<Tally> parts(tasks);
+    TaskPool::shared().parallelFor(tasks, [&](std::size_t i) {
+        int n = std::min<int>(SIMULATE_TASK_GAMES, o.games - static_cast<int>(i) * SIMULATE_TASK_GAMES);
+        parts[i] = task(rng::derive(o.seed, i), n);
+    }, o.threads);
+
+    Tally total;
+    for (const Tally& p : parts) total.merge(p);
+    return total;
+}
+
+// Greedy play from one published view: every worker reads the same immutable
+// table, and training carries on (and republishes) underneath. HandSession
+// deals exactly as Game::playAIEpisode does, so a seed replays the same hands.
+std::string simulate(const Agent& agent, const SimOptions& o) {
+    auto start = std::chrono::steady_clock::now();
+    std::shared_ptr<const Published> view = agent.view();
+    Tally t = runTasks(o, [&](std::uint64_t seed, int games) {
+        Shoe shoe(o.decks);
+        shoe.reseed(seed);
+        Tally part;
         for (int i = 0; i < games; ++i) {
-            t.add(agent.runEpisode(game, false));
+            HandSession h(shoe);
+            playOut(h, *view, [](const State&, Action) {});
+            part.add(h.reward());
         }
-    }
-    return t.json(agent.id, agent.label, games);
+        return part;
+    });
+    agent.simulatedGames.add(static_cast<std::uint64_t>(o.games));
+    agent.simulateSeconds.observe(metrics::secondsSince(start));
+    return t.json(agent.id, agent.label, o.games, o.seed);
 }
 
 // The fixed benchmark: no Q-table, no learning, just published basic strategy
 // played through the same HandSession the demo deals from.
-std::string simulateBasic(int games) {
-    Tally t;
-    for (int i = 0; i < games; ++i) {
-        HandSession h;
-        while (h.playerCanAct()) {
-            if (rules::basicStrategy(h.state()) == Action::STAND) break;
-            h.hit();
+std::string simulateBasic(const SimOptions& o) {
+    static metrics::Counter& games = simulatedGamesFor("basic");
+    static metrics::Histogram& seconds = simulateSecondsFor("basic");
+    auto start = std::chrono::steady_clock::now();
+    Tally t = runTasks(o, [&](std::uint64_t seed, int games) {
+        Shoe shoe(o.decks);
+        shoe.reseed(seed);
+        Tally part;
+        for (int i = 0; i < games; ++i) {
+            HandSession h(shoe);
+            while (h.playerCanAct()) {
+                if (rules::basicStrategy(h.state()) == Action::STAND) break;
+                h.hit();
+            }
+            if (!h.finished()) h.stand();
+            part.add(h.reward());
         }
-        if (!h.finished()) h.stand();
-        t.add(h.reward());
+        return part;
+    });
+    games.add(static_cast<std::uint64_t>(o.games));
+    seconds.observe(metrics::secondsSince(start));
+    return t.json("basic", "Basic strategy", o.games, o.seed);
+}
+
+// Exact counterpart of simulate(): the policy's expected return on a fresh
+// `decks` shoe, from the solver's model rather than sampled hands.
+double exactReturn(const Agent& agent, int decks) {
+    std::shared_ptr<const OptimalAI> o = optimalFor(decks);
+    std::shared_ptr<const Published> view = agent.view();
+    return o->expectedReturn([&](const State& s) { return view->best(s); });
+}
+
+std::string exactJson(const std::string& id, const std::string& label, double ev) {
+    return json::Writer()
+        .kv("agent", id)
+        .kv("label", label)
+        .kv("avgReward", ev)
+        .kv("exact", true)
+        .done();
+}
+
+// ---------------------------------------------------------------------------
+// Decisions
+// ---------------------------------------------------------------------------
+
+// Parses /api/decide's states=: comma-separated playerSum:dealerUpcard:usableAce
+// triples, e.g. "16:10:0,13:2:1" (an ace upcard is 11). Every state must lie in
+// the learned state space. On failure, `error` says which entry and why.
+bool parseStates(const std::string& text, std::vector<State>& out, std::string& error) {
+    const char* p = text.data();
+    const char* end = p + text.size();
+    while (p < end) {
+        if (out.size() == static_cast<std::size_t>(MAX_DECIDE_STATES)) {
+            error = "at most " + std::to_string(MAX_DECIDE_STATES) + " states per request";
+            return false;
+        }
+        int v[3];
+        bool ok = true;
+        for (int k = 0; k < 3 && ok; ++k) {
+            auto res = std::from_chars(p, end, v[k]);
+            ok = res.ec == std::errc() && (k == 2 || (res.ptr < end && *res.ptr == ':'));
+            p = ok && k < 2 ? res.ptr + 1 : res.ptr;
+        }
+        State s{v[0], v[1], v[2] != 0};
+        if (!ok || (v[2] != 0 && v[2] != 1) || (p < end && *p != ',')) {
+            error = "state " + std::to_string(out.size()) + " is not playerSum:dealerUpcard:usableAce";
+            return false;
+        }
+        if (!inStateSpace(s)) {
+            error = "state " + std::to_string(out.size()) + " is outside the state space";
+            return false;
+        }
+        out.push_back(s);
+        if (p < end && ++p == end) {   // the comma, which needs an entry after it
+            error = "state " + std::to_string(out.size()) + " is not playerSum:dealerUpcard:usableAce";
+            return false;
+        }
+    }
+    if (out.empty()) error = "states is required";
+    return !out.empty();
+}
+
+std::string decideJson(const Agent& agent, const Published& view, const std::vector<State>& states,
+                       Format format) {
+    static json::SizeHint hint;
+    json::Writer w(hint);
+    w.kv("agent", agent.id)
+     .kv("version", static_cast<long long>(view.policy.version))
+     .kv("count", static_cast<long long>(states.size()));
+    if (format == Format::Columns) {
+        w.kv("format", "columns");
+        auto column = [&](const char* key, auto value) {
+            w.karr(key);
+            for (const State& s : states) value(s);
+            w.end();
+        };
+        column("hit",     [&](const State& s) { w.i(view.best(s) == Action::HIT ? 1 : 0); });
+        column("qHit",    [&](const State& s) { w.n(view.qValue(s, Action::HIT)); });
+        column("qStand",  [&](const State& s) { w.n(view.qValue(s, Action::STAND)); });
+        column("learned", [&](const State& s) { w.i(view.hasLearned(s) ? 1 : 0); });
+    } else {
+        w.karr("decisions");
+        for (const State& s : states) {
+            writeDecisionFields(w.obj(), view, s);
+            w.end();
+        }
+        w.end();
+    }
+    return w.done();
+}
+
+// Binary decisions, N states in request order:
+//
+//   0        4   magic "BJDC"
+//   4        2   format version (1)
+//   6        2   header bytes (24)
+//   8        4   N
+//   12       4   reserved
+//   16       8   policy version
+//   24       8N  qHit, f64
+//   24+8N    8N  qStand, f64
+//   24+16N   N   flags, u8: 1 action is hit, 2 learned
+std::string decideBinary(const Published& view, const std::vector<State>& states) {
+    std::size_t n = states.size();
+    binary::Writer w(24 + 17 * n);
+    w.bytes("BJDC", 4)
+     .u16(BINARY_FORMAT_VERSION)
+     .u16(24)
+     .u32(static_cast<std::uint32_t>(n))
+     .u32(0)
+     .u64(view.policy.version);
+    for (const State& s : states) w.f64(view.qValue(s, Action::HIT));
+    for (const State& s : states) w.f64(view.qValue(s, Action::STAND));
+    for (const State& s : states) {
+        w.u8(static_cast<std::uint8_t>((view.best(s) == Action::HIT ? 1 : 0) |
+                                       (view.hasLearned(s) ? 2 : 0)));
     }
-    return t.json("basic", "Basic strategy", games);
+    return w.done();
+}
+
+// The packed protocol behind decidePacked(). All integers little-endian.
+//
+// Request:
+//   0        1   protocol version (1)
+//   1        1   agent: 0 q, 1 mc, 2 optimal
+//   2        2   N, at most MAX_DECIDE_STATES
+//   4        2N  stateIndex(s), u16: (playerSum - 4) * 20 + (dealerUpcard - 2) * 2 + usableAce
+//
+// Response:
+//   0        1   protocol version (1)
+//   1        1   status (DecideStatus)
+//   2        2   N (0 unless status is Ok)
+//   4        4   reserved
+//   8        8   policy version
+//   16       4N  qHit, f32
+//   16+4N    4N  qStand, f32
+//   16+8N    N   flags, u8: 1 action is hit, 2 learned
+enum class DecideStatus : std::uint8_t { Ok, Malformed, UnknownAgent, BadState, UnknownVersion };
+
+constexpr std::uint8_t DECIDE_PROTOCOL_VERSION = 1;
+constexpr std::size_t DECIDE_REQUEST_HEADER = 4;
+
+// ---------------------------------------------------------------------------
+// Server-side play
+// ---------------------------------------------------------------------------
+
+// One hand, dealt from a fresh shoe seeded with `seed` and played out with the
+// agent's policy: the deal, every decision with its Q-values and the card a
+// hit drew, then the settled hand -- what a client would otherwise assemble
+// from /api/hand/new and a /api/hand/step per decision.
+std::string autoplayJson(const Agent& agent, int decks, std::uint64_t seed) {
+    std::shared_ptr<const Published> view = agent.view();
+    Shoe shoe(decks);
+    shoe.reseed(seed);
+    HandSession h(shoe);
+    Card upcard = h.dealerHand()[0];
+
+    std::vector<std::pair<State, Action>> decisions;
+    playOut(h, *view, [&](const State& s, Action a) { decisions.emplace_back(s, a); });
+
+    static json::SizeHint hint;
+    json::Writer w(hint);
+    w.kv("agent", agent.id)
+     .kv("version", static_cast<long long>(view->policy.version))
+     .kv("seed", static_cast<long long>(seed))
+     .kv("decks", decks);
+    writeHand(w, "dealt", {h.playerHand()[0], h.playerHand()[1]});
+    writeHand(w, "dealerUpcard", {upcard});
+    w.karr("steps");
+    for (std::size_t i = 0; i < decisions.size(); ++i) {
+        w.obj();
+        writeState(w, "state", decisions[i].first);
+        writeDecision(w, "policy", *view, decisions[i].first);
+        if (decisions[i].second == Action::HIT) {
+            // Hit number i drew the player's card 2 + i.
+            writeHand(w, "drew", {h.playerHand()[2 + i]});
+        }
+        w.end();
+    }
+    w.end().kobj("final");
+    writeHandSnapshot(w, h, *view);
+    w.end();
+    return w.done();
+}
+
+// A card in two characters: rank (T for ten) then suit, e.g. "Th", "As".
+void appendCards(std::string& out, const std::vector<Card>& cards) {
+    static const char ranks[] = "??23456789TJQKA";
+    static const char suits[] = "hdcs";
+    for (const Card& c : cards) {
+        out += ranks[static_cast<int>(c.getRank())];
+        out += suits[static_cast<int>(c.getSuit())];
+    }
+}
+
+struct HandRecord {
+    std::string player, dealer;   // appendCards codes
+    std::string actions;          // one letter per decision: H or S
+    const char* outcome;
+    double reward;
+};
+
+// N hands played out server-side, one compact record each, for bots and load
+// generators that want outcomes rather than a round trip per decision. Dealt
+// exactly as simulate() deals -- same task split, same per-task shoe seeds --
+// so a batch and a simulation with the same seed, decks and count play the
+// same hands, and the summary is that simulation's result.
+std::string batchJson(const Agent& agent, const SimOptions& o) {
+    std::shared_ptr<const Published> view = agent.view();
+    std::size_t tasks = (static_cast<std::size_t>(o.games) + SIMULATE_TASK_GAMES - 1) / SIMULATE_TASK_GAMES;
+    std::vector<std::vector<HandRecord>> parts(tasks);
+    std::vector<Tally> tallies(tasks);
+    TaskPool::shared().parallelFor(tasks, [&](std::size_t i) {
+        int n = std::min<int>(SIMULATE_TASK_GAMES, o.games - static_cast<int>(i) * SIMULATE_TASK_GAMES);
+        Shoe shoe(o.decks);
+        shoe.reseed(rng::derive(o.seed, i));
+        parts[i].reserve(static_cast<std::size_t>(n));
+        for (int g = 0; g < n; ++g) {
+            HandSession h(shoe);
+            HandRecord r;
+            playOut(h, *view, [&](const State&, Action a) {
+                r.actions += (a == Action::HIT) ? 'H' : 'S';
+            });
+            appendCards(r.player, h.playerHand());
+            appendCards(r.dealer, h.dealerHand());
+            r.outcome = outcomeFor(h);
+            r.reward = h.reward();
+            tallies[i].add(r.reward);
+            parts[i].push_back(std::move(r));
+        }
+    }, o.threads);
+
+    Tally total;
+    for (const Tally& t : tallies) total.merge(t);
+
+    static json::SizeHint hint;
+    json::Writer w(hint);
+    w.kv("agent", agent.id)
+     .kv("version", static_cast<long long>(view->policy.version))
+     .kv("decks", o.decks)
+     .kraw("summary", total.json(agent.id, agent.label, o.games, o.seed))
+     .karr("hands");
+    for (const auto& part : parts) {
+        for (const HandRecord& r : part) {
+            w.obj()
+                .kv("player", r.player)
+                .kv("dealer", r.dealer)
+                .kv("actions", r.actions)
+                .kv("outcome", r.outcome)
+                .kv("reward", r.reward)
+                .end();
+        }
+    }
+    w.end();
+    return w.done();
 }
 
 // ---------------------------------------------------------------------------
 // Hand sessions
 // ---------------------------------------------------------------------------
 
-std::mutex gHandsMu;
-std::map<int, std::unique_ptr<HandSession>> gHands;
-int gNextHandId = 1;
+HandStore gHands;   // sized by setHandLimits(); see HandStore.h
 
 // ---------------------------------------------------------------------------
 // Param helpers
@@ -483,10 +1440,31 @@ long long paramInt(const Params& p, const std::string& key, long long fallback)
     }
 }
 
-Response json_(const std::string& body, int status = 200) {
+// Shoe size for simulate/train/compare.
+int paramDecks(const Params& p) {
+    return static_cast<int>(std::max<long long>(Shoe::MIN_DECKS,
+        std::min<long long>(Shoe::MAX_DECKS, paramInt(p, "decks", Shoe::DEFAULT_DECKS))));
+}
+
+// games=, decks=, seed= and threads= for simulate/compare. Without a seed the
+// next one under the master seed is taken and reported back, so any run can
+// be replayed exactly.
+SimOptions simOptions(const Params& p, long long defaultGames) {
+    SimOptions o;
+    o.games = static_cast<int>(std::max<long long>(1,
+        std::min<long long>(MAX_SIMULATE_GAMES, paramInt(p, "games", defaultGames))));
+    o.decks = paramDecks(p);
+    o.seed = p.count("seed") ? static_cast<std::uint64_t>(paramInt(p, "seed", 0))
+                             : drawSeed(rng::Domain::Simulate);
+    o.threads = static_cast<unsigned>(std::max<long long>(0,
+        std::min<long long>(TaskPool::shared().concurrency(), paramInt(p, "threads", 0))));
+    return o;
+}
+
+Response json_(std::string body, int status = 200) {
     Response r;
     r.status = status;
-    r.body = body;
+    r.body = std::move(body);
     return r;
 }
 
@@ -494,82 +1472,622 @@ Response error_(const std::string& message, int status) {
     return json_(json::error(message), status);
 }
 
-} // namespace
+// The job named by job=, or the newest when there is none. Null if job=
+// names no job we still have; with no jobs at all and no job=, an empty
+// finished job stands in, so pollers need no special case.
+std::shared_ptr<const TrainingJob> findJob(const Params& p) {
+    std::shared_ptr<const JobList> jobs = jobList();
+    if (p.count("job")) {
+        int id = static_cast<int>(paramInt(p, "job", 0));
+        for (const auto& job : *jobs) {
+            if (job->id == id) return job;
+        }
+        return nullptr;
+    }
+    if (jobs->empty()) {
+        static const std::shared_ptr<const TrainingJob> none = [] {
+            auto job = std::make_shared<TrainingJob>();
+            job->state = JobState::Finished;
+            return job;
+        }();
+        return none;
+    }
+    return jobs->back();
+}
+
+// One job as /api/status and /api/train/jobs describe it, into the object `w`
+// has open.
+// Where an ended job's episodes spent their time, phase by phase, in builds
+// with the phase timers (BLACKJACK_PROFILE); nothing otherwise. `state` must
+// have been loaded (acquire) before: the trainer finishes the recorder before
+// it marks the job ended.
+void writePhases(json::Writer& w, const TrainingJob& job, JobState state) {
+    if (!profile::ENABLED || isActive(state)) return;
+    const profile::Recorder& r = job.profile;
+    double episodeNs = static_cast<double>(r.total(profile::Phase::Episode).nanos);
+    w.kobj("phases");
+    for (std::size_t i = 0; i < profile::PHASE_COUNT; ++i) {
+        const profile::PhaseTotal& t = r.totals()[i];
+        if (t.count == 0) continue;
+        w.kobj(profile::name(static_cast<profile::Phase>(i)))
+         .kv("count", t.count)
+         .kv("seconds", static_cast<double>(t.nanos) / 1e9)
+         .kv("meanNs", static_cast<double>(t.nanos) / static_cast<double>(t.count))
+         .kv("share", episodeNs > 0 ? static_cast<double>(t.nanos) / episodeNs : 0.0)
+         .end();
+    }
+    w.end();
+    if (r.tracing()) w.kv("traceEvents", static_cast<long long>(r.traceEvents()));
+}
+
+void writeJob(json::Writer& w, const TrainingJob& job) {
+    JobState state = job.state.load(std::memory_order_acquire);
+    w.kv("job", job.id)
+     .kv("state", jobStateName(state))
+     .kv("running", isActive(state))
+     .kv("agent", job.agentId)
+     .kv("priority", job.priority.load(std::memory_order_relaxed))
+     .kv("done", job.done.load(std::memory_order_relaxed))
+     .kv("total", job.total)
+     .kv("chunk", job.chunk)
+     .kv("mode", trainModeName(job.mode.load(std::memory_order_relaxed)))
+     .kv("threads", static_cast<int>(job.threads.load(std::memory_order_relaxed)))
+     .kv("decks", job.decks)
+     .kv("seed", static_cast<long long>(job.seed))
+     .kv("publishEvery", job.publishEvery)
+     .kv("runSeconds", job.runSeconds.load(std::memory_order_relaxed));
+    writePhases(w, job, state);
+}
+
+// A job's progress as one response reports it: the state first, then the
+// points, so a response that says the job has ended carries all of them.
+struct ProgressView {
+    const TrainingJob& job;
+    JobState state;
+    std::size_t count;   // points [0, count) may be read
+    long long done;
+
+    explicit ProgressView(const TrainingJob& j)
+        : job(j),
+          state(j.state.load(std::memory_order_acquire)),
+          count(j.points.size()),
+          done(j.done.load(std::memory_order_relaxed)) {}
+};
+
+// The fields every progress response opens with.
+void writeProgressHeader(json::Writer& w, const ProgressView& v) {
+    w.kv("job", v.job.id)
+     .kv("state", jobStateName(v.state))
+     .kv("running", isActive(v.state))
+     .kv("agent", v.job.agentId)
+     .kv("done", v.done)
+     .kv("total", v.job.total)
+     .kv("cursor", static_cast<long long>(v.count));
+    writePhases(w, v.job, v.state);
+}
+
+// Progress points from `first` on as parallel arrays.
+std::string progressColumnsJson(const ProgressView& v, std::size_t first) {
+    static json::SizeHint hint;
+    json::Writer w(hint);
+    writeProgressHeader(w, v);
+    w.kv("format", "columns");
+    auto column = [&](const char* key, auto value) {
+        w.karr(key);
+        for (std::size_t i = first; i < v.count; ++i) value(v.job.points[i]);
+        w.end();
+    };
+    column("episode",       [&](const ProgressPoint& p) { w.i(p.episode); });
+    column("winRate",       [&](const ProgressPoint& p) { w.n(p.winRate); });
+    column("avgReward",     [&](const ProgressPoint& p) { w.n(p.avgReward); });
+    column("epsilon",       [&](const ProgressPoint& p) { w.n(p.epsilon); });
+    column("statesLearned", [&](const ProgressPoint& p) { w.i(p.statesLearned); });
+    column("queueDepth",    [&](const ProgressPoint& p) { w.n(p.queueDepth); });
+    column("actorLag",      [&](const ProgressPoint& p) { w.n(p.actorLag); });
+    return w.done();
+}
+
+// Binary progress, N points from `first` on.
+//
+//   0        4   magic "BJTP"
+//   4        2   format version (1)
+//   6        2   flags: 1 running
+//   8        4   N
+//   12       4   cursor (pass back as since=)
+//   16       8   done, u64
+//   24       8   total, u64
+//   32       8   agent id, NUL-padded
+//   40       8N  episode, f64 (exact: episodes stay far below 2^53)
+//   40+8N    8N  winRate, f64
+//   40+16N   8N  avgReward, f64
+//   40+24N   8N  epsilon, f64
+//   40+32N   8N  queueDepth, f64
+//   40+40N   8N  actorLag, f64
+//   40+48N   4N  statesLearned, u32
+Response progressBinary(const ProgressView& v, std::size_t first) {
+    std::size_t n = v.count - first;
+    binary::Writer w(40 + 52 * n);
+    w.bytes("BJTP", 4)
+     .u16(BINARY_FORMAT_VERSION)
+     .u16(isActive(v.state) ? 1 : 0)
+     .u32(static_cast<std::uint32_t>(n))
+     .u32(static_cast<std::uint32_t>(v.count))
+     .u64(static_cast<std::uint64_t>(v.done))
+     .u64(static_cast<std::uint64_t>(v.job.total))
+     .bytes(v.job.agentId, 8);
+    auto column = [&](auto value) {
+        for (std::size_t i = first; i < v.count; ++i) value(v.job.points[i]);
+    };
+    column([&](const ProgressPoint& p) { w.f64(static_cast<double>(p.episode)); });
+    column([&](const ProgressPoint& p) { w.f64(p.winRate); });
+    column([&](const ProgressPoint& p) { w.f64(p.avgReward); });
+    column([&](const ProgressPoint& p) { w.f64(p.epsilon); });
+    column([&](const ProgressPoint& p) { w.f64(p.queueDepth); });
+    column([&](const ProgressPoint& p) { w.f64(p.actorLag); });
+    column([&](const ProgressPoint& p) { w.u32(static_cast<std::uint32_t>(p.statesLearned)); });
+
+    Response r;
+    r.body = w.done();
+    r.contentType = "application/octet-stream";
+    return r;
+}
+
+// One progress point's fields, into the object `w` has open.
+void writePoint(json::Writer& w, const ProgressPoint& p) {
+    w.kv("episode", p.episode)
+     .kv("winRate", p.winRate)
+     .kv("avgReward", p.avgReward)
+     .kv("epsilon", p.epsilon)
+     .kv("statesLearned", p.statesLearned)
+     .kv("queueDepth", p.queueDepth)
+     .kv("actorLag", p.actorLag);
+}
+
+const char* eventName(TrainEventKind k) {
+    switch (k) {
+        case TrainEventKind::Queued:   return "queued";
+        case TrainEventKind::Start:    return "start";
+        case TrainEventKind::Progress: return "progress";
+        case TrainEventKind::Finish:   return "finish";
+        case TrainEventKind::Cancel:   return "cancel";
+    }
+    return "progress";
+}
+
+// One server-sent event. The id is the event's number, so a reconnecting
+// EventSource resumes where it left off through Last-Event-ID.
+void writeEvent(std::string& out, std::uint64_t id, const TrainEvent& e) {
+    json::Writer w;
+    w.kv("job", e.job)
+     .kv("agent", std::string_view(e.agent))
+     .kv("done", e.done)
+     .kv("total", e.total);
+    if (e.kind == TrainEventKind::Queued || e.kind == TrainEventKind::Start) {
+        w.kv("priority", e.priority)
+         .kv("chunk", e.chunk)
+         .kv("mode", trainModeName(e.mode))
+         .kv("threads", static_cast<int>(e.threads))
+         .kv("publishEvery", e.publishEvery);
+    } else if (e.kind == TrainEventKind::Progress) {
+        writePoint(w, e.point);
+    }
+    out += "id: ";
+    json::intInto(out, static_cast<long long>(id));
+    out += "\nevent: ";
+    out += eventName(e.kind);
+    out += "\ndata: ";
+    out += w.done();
+    out += "\n\n";
+}
 
 // ---------------------------------------------------------------------------
-// Training advance (shared by both front ends)
+// Job scheduling
 // ---------------------------------------------------------------------------
 
-long long trainingChunkSize() {
-    std::lock_guard<std::mutex> lk(gJob.mu);
-    return gJob.running ? gJob.chunk : 0;
+// The job a worker should run next, claimed for it, or null if there is
+// nothing to run. Each agent trains one job at a time -- the one it has
+// started, or else its best queued one -- and among those the job with the
+// least virtual time goes first: run seconds divided by priority, so two
+// running jobs at priorities 2 and 1 get two slices to one.
+std::shared_ptr<TrainingJob> claimNext(int& priority) {
+    std::lock_guard<std::mutex> lk(gSchedMu);
+
+    std::map<const Agent*, TrainingJob*> turn;
+    double floor = -1.0;   // least virtual time among running jobs
+    for (const auto& entry : gJobs) {
+        TrainingJob* j = entry.second.get();
+        if (!isActive(j->state)) continue;
+        if (j->state == JobState::Running && (floor < 0.0 || j->vtime < floor)) floor = j->vtime;
+        TrainingJob*& t = turn[j->agent];
+        if (t == nullptr) {
+            t = j;
+        } else if (t->state != JobState::Running &&
+                   (j->state == JobState::Running || j->priority > t->priority)) {
+            t = j;   // ids ascend, so the older of two equal queued jobs stays
+        }
+    }
+
+    TrainingJob* best = nullptr;
+    for (const auto& entry : turn) {
+        TrainingJob* j = entry.second;
+        if (j->claimed || j->agent->resetting) continue;
+        if (best == nullptr || j->vtime < best->vtime ||
+            (j->vtime == best->vtime && j->id < best->id)) {
+            best = j;
+        }
+    }
+    if (best == nullptr) return nullptr;
+
+    if (best->state == JobState::Queued) {
+        // Joins at the running jobs' virtual time, so it neither starves them
+        // nor waits for them to catch up.
+        best->vtime = std::max(best->vtime, floor);
+        best->state.store(JobState::Running, std::memory_order_release);
+    }
+    best->claimed = true;
+    priority = best->priority;
+    return gJobs[best->id];
+}
+
+// Drops the oldest finished jobs beyond MAX_FINISHED_JOBS and republishes
+// the list. Caller holds gSchedMu.
+void pruneFinished() {
+    int finished = 0;
+    for (const auto& entry : gJobs) {
+        if (!isActive(entry.second->state)) ++finished;
+    }
+    for (auto it = gJobs.begin(); it != gJobs.end() && finished > MAX_FINISHED_JOBS;) {
+        if (!isActive(it->second->state)) {
+            it = gJobs.erase(it);
+            --finished;
+        } else {
+            ++it;
+        }
+    }
+    publishJobs();
+}
+
+void release(TrainingJob& job, double seconds, JobState outcome) {
+    std::lock_guard<std::mutex> lk(gSchedMu);
+    job.claimed = false;
+    job.runSeconds.store(job.runSeconds.load(std::memory_order_relaxed) + seconds,
+                         std::memory_order_relaxed);
+    job.vtime += seconds / job.priority.load(std::memory_order_relaxed);
+    if (outcome != JobState::Running) {
+        job.state.store(outcome, std::memory_order_release);
+        pruneFinished();
+    }
 }
 
-void advanceTraining(long long budget) {
-    std::lock_guard<std::mutex> lk(gJob.mu);
-    if (!gJob.running || gJob.agent == nullptr) return;
+// Runs `job` up to its next progress point, or for `budget` episodes if that
+// comes first. Returns the episodes run; `outcome` becomes Finished or
+// Cancelled when the job is over. The caller has claimed the job.
+long long runSlice(TrainingJob& job, int priority, long long budget, JobState& outcome) {
+    if (!job.game) {
+        // First slice: the job's starting settings apply now, not when it
+        // was queued, so they cannot disturb a job still running on the agent.
+        // Exploration restarts from the job's seed either way, so a serial
+        // job from a reset agent replays bit for bit.
+        {
+            std::unique_lock<metrics::TimedSharedMutex> alk(job.agent->mu);
+            if (job.resetFirst) job.agent->reset();
+            if (job.setEpsilon) job.agent->setEpsilon(job.epsilon);
+            job.agent->reseed(rng::derive(job.seed, JOB_EXPLORE));
+            if (job.resetFirst || job.setEpsilon) job.agent->publish();
+        }
+        job.game = std::make_unique<Game>(0, job.decks);
+        job.game->getShoe().reseed(rng::derive(job.seed, JOB_SHOE));
+        pushEvent(job, TrainEventKind::Start, priority);
+    }
+
+    // Only this thread writes done while it holds the claim.
+    long long done = job.done.load(std::memory_order_relaxed);
+    auto advance = [&](long long n) {
+        done += n;
+        job.done.store(done, std::memory_order_relaxed);
+        job.agent->trainedEpisodes.add(static_cast<std::uint64_t>(n));
+    };
+    auto cancelled = [&] { return job.cancel.load(std::memory_order_relaxed); };
 
+    long long stop = std::min(job.total, done + std::min(budget, job.chunk - done % job.chunk));
     long long ran = 0;
-    while (gJob.running && ran < budget && gJob.done < gJob.total) {
-        if (gJob.cancel) break;
+    while (done < stop && !cancelled()) {
+        TrainMode mode = job.mode.load(std::memory_order_relaxed);
+        if (mode != TrainMode::Serial) {
+            // Up to the next progress point at most, so points land where the
+            // serial path would put them, and to the next publication, so
+            // readers see the table at the same cadence in every mode. A
+            // cancel stops the workers within an episode; `t` says how many
+            // they played. An actor/learner job's pipeline persists across
+            // slices and keeps the seed of the slice that built it.
+            long long n = std::min(stop - done, job.publishEvery - job.sincePublish);
+            unsigned threads = job.threads.load(std::memory_order_relaxed);
+            std::uint64_t seed = rng::derive(rng::derive(job.seed, JOB_SLICES),
+                                             static_cast<std::uint64_t>(done));
+            EpisodeTally t;
+            bool ok;
+            if (mode == TrainMode::ActorLearner) {
+                PipelineStats ps;
+                ok = job.agent->trainActorLearner(job.pipeline, n, threads, job.decks, seed,
+                                                  &job.cancel, ps);
+                t = ps.tally;
+                job.queueDepthSum    += ps.meanQueueDepth * static_cast<double>(t.episodes);
+                job.actorLagSum      += ps.meanActorLag * static_cast<double>(t.episodes);
+                job.pipelineEpisodes += t.episodes;
+            } else {
+                ok = job.agent->trainParallel(n, threads, job.decks, seed, &job.cancel, t);
+            }
+            if (ok) {
+                job.reward += t.reward;
+                job.wins   += t.wins;
+                job.losses += t.losses;
+                job.pushes += t.pushes;
+                advance(t.episodes);
+                ran        += t.episodes;
+                job.sincePublish += t.episodes;
+                if (job.sincePublish >= job.publishEvery) {
+                    std::unique_lock<metrics::TimedSharedMutex> alk(job.agent->mu);
+                    job.agent->publish();
+                    job.sincePublish = 0;
+                }
+                if (done % job.chunk == 0 || done == job.total) {
+                    emitPoint(job, priority);
+                }
+                continue;
+            }
+            // Not supported by this agent (or build): train serially.
+            job.mode.store(TrainMode::Serial, std::memory_order_relaxed);
+            job.threads.store(1, std::memory_order_relaxed);
+        }
 
         double r;
         {
-            // Per-episode locking (rather than per-chunk) so that policy and
-            // simulate requests stay responsive while training runs.
-            std::unique_lock<std::shared_mutex> alk(gJob.agent->mu);
-            r = gJob.agent->runEpisode(*gJob.game, true);
-            gJob.agent->afterTrainingEpisode(r);
+            // Per-episode locking (rather than per-slice) so that saves and
+            // resets never wait long; requests read the published view.
+            std::unique_lock<metrics::TimedSharedMutex> alk(job.agent->mu);
+            r = job.agent->runEpisode(*job.game, true);
+            job.agent->afterTrainingEpisode(r);
+            if (++job.sincePublish >= job.publishEvery) {
+                job.agent->publish();
+                job.sincePublish = 0;
+            }
         }
 
-        gJob.reward += r;
-        if (r > 0)      ++gJob.wins;
-        else if (r < 0) ++gJob.losses;
-        else            ++gJob.pushes;
+        job.reward += r;
+        if (r > 0)      ++job.wins;
+        else if (r < 0) ++job.losses;
+        else            ++job.pushes;
 
-        ++gJob.done;
+        advance(1);
         ++ran;
 
-        if (gJob.done % gJob.chunk == 0 || gJob.done == gJob.total) {
-            emitPoint();
+        if (done % job.chunk == 0 || done == job.total) {
+            emitPoint(job, priority);
+        }
+    }
+
+    bool wasCancelled = cancelled() && done < job.total;
+    if (wasCancelled || done >= job.total) {
+        if (job.wins + job.losses + job.pushes > 0) emitPoint(job, priority);
+        {
+            std::unique_lock<metrics::TimedSharedMutex> alk(job.agent->mu);
+            job.agent->publish();
+            job.sincePublish = 0;
         }
+        job.game.reset();
+        job.pipeline.reset();
+        pushEvent(job, wasCancelled ? TrainEventKind::Cancel : TrainEventKind::Finish, priority);
+        outcome = wasCancelled ? JobState::Cancelled : JobState::Finished;
+    }
+    return ran;
+}
+
+// A 304 for a client that already has this version, else the body.
+Response versioned(const std::string& etag, const std::string& ifNoneMatch,
+                   const std::function<std::string()>& body) {
+    Response r;
+    r.etag = etag;
+    if (etagMatches(ifNoneMatch, etag)) {
+        r.status = 304;
+        return r;
+    }
+    r.body = body();
+    return r;
+}
+
+} // namespace
+
+// ---------------------------------------------------------------------------
+// Training advance (shared by both front ends)
+// ---------------------------------------------------------------------------
+
+long long advanceTraining(long long budget) {
+    long long ran = 0;
+    while (ran < budget) {
+        profile::Clock::time_point claiming;
+        if (profile::ENABLED) claiming = profile::Clock::now();
+        int priority = DEFAULT_PRIORITY;
+        std::shared_ptr<TrainingJob> job = claimNext(priority);
+        if (!job) break;
+
+        // Everything the slice runs, on this thread or its workers, is timed
+        // into the job's recorder. Not release(): that may end the job, after
+        // which readers may read the recorder.
+        profile::Attach attach(&job->profile);
+        if (profile::ENABLED) {
+            job->profile.record(profile::Phase::Schedule, claiming, profile::Clock::now());
+        }
+
+        JobState outcome = JobState::Running;
+        auto start = std::chrono::steady_clock::now();
+        ran += runSlice(*job, priority, budget - ran, outcome);
+        std::chrono::duration<double> took = std::chrono::steady_clock::now() - start;
+        release(*job, took.count(), outcome);
+    }
+    return ran;
+}
+
+unsigned maxConcurrentJobs() {
+    // One job per trainable agent.
+    const Agent* agents[] = {&gQ, &gMC, &gOpt};
+    return static_cast<unsigned>(std::count_if(std::begin(agents), std::end(agents),
+                                               [](const Agent* a) { return a->trainable(); }));
+}
+
+std::uint64_t trainingEventsFrom(const std::string& lastEventId) {
+    if (!lastEventId.empty()) {
+        try {
+            return std::min<std::uint64_t>(std::stoull(lastEventId) + 1, gEvents.end());
+        } catch (...) { /* not one of ours: start over */ }
+    }
+    // The oldest job still queued or running, else the newest job.
+    std::shared_ptr<const JobList> jobs = jobList();
+    for (const auto& job : *jobs) {
+        if (isActive(job->state.load(std::memory_order_acquire))) return job->firstEvent;
+    }
+    return jobs->empty() ? gEvents.end() : jobs->back()->firstEvent;
+}
+
+bool readTrainingEvents(std::uint64_t& cursor, std::string& out) {
+    std::size_t before = out.size();
+    TrainEvent e;
+    for (;;) {
+        BroadcastRing<TrainEvent>::Read r = gEvents.read(cursor, e);
+        if (r == BroadcastRing<TrainEvent>::Read::Empty) break;
+        if (r == BroadcastRing<TrainEvent>::Read::Lost) {
+            // Overwritten before this reader got to it. Skip to the present
+            // and say so; the client refetches /api/train/progress for the
+            // history in between.
+            cursor = gEvents.end();
+            out += "event: lagged\ndata: ";
+            out += json::Writer().kv("resume", static_cast<long long>(cursor)).done();
+            out += "\n\n";
+            continue;
+        }
+        writeEvent(out, cursor++, e);
+    }
+    return out.size() != before;
+}
+
+std::size_t maxDecideRequestBytes() {
+    return DECIDE_REQUEST_HEADER + 2 * static_cast<std::size_t>(MAX_DECIDE_STATES);
+}
+
+void decidePacked(std::string_view request, std::string& out) {
+    auto fail = [&](DecideStatus status) {
+        out = binary::Writer(std::move(out), 16)
+            .u8(DECIDE_PROTOCOL_VERSION).u8(static_cast<std::uint8_t>(status))
+            .u16(0).u32(0).u64(0)
+            .done();
+    };
+    if (request.size() < DECIDE_REQUEST_HEADER) return fail(DecideStatus::Malformed);
+    if (static_cast<std::uint8_t>(request[0]) != DECIDE_PROTOCOL_VERSION) {
+        return fail(DecideStatus::UnknownVersion);
+    }
+    Agent* agents[] = {&gQ, &gMC, &gOpt};
+    std::uint8_t agent = static_cast<std::uint8_t>(request[1]);
+    if (agent >= std::size(agents)) return fail(DecideStatus::UnknownAgent);
+    std::size_t n = binary::u16At(request, 2);
+    if (n > static_cast<std::size_t>(MAX_DECIDE_STATES) ||
+        request.size() != DECIDE_REQUEST_HEADER + 2 * n) {
+        return fail(DecideStatus::Malformed);
     }
 
-    if (gJob.cancel || gJob.done >= gJob.total) {
-        if (gJob.wins + gJob.losses + gJob.pushes > 0) emitPoint();
-        gJob.running = false;
-        gJob.game.reset();
+    // The whole batch reads one snapshot.
+    std::shared_ptr<const Published> view = agents[agent]->view();
+    const std::size_t states = request.size();
+    for (std::size_t at = DECIDE_REQUEST_HEADER; at < states; at += 2) {
+        if (binary::u16At(request, at) >= STATE_COUNT) return fail(DecideStatus::BadState);
+    }
+    auto column = [&](auto value) {
+        for (std::size_t at = DECIDE_REQUEST_HEADER; at < states; at += 2) {
+            value(stateAt(binary::u16At(request, at)));
+        }
+    };
+    binary::Writer w(std::move(out), 16 + 9 * n);
+    w.u8(DECIDE_PROTOCOL_VERSION)
+     .u8(static_cast<std::uint8_t>(DecideStatus::Ok))
+     .u16(static_cast<std::uint16_t>(n))
+     .u32(0)
+     .u64(view->policy.version);
+    column([&](const State& s) { w.f32(static_cast<float>(view->qValue(s, Action::HIT))); });
+    column([&](const State& s) { w.f32(static_cast<float>(view->qValue(s, Action::STAND))); });
+    column([&](const State& s) {
+        w.u8(static_cast<std::uint8_t>((view->best(s) == Action::HIT ? 1 : 0) |
+                                       (view->hasLearned(s) ? 2 : 0)));
+    });
+    out = w.done();
+}
+
+void setHandLimits(std::size_t capacity, int idleSeconds) {
+    gHands.configure(capacity > 0 ? capacity : gHands.capacity(),
+                     idleSeconds > 0 ? idleSeconds : gHands.idleSeconds());
+}
+
+void setSeed(std::uint64_t seed) {
+    rng::setMasterSeed(seed);
+    gHands.reseed(rng::seedFor(rng::Domain::Hand, 0));
+    for (Agent* agent : {static_cast<Agent*>(&gQ), static_cast<Agent*>(&gMC)}) {
+        std::unique_lock<metrics::TimedSharedMutex> lk(agent->mu);
+        agent->reseed(rng::nextSeed(rng::Domain::Explore));
     }
 }
 
 void init() {
-    gQ.load();
-    gMC.load();
+    for (Agent* agent : {static_cast<Agent*>(&gQ), static_cast<Agent*>(&gMC)}) {
+        auto start = std::chrono::steady_clock::now();
+        agent->load();
+        agent->loadSeconds.observe(metrics::secondsSince(start));
+    }
+    gQ.publish();
+    gMC.publish();
 }
 
 // ---------------------------------------------------------------------------
 // Routing
 // ---------------------------------------------------------------------------
 
-Response handle(const std::string& path, const Params& params) {
+Response handle(const std::string& path, const Params& params, const std::string& ifNoneMatch) {
     // --- status ----------------------------------------------------------
     if (path == "/api/status") {
-        std::string training;
-        {
-            std::lock_guard<std::mutex> lk(gJob.mu);
-            training = json::Writer()
-                .kv("running", gJob.running)
-                .kv("agent", gJob.agentId)
-                .kv("done", gJob.done)
-                .kv("total", gJob.total)
-                .kv("chunk", gJob.chunk)
-                .done();
+        static json::SizeHint hint;
+        json::Writer w(hint);
+        w.kraw("q", agentSummaryJson(gQ))
+         .kraw("mc", agentSummaryJson(gMC))
+         .kraw("optimal", agentSummaryJson(gOpt));
+        // The newest job, as the single "training" object it always was, then
+        // everything still queued or running.
+        std::shared_ptr<const JobList> jobs = jobList();
+        writeJob(w.kobj("training"), *findJob(Params()));
+        w.end().karr("jobs");
+        for (const auto& job : *jobs) {
+            if (!isActive(job->state.load(std::memory_order_acquire))) continue;
+            writeJob(w.obj(), *job);
+            w.end();
         }
-        return json_(json::Writer()
-            .kraw("q", agentSummaryJson(gQ))
-            .kraw("mc", agentSummaryJson(gMC))
-            .kraw("training", training)
-            .done());
+        w.end().kv("seed", static_cast<long long>(rng::masterSeed()))
+            .kobj("hands")
+            .kv("open", static_cast<long long>(gHands.size()))
+            .kv("capacity", static_cast<long long>(gHands.capacity()))
+            .kv("idleSeconds", gHands.idleSeconds())
+            .end();
+        return json_(w.done());
+    }
+
+    // Everything in the metrics registry, for a Prometheus scraper. Gauges
+    // that are cheaper to read than to keep current are read here.
+    if (path == "/api/metrics") {
+        static metrics::Gauge& open = metrics::Registry::global().gauge(
+            "blackjack_hands_open", "Interactive hands currently open.");
+        static metrics::Gauge& capacity = metrics::Registry::global().gauge(
+            "blackjack_hands_capacity", "Interactive hands that may be open at once.");
+        open.set(static_cast<double>(gHands.size()));
+        capacity.set(static_cast<double>(gHands.capacity()));
+
+        Response r;
+        r.body = metrics::Registry::global().render();
+        r.contentType = "text/plain; version=0.0.4; charset=utf-8";
+        return r;
     }
 
     // --- hand play -------------------------------------------------------
@@ -577,43 +2095,31 @@ Response handle(const std::string& path, const Params& params) {
         Agent* agent = agentFor(param(params, "agent"));
         if (!agent) return error_("unknown agent", 400);
 
-        std::lock_guard<std::mutex> lk(gHandsMu);
-        // Bound memory: this is a demo, old hands are not worth keeping.
-        while (gHands.size() >= MAX_OPEN_HANDS) gHands.erase(gHands.begin());
-
-        int id = gNextHandId++;
-        auto hand = std::make_unique<HandSession>();
-        std::string body = handJsonFull(id, *hand, *agent);
-        gHands.emplace(id, std::move(hand));
-        return json_(body);
+        HandStore::Lease hand = gHands.open();
+        if (!hand) return error_("too many open hands", 503);
+        return json_(handJsonFull(hand.id(), hand.session(), *agent));
     }
 
     if (path == "/api/hand/step") {
         Agent* agent = agentFor(param(params, "agent"));
         if (!agent) return error_("unknown agent", 400);
 
-        int id = static_cast<int>(paramInt(params, "id", 0));
         std::string action = param(params, "action");
 
-        std::lock_guard<std::mutex> lk(gHandsMu);
-        auto it = gHands.find(id);
-        if (it == gHands.end()) return error_("unknown or expired hand", 404);
+        // Only this hand is locked; other hands play on meanwhile.
+        HandStore::Lease hand = gHands.find(paramInt(params, "id", 0));
+        if (!hand) return error_("unknown or expired hand", 404);
 
-        HandSession& hand = *it->second;
-        if (hand.finished()) return json_(handJsonFull(id, hand, *agent));
+        const HandSession& session = hand.session();
+        if (session.finished()) return json_(handJsonFull(hand.id(), session, *agent));
 
         if (action == "auto") {
-            State s = hand.state();
-            Action chosen;
-            {
-                std::shared_lock<std::shared_mutex> alk(agent->mu);
-                chosen = agent->best(s);
-            }
+            Action chosen = agent->view()->best(session.state());
             action = (chosen == Action::HIT) ? "hit" : "stand";
         }
 
         if (action == "hit") {
-            if (!hand.playerCanAct()) return error_("player cannot hit", 409);
+            if (!session.playerCanAct()) return error_("player cannot hit", 409);
             hand.hit();
         } else if (action == "stand") {
             hand.stand();
@@ -621,9 +2127,49 @@ Response handle(const std::string& path, const Params& params) {
             return error_("action must be hit, stand or auto", 400);
         }
 
-        std::string body = handJsonFull(id, hand, *agent);
-        if (hand.finished()) gHands.erase(it);
-        return json_(body);
+        if (session.finished()) hand.close();
+        return json_(handJsonFull(hand.id(), session, *agent));
+    }
+
+    // Recommendations for a batch of states, all from one published copy of
+    // the table. No session, no lock.
+    if (path == "/api/decide") {
+        Agent* agent = agentFor(param(params, "agent"));
+        if (!agent) return error_("unknown agent", 400);
+
+        Format format;
+        if (!parseFormat(param(params, "format"), format)) {
+            return error_("format must be json, columns or binary", 400);
+        }
+        std::vector<State> states;
+        std::string error;
+        if (!parseStates(param(params, "states"), states, error)) return error_(error, 400);
+
+        std::shared_ptr<const Published> view = agent->view();
+        if (format == Format::Binary) {
+            Response r;
+            r.body = decideBinary(*view, states);
+            r.contentType = "application/octet-stream";
+            return r;
+        }
+        return json_(decideJson(*agent, *view, states, format));
+    }
+
+    // Whole hands played server-side; nothing is kept open.
+    if (path == "/api/hand/autoplay") {
+        Agent* agent = agentFor(param(params, "agent"));
+        if (!agent) return error_("unknown agent", 400);
+        SimOptions opt = simOptions(params, 1);
+        return json_(autoplayJson(*agent, opt.decks, opt.seed));
+    }
+
+    if (path == "/api/hands/batch") {
+        Agent* agent = agentFor(param(params, "agent"));
+        if (!agent) return error_("unknown agent", 400);
+        SimOptions opt = simOptions(params, 1);
+        opt.games = static_cast<int>(std::max<long long>(1,
+            std::min<long long>(MAX_BATCH_HANDS, paramInt(params, "hands", 100))));
+        return json_(batchJson(*agent, opt));
     }
 
     // --- policy grid -----------------------------------------------------
@@ -631,137 +2177,233 @@ Response handle(const std::string& path, const Params& params) {
         Agent* agent = agentFor(param(params, "agent"));
         if (!agent) return error_("unknown agent", 400);
 
-        json::Writer cells(true);
-        {
-            std::shared_lock<std::shared_mutex> lk(agent->mu);
-            for (int sum = MIN_PLAYER_SUM; sum <= MAX_PLAYER_SUM; ++sum) {
-                for (int up = MIN_UPCARD; up <= MAX_UPCARD; ++up) {
-                    for (int ace = 0; ace <= 1; ++ace) {
-                        State s{sum, up, ace != 0};
-                        double qh = agent->qValue(s, Action::HIT);
-                        double qs = agent->qValue(s, Action::STAND);
-                        int visits = agent->visitCount(s, Action::HIT)
-                                   + agent->visitCount(s, Action::STAND);
-                        cells.raw(json::Writer()
-                            .kv("playerSum", sum)
-                            .kv("dealerUpcard", up)
-                            .kv("usableAce", ace != 0)
-                            .kv("action", agent->best(s) == Action::HIT ? "hit" : "stand")
-                            .kv("basic", rules::basicStrategy(s) == Action::HIT ? "hit" : "stand")
-                            .kv("qHit", qh)
-                            .kv("qStand", qs)
-                            .kv("margin", qh - qs)
-                            .kv("learned", agent->hasLearned(s))
-                            .kv("visits", visits)
-                            .done());
-                    }
-                }
+        Format format;
+        if (!parseFormat(param(params, "format"), format)) {
+            return error_("format must be json, columns or binary", 400);
+        }
+
+        // Built once per published version and format; polling an unchanged
+        // table is a pointer load and, over HTTP, a 304.
+        std::shared_ptr<const Published> view = agent->view();
+        switch (format) {
+            case Format::Columns:
+                return versioned(etagFor(*agent, *view, "policy-columns"), ifNoneMatch, [&] {
+                    return view->cached(view->policyColumns,
+                                        [&] { return policyColumnsJson(*agent, *view); });
+                });
+            case Format::Binary: {
+                Response r = versioned(etagFor(*agent, *view, "policy-binary"), ifNoneMatch, [&] {
+                    return view->cached(view->policyBinary, [&] { return policyBinary(*view); });
+                });
+                r.contentType = "application/octet-stream";
+                return r;
             }
+            case Format::Rows:
+                break;
         }
-        return json_(json::Writer()
-            .kv("agent", agent->id)
-            .kv("label", agent->label)
-            .kraw("cells", cells.done())
-            .done());
+        return versioned(etagFor(*agent, *view, "policy"), ifNoneMatch, [&] {
+            return view->cached(view->policyJson, [&] { return policyJson(*agent, *view); });
+        });
     }
 
     // --- evaluation ------------------------------------------------------
     if (path == "/api/simulate") {
-        int games = static_cast<int>(std::max<long long>(1,
-            std::min<long long>(MAX_SIMULATE_GAMES, paramInt(params, "games", 10000))));
-        if (param(params, "agent") == "basic") return json_(simulateBasic(games));
+        SimOptions opt = simOptions(params, 10000);
+        if (param(params, "agent") == "basic") return json_(simulateBasic(opt));
 
         Agent* agent = agentFor(param(params, "agent"));
         if (!agent) return error_("unknown agent", 400);
-        return json_(simulate(*agent, games));
+        return json_(simulate(*agent, opt));
     }
 
     if (path == "/api/compare") {
-        int games = static_cast<int>(std::max<long long>(1,
-            std::min<long long>(MAX_SIMULATE_GAMES, paramInt(params, "games", 20000))));
-
-        std::string qRes    = simulate(gQ, games);
-        std::string mcRes   = simulate(gMC, games);
-        std::string baseRes = simulateBasic(games);
+        SimOptions opt = simOptions(params, 20000);
+        bool exactOnly = param(params, "method") == "exact";
+
+        // Exact expected returns cost a few milliseconds, so they come with
+        // every comparison; method=exact skips the simulation altogether.
+        std::shared_ptr<const OptimalAI> solved = optimalFor(opt.decks);
+        double qEv    = exactReturn(gQ, opt.decks);
+        double mcEv   = exactReturn(gMC, opt.decks);
+        double baseEv = solved->expectedReturn(rules::basicStrategy);
+        double optEv  = solved->expectedReturn();
+
+        std::string qRes, mcRes, baseRes;
+        if (exactOnly) {
+            qRes    = exactJson(gQ.id, gQ.label, qEv);
+            mcRes   = exactJson(gMC.id, gMC.label, mcEv);
+            baseRes = exactJson("basic", "Basic strategy", baseEv);
+        } else {
+            // Same seed for all three: each policy plays the identical sequence
+            // of shoes, which also tightens the comparison between them.
+            qRes    = simulate(gQ, opt);
+            mcRes   = simulate(gMC, opt);
+            baseRes = simulateBasic(opt);
+        }
 
         // Where do the two learned policies actually disagree?
-        json::Writer disagreements(true);
-        int disagree = 0, comparable = 0;
-        {
-            std::shared_lock<std::shared_mutex> lq(gQ.mu);
-            std::shared_lock<std::shared_mutex> lm(gMC.mu);
-            for (int sum = MIN_PLAYER_SUM; sum <= MAX_PLAYER_SUM; ++sum) {
-                for (int up = MIN_UPCARD; up <= MAX_UPCARD; ++up) {
-                    for (int ace = 0; ace <= 1; ++ace) {
-                        State s{sum, up, ace != 0};
-                        // Only states both agents actually learned are a fair
-                        // comparison; otherwise we compare the shared fallback.
-                        if (!gQ.hasLearned(s) || !gMC.hasLearned(s)) continue;
-                        ++comparable;
-                        Action aq = gQ.best(s), am = gMC.best(s);
-                        if (aq == am) continue;
-                        ++disagree;
-                        disagreements.raw(json::Writer()
-                            .kv("playerSum", sum)
-                            .kv("dealerUpcard", up)
-                            .kv("usableAce", ace != 0)
-                            .kv("q", aq == Action::HIT ? "hit" : "stand")
-                            .kv("mc", am == Action::HIT ? "hit" : "stand")
-                            .done());
-                    }
+        struct Disagreement { State s; Action q, mc; };
+        std::vector<Disagreement> disagreements;
+        int comparable = 0;
+        std::shared_ptr<const Published> vq = gQ.view(), vm = gMC.view();
+        for (int sum = MIN_PLAYER_SUM; sum <= MAX_PLAYER_SUM; ++sum) {
+            for (int up = MIN_UPCARD; up <= MAX_UPCARD; ++up) {
+                for (int ace = 0; ace <= 1; ++ace) {
+                    State s{sum, up, ace != 0};
+                    // Only states both agents actually learned are a fair
+                    // comparison; otherwise we compare the shared fallback.
+                    if (!vq->hasLearned(s) || !vm->hasLearned(s)) continue;
+                    ++comparable;
+                    Action aq = vq->best(s), am = vm->best(s);
+                    if (aq != am) disagreements.push_back({s, aq, am});
                 }
             }
         }
 
-        return json_(json::Writer()
-            .kv("games", games)
-            .kraw("q", qRes)
-            .kraw("mc", mcRes)
-            .kraw("basic", baseRes)
-            .kv("comparableStates", comparable)
-            .kv("disagreements", disagree)
-            .kraw("disagreementCells", disagreements.done())
-            .done());
+        json::Writer w;
+        w.kv("method", exactOnly ? "exact" : "simulate")
+         .kv("games", exactOnly ? 0 : opt.games)
+         .kv("decks", opt.decks)
+         .kv("seed", static_cast<long long>(opt.seed))
+         .kraw("q", qRes)
+         .kraw("mc", mcRes)
+         .kraw("basic", baseRes)
+         .kobj("exact")
+             .kv("q", qEv)
+             .kv("mc", mcEv)
+             .kv("basic", baseEv)
+             .kv("optimal", optEv)
+         .end()
+         .kv("comparableStates", comparable)
+         .kv("disagreements", static_cast<int>(disagreements.size()))
+         .karr("disagreementCells");
+        for (const Disagreement& d : disagreements) {
+            w.obj()
+                .kv("playerSum", d.s.playerSum)
+                .kv("dealerUpcard", d.s.dealerUpcard)
+                .kv("usableAce", d.s.usableAce)
+                .kv("q", d.q == Action::HIT ? "hit" : "stand")
+                .kv("mc", d.mc == Action::HIT ? "hit" : "stand")
+                .end();
+        }
+        return json_(w.done());
+    }
+
+    // The solver itself, for any shoe: decks=0 is an infinite deck.
+    if (path == "/api/optimal") {
+        int decks = param(params, "decks") == "0" ? OptimalAI::INFINITE_DECK : paramDecks(params);
+        std::shared_ptr<const OptimalAI> o = optimalFor(decks);
+
+        static json::SizeHint hint;
+        json::Writer w(hint);
+        w.kv("decks", o->numDecks())
+         .kv("expectedReturn", o->expectedReturn())
+         .kv("passes", o->solvePasses())
+         .kv("solveMs", o->solveMillis())
+         .karr("dealer");
+        for (int up = MIN_UPCARD; up <= MAX_UPCARD; ++up) {
+            const OptimalAI::DealerOdds& d = o->dealerOdds(up);
+            w.obj().kv("upcard", up).karr("final");   // P(final total = 17..21)
+            for (double p : d.total) w.n(p);
+            w.end()
+                .kv("natural", d.natural)
+                .kv("bust", d.bust)
+                .end();
+        }
+        w.end().karr("cells");
+        for (int i = 0; i < STATE_COUNT; ++i) {
+            State s = stateAt(i);
+            if (!o->hasValue(s)) continue;
+            w.obj()
+                .kv("playerSum", s.playerSum)
+                .kv("dealerUpcard", s.dealerUpcard)
+                .kv("usableAce", s.usableAce)
+                .kv("action", o->getBestAction(s) == Action::HIT ? "hit" : "stand")
+                .kv("qHit", o->getQValue(s, Action::HIT))
+                .kv("qStand", o->getQValue(s, Action::STAND))
+                .kv("value", o->getStateValue(s))
+                .end();
+        }
+        return json_(w.done());
     }
 
     // --- training --------------------------------------------------------
     if (path == "/api/train") {
         Agent* agent = agentFor(param(params, "agent"));
         if (!agent) return error_("unknown agent", 400);
+        if (!agent->trainable()) return error_("this agent is solved, not trained", 400);
         long long episodes = std::max<long long>(1,
             std::min<long long>(MAX_TRAIN_EPISODES, paramInt(params, "episodes", 100000)));
 
-        std::lock_guard<std::mutex> lk(gJob.mu);
-        if (gJob.running) return error_("training already in progress", 409);
-
-        if (param(params, "reset") == "true") {
-            std::unique_lock<std::shared_mutex> alk(agent->mu);
-            agent->reset();
-        }
+        auto job = std::make_shared<TrainingJob>();
+        job->agentId = agent->id;
+        job->agent   = agent;
+        job->total   = episodes;
+        job->chunk   = std::max<long long>(1, episodes / PROGRESS_POINTS);
+        job->decks   = paramDecks(params);
+        job->publishEvery = std::max<long long>(1,
+            std::min(episodes, paramInt(params, "publish", DEFAULT_PUBLISH_EPISODES)));
+        job->resetFirst = param(params, "reset") == "true";
+        job->seed = params.count("seed") ? static_cast<std::uint64_t>(paramInt(params, "seed", 0))
+                                         : drawSeed(rng::Domain::Job);
+        job->profile = profile::Recorder(std::max<long long>(0, paramInt(params, "trace", 0)));
         if (params.count("epsilon")) {
             try {
-                double e = std::stod(param(params, "epsilon"));
-                std::unique_lock<std::shared_mutex> alk(agent->mu);
-                agent->setEpsilon(e);
+                job->epsilon    = std::stod(param(params, "epsilon"));
+                job->setEpsilon = true;
             } catch (...) { /* keep current epsilon */ }
         }
+        job->priority = static_cast<int>(std::max<long long>(MIN_PRIORITY,
+            std::min<long long>(MAX_PRIORITY, paramInt(params, "priority", DEFAULT_PRIORITY))));
+        // threads=0 asks for every core; more than the pool has buys nothing.
+        // Actors are their own threads rather than pool tasks, so they are
+        // capped by the hardware instead, and there is always at least one.
+        std::string mode = param(params, "mode");
+        long long threads = paramInt(params, "threads", mode == "actor-learner" ? 0 : 1);
+        if (mode == "actor-learner") {
+            long long hw = TaskPool::hardwareThreads();
+            if (threads <= 0) threads = hw;
+            job->mode    = TrainMode::ActorLearner;
+            job->threads = static_cast<unsigned>(std::max<long long>(1, std::min(hw, threads)));
+        } else {
+            if (threads <= 0) threads = TaskPool::shared().concurrency();
+            job->threads = static_cast<unsigned>(
+                std::min<long long>(TaskPool::shared().concurrency(), threads));
+            job->mode = (mode == "serial" || job->threads <= 1) ? TrainMode::Serial
+                                                                : TrainMode::Hogwild;
+            if (job->mode == TrainMode::Serial) job->threads = 1;
+        }
 
-        gJob.agentId = agent->id;
-        gJob.agent   = agent;
-        gJob.done    = 0;
-        gJob.total   = episodes;
-        gJob.chunk   = std::max<long long>(1, episodes / PROGRESS_POINTS);
-        gJob.cancel  = false;
-        gJob.points.clear();
-        gJob.resetWindow();
-        gJob.game    = std::make_unique<Game>(0);
-        gJob.running = true;
+        int ahead = 0;   // active jobs for this agent, which run first
+        {
+            std::lock_guard<std::mutex> lk(gSchedMu);
+            int active = 0;
+            for (const auto& entry : gJobs) {
+                if (!isActive(entry.second->state)) continue;
+                ++active;
+                if (entry.second->agent == agent) ++ahead;
+            }
+            if (active >= MAX_ACTIVE_JOBS) return error_("too many training jobs", 429);
+            job->id = gNextJobId++;
+            job->firstEvent = pushEvent(*job, TrainEventKind::Queued, job->priority);
+            gJobs.emplace(job->id, job);
+            publishJobs();
+        }
 
         return json_(json::Writer()
             .kv("started", true)
+            .kv("job", job->id)
+            .kv("state", "queued")
+            .kv("queuedBehind", ahead)
             .kv("agent", agent->id)
             .kv("episodes", episodes)
-            .kv("chunk", gJob.chunk)
+            .kv("priority", job->priority.load())
+            .kv("chunk", job->chunk)
+            .kv("decks", job->decks)
+            .kv("seed", static_cast<long long>(job->seed))
+            .kv("mode", trainModeName(job->mode.load()))
+            .kv("threads", static_cast<int>(job->threads.load()))
+            .kv("publishEvery", job->publishEvery)
             .done());
     }
 
@@ -769,45 +2411,116 @@ Response handle(const std::string& path, const Params& params) {
     // itself; the native server's worker thread uses advanceTraining directly.
     if (path == "/api/train/step") {
         long long budget = std::max<long long>(1, paramInt(params, "episodes", 2000));
-        advanceTraining(budget);
-        std::lock_guard<std::mutex> lk(gJob.mu);
+        long long ran = advanceTraining(budget);
+        std::shared_ptr<const JobList> jobs = jobList();
+        int active = static_cast<int>(std::count_if(jobs->begin(), jobs->end(), [](const auto& job) {
+            return isActive(job->state.load(std::memory_order_acquire));
+        }));
         return json_(json::Writer()
-            .kv("running", gJob.running)
-            .kv("done", gJob.done)
-            .kv("total", gJob.total)
+            .kv("ran", ran)
+            .kv("active", active)
             .done());
     }
 
     if (path == "/api/train/progress") {
         long long since = std::max<long long>(0, paramInt(params, "since", 0));
+        Format format;
+        if (!parseFormat(param(params, "format"), format)) {
+            return error_("format must be json, columns or binary", 400);
+        }
+        std::shared_ptr<const TrainingJob> job = findJob(params);
+        if (!job) return error_("unknown job", 404);
+
+        // No lock: the points below the count are immutable, and the trainer
+        // keeps appending past it meanwhile.
+        ProgressView v(*job);
+        std::size_t first = std::min(static_cast<std::size_t>(since), v.count);
+        if (format == Format::Binary) return progressBinary(v, first);
+        if (format == Format::Columns) return json_(progressColumnsJson(v, first));
+
+        static json::SizeHint hint;
+        json::Writer w(hint);
+        writeProgressHeader(w, v);
+        w.karr("points");
+        for (std::size_t i = first; i < v.count; ++i) {
+            writePoint(w.obj(), job->points[i]);
+            w.end();
+        }
+        return json_(w.done());
+    }
 
-        std::lock_guard<std::mutex> lk(gJob.mu);
-        json::Writer pts(true);
-        for (size_t i = static_cast<size_t>(since); i < gJob.points.size(); ++i) {
-            const ProgressPoint& p = gJob.points[i];
-            pts.raw(json::Writer()
-                .kv("episode", p.episode)
-                .kv("winRate", p.winRate)
-                .kv("avgReward", p.avgReward)
-                .kv("epsilon", p.epsilon)
-                .kv("statesLearned", p.statesLearned)
-                .done());
+    // The sampled episodes of a job submitted with trace=N, as Chrome
+    // trace-event JSON, once the job has ended.
+    if (path == "/api/train/trace") {
+        if (!profile::ENABLED) return error_("built without BLACKJACK_PROFILE", 404);
+        std::shared_ptr<const TrainingJob> job = findJob(params);
+        if (!job) return error_("unknown job", 404);
+        if (isActive(job->state.load(std::memory_order_acquire))) {
+            return error_("job has not ended", 409);
         }
-        return json_(json::Writer()
-            .kv("running", gJob.running)
-            .kv("agent", gJob.agentId)
-            .kv("done", gJob.done)
-            .kv("total", gJob.total)
-            .kv("cursor", static_cast<long long>(gJob.points.size()))
-            .kraw("points", pts.done())
-            .done());
+        if (!job->profile.tracing()) return error_("job was not traced (trace=N)", 404);
+        Response r;
+        r.body = job->profile.chromeTrace();
+        r.downloadName = "job" + std::to_string(job->id) + "_trace.json";
+        return r;
     }
 
+    // job= stops one job, queued or running; without it, every active job. A
+    // running job stops after the episode in progress.
     if (path == "/api/train/stop") {
-        std::lock_guard<std::mutex> lk(gJob.mu);
-        bool was = gJob.running;
-        gJob.cancel = true;
-        return json_(json::Writer().kv("stopping", was).done());
+        std::vector<int> stopping;
+        {
+            std::lock_guard<std::mutex> lk(gSchedMu);
+            int only = static_cast<int>(paramInt(params, "job", 0));
+            if (params.count("job") && gJobs.find(only) == gJobs.end()) {
+                return error_("unknown job", 404);
+            }
+            for (const auto& entry : gJobs) {
+                TrainingJob& job = *entry.second;
+                if (params.count("job") && job.id != only) continue;
+                JobState state = job.state.load(std::memory_order_relaxed);
+                if (!isActive(state)) continue;
+                stopping.push_back(job.id);
+                if (state == JobState::Queued) {
+                    // Never started, so no worker will see the flag: end it here.
+                    job.state.store(JobState::Cancelled, std::memory_order_release);
+                    pushEvent(job, TrainEventKind::Cancel, job.priority.load());
+                } else {
+                    job.cancel.store(true, std::memory_order_relaxed);
+                }
+            }
+            pruneFinished();
+        }
+        json::Writer w;
+        w.kv("stopping", !stopping.empty()).karr("jobs");
+        for (int id : stopping) w.i(id);
+        return json_(w.done());
+    }
+
+    if (path == "/api/train/priority") {
+        std::lock_guard<std::mutex> lk(gSchedMu);
+        auto it = gJobs.find(static_cast<int>(paramInt(params, "job", 0)));
+        if (it == gJobs.end()) return error_("unknown job", 404);
+        TrainingJob& job = *it->second;
+        if (!isActive(job.state.load(std::memory_order_relaxed))) {
+            return error_("job has already ended", 409);
+        }
+        job.priority.store(static_cast<int>(std::max<long long>(MIN_PRIORITY,
+            std::min<long long>(MAX_PRIORITY, paramInt(params, "priority", job.priority.load())))));
+        json::Writer w;
+        writeJob(w, job);
+        return json_(w.done());
+    }
+
+    // Every job still kept, oldest first.
+    if (path == "/api/train/jobs") {
+        json::Writer w;
+        w.karr("jobs");
+        for (const auto& job : *jobList()) {
+            writeJob(w.obj(), *job);
+            w.end();
+        }
+        return json_(w.done());
     }
 
     // --- persistence -----------------------------------------------------
@@ -815,7 +2528,7 @@ Response handle(const std::string& path, const Params& params) {
         Agent* agent = agentFor(param(params, "agent"));
         if (!agent) return error_("unknown agent", 400);
         {
-            std::shared_lock<std::shared_mutex> lk(agent->mu);
+            std::shared_lock<metrics::TimedSharedMutex> lk(agent->mu);
             agent->save();
         }
         return json_(json::Writer().kv("saved", agent->tablePath).done());
@@ -824,13 +2537,31 @@ Response handle(const std::string& path, const Params& params) {
     if (path == "/api/reset") {
         Agent* agent = agentFor(param(params, "agent"));
         if (!agent) return error_("unknown agent", 400);
+        if (!agent->trainable()) return error_("this agent is solved, not trained", 400);
         {
-            std::lock_guard<std::mutex> lk(gJob.mu);
-            if (gJob.running) return error_("cannot reset while training", 409);
+            // Checked and flagged under the scheduler's lock, so no job for
+            // the agent can be claimed between the check and the reset. (Its
+            // Hogwild workers train without mu.)
+            std::lock_guard<std::mutex> lk(gSchedMu);
+            if (agent->resetting) return error_("a reset is already in progress", 409);
+            for (const auto& entry : gJobs) {
+                if (entry.second->agent == agent && isActive(entry.second->state)) {
+                    return error_("cannot reset while training", 409);
+                }
+            }
+            agent->resetting = true;
         }
+        struct Unflag {
+            Agent* agent;
+            ~Unflag() {
+                std::lock_guard<std::mutex> lk(gSchedMu);
+                agent->resetting = false;
+            }
+        } unflag{agent};
         {
-            std::unique_lock<std::shared_mutex> lk(agent->mu);
+            std::unique_lock<metrics::TimedSharedMutex> lk(agent->mu);
             agent->reset();
+            agent->publish();
         }
         return json_(agentSummaryJson(*agent));
     }
@@ -838,15 +2569,10 @@ Response handle(const std::string& path, const Params& params) {
     if (path == "/api/qtable.csv") {
         Agent* agent = agentFor(param(params, "agent"));
         if (!agent) return error_("unknown agent", 400);
-        {
-            std::shared_lock<std::shared_mutex> lk(agent->mu);
-            agent->save();
-        }
-        std::ifstream in(agent->tablePath, std::ios::binary);
-        if (!in) return error_("no table on disk", 404);
-
-        Response r;
-        r.body.assign((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        std::shared_ptr<const Published> view = agent->view();
+        Response r = versioned(etagFor(*agent, *view, "csv"), ifNoneMatch, [&] {
+            return view->cached(view->csv, [&] { return csvOf(view->policy); });
+        });
         r.contentType = "text/csv";
         r.downloadName = agent->id + "_q_table.csv";
         return r;
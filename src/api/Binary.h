@@ -0,0 +1,85 @@
+//
+// Packed little-endian encoding for the API's binary formats.
+//
+// The counterpart of Json.h for clients that poll the policy grid or the
+// training series often enough that bytes and parse time matter: values are
+// appended in a fixed little-endian layout, whatever the host, so a browser can
+// lay typed arrays straight over the payload. The layouts themselves are
+// documented where they are written (src/api/Api.cpp) and in the README. The
+// one binary request, the socket decision protocol, is read with u16At/u32At.
+//
+
+#ifndef BLACKJACK_AI_BINARY_H
+#define BLACKJACK_AI_BINARY_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <utility>
+
+namespace binary {
+
+class Writer {
+private:
+    std::string out;
+
+    template <typename T>
+    Writer& le(T v) {
+        for (std::size_t i = 0; i < sizeof(T); ++i) {
+            out += static_cast<char>(static_cast<std::uint8_t>(v >> (8 * i)));
+        }
+        return *this;
+    }
+
+public:
+    explicit Writer(std::size_t reserve = 0) { out.reserve(reserve); }
+
+    // Appends to an existing buffer instead, e.g. after a frame header.
+    explicit Writer(std::string&& buffer, std::size_t reserve = 0) : out(std::move(buffer)) {
+        out.reserve(out.size() + reserve);
+    }
+
+    Writer& u8(std::uint8_t v)   { out += static_cast<char>(v); return *this; }
+    Writer& u16(std::uint16_t v) { return le(v); }
+    Writer& u32(std::uint32_t v) { return le(v); }
+    Writer& u64(std::uint64_t v) { return le(v); }
+
+    Writer& f32(float v) {
+        std::uint32_t bits;
+        std::memcpy(&bits, &v, sizeof(bits));
+        return le(bits);
+    }
+
+    Writer& f64(double v) {
+        std::uint64_t bits;
+        std::memcpy(&bits, &v, sizeof(bits));
+        return le(bits);
+    }
+
+    // Raw bytes, e.g. a magic number. `n` pads with zeros (or truncates).
+    Writer& bytes(std::string_view s, std::size_t n) {
+        out.append(s.substr(0, n));
+        out.append(n - std::min(n, s.size()), '\0');
+        return *this;
+    }
+
+    std::size_t size() const { return out.size(); }
+
+    std::string done() { return std::move(out); }
+};
+
+// Little-endian reads for the binary request side.
+inline std::uint16_t u16At(std::string_view s, std::size_t at) {
+    return static_cast<std::uint16_t>(static_cast<std::uint8_t>(s[at]) |
+                                      static_cast<std::uint8_t>(s[at + 1]) << 8);
+}
+
+inline std::uint32_t u32At(std::string_view s, std::size_t at) {
+    return u16At(s, at) | static_cast<std::uint32_t>(u16At(s, at + 2)) << 16;
+}
+
+} // namespace binary
+
+#endif //BLACKJACK_AI_BINARY_H
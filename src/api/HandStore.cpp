@@ -0,0 +1,210 @@
+//
+// Sharded, pooled hand sessions with lazy timer-wheel expiry. See HandStore.h.
+//
+
+#include "HandStore.h"
+
+#include "../../include/core/Random.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace {
+
+constexpr std::uint32_t SLOT_MASK = (std::uint32_t{1} << HandStore::SLOT_BITS) - 1;
+// Ids stay below 2^53 so JavaScript numbers hold them exactly.
+constexpr int GENERATION_BITS = 53 - HandStore::SHARD_BITS - HandStore::SLOT_BITS;
+constexpr std::uint32_t GENERATION_MASK = (std::uint32_t{1} << GENERATION_BITS) - 1;
+
+constexpr int MAX_IDLE_SECONDS = 24 * 60 * 60;
+
+HandStore::Id makeId(std::size_t shard, std::uint32_t index, std::uint32_t generation) {
+    return static_cast<HandStore::Id>(
+        ((std::uint64_t{generation} << HandStore::SLOT_BITS | index) << HandStore::SHARD_BITS)
+        | shard);
+}
+
+} // namespace
+
+HandStore::HandStore(std::size_t capacity, int idleSeconds) : perShard(1), idleTicks(1) {
+    configure(capacity, idleSeconds);
+}
+
+void HandStore::configure(std::size_t capacity, int idleSeconds) {
+    capacity = std::max(SHARDS, std::min(MAX_CAPACITY, capacity));
+    perShard.store((capacity + SHARDS - 1) / SHARDS);
+    idleTicks.store(std::max(1, std::min(MAX_IDLE_SECONDS, idleSeconds)));
+}
+
+void HandStore::reseed(std::uint64_t seed) {
+    for (std::size_t i = 0; i < SHARDS; ++i) {
+        std::lock_guard<std::mutex> lk(shards[i].mu);
+        shards[i].shoe.reseed(rng::derive(seed, i));
+    }
+}
+
+long long HandStore::now() const {
+    return std::chrono::duration_cast<std::chrono::seconds>(
+        std::chrono::steady_clock::now() - epoch).count();
+}
+
+std::size_t HandStore::size() {
+    std::size_t n = 0;
+    long long t = now();
+    for (Shard& shard : shards) {
+        std::lock_guard<std::mutex> lk(shard.mu);
+        advance(shard, t);   // count only hands that have not expired
+        n += shard.live;
+    }
+    return n;
+}
+
+// --- shard internals: the caller holds shard.mu ---------------------------
+
+void HandStore::schedule(Shard& shard, std::uint32_t index, long long due) {
+    // Never into a bucket already processed this tick, or it would wait a lap.
+    due = std::max(due, shard.tick + 1);
+    shard.wheel[static_cast<std::size_t>(due) % WHEEL_BUCKETS].push_back(
+        {index, shard.slots[index]->generation});
+}
+
+// Processes every bucket from the last tick up to `t`. An entry whose hand has
+// since closed (or been dealt again) is dropped; one whose hand was used since
+// it was filed is re-filed for its new deadline; the rest expire. A hand in use
+// by a request right now is never expired from under it.
+void HandStore::advance(Shard& shard, long long t) {
+    if (shard.tick < 0) shard.tick = t;
+    long long steps = std::min<long long>(t - shard.tick, WHEEL_BUCKETS);
+    long long ttl = idleTicks.load(std::memory_order_relaxed);
+    std::vector<WheelEntry> due;
+    for (long long i = 1; i <= steps; ++i) {
+        due.clear();
+        due.swap(shard.wheel[static_cast<std::size_t>(shard.tick + i) % WHEEL_BUCKETS]);
+        for (const WheelEntry& e : due) {
+            Slot& slot = *shard.slots[e.index];
+            if (!slot.live || slot.generation != e.generation) continue;
+            long long deadline = slot.lastUsed + ttl;
+            if (deadline <= t && slot.pins == 0) {
+                retire(shard, e.index);
+            } else {
+                shard.wheel[static_cast<std::size_t>(std::max(deadline, t + 1)) % WHEEL_BUCKETS]
+                    .push_back(e);
+            }
+        }
+    }
+    shard.tick = t;
+}
+
+// Ends a live hand. Its slot is reused once no Lease pins it.
+void HandStore::retire(Shard& shard, std::uint32_t index) {
+    Slot& slot = *shard.slots[index];
+    slot.live = false;
+    --shard.live;
+    if (slot.pins == 0) shard.free.push_back(index);
+}
+
+bool HandStore::recycleIdlest(Shard& shard) {
+    std::uint32_t idlest = 0;
+    long long oldest = std::numeric_limits<long long>::max();
+    for (std::uint32_t i = 0; i < shard.slots.size(); ++i) {
+        const Slot& slot = *shard.slots[i];
+        if (slot.live && slot.pins == 0 && slot.lastUsed < oldest) {
+            oldest = slot.lastUsed;
+            idlest = i;
+        }
+    }
+    if (oldest == std::numeric_limits<long long>::max()) return false;
+    retire(shard, idlest);
+    return true;
+}
+
+// --- public ----------------------------------------------------------------
+
+HandStore::Lease HandStore::open() {
+    std::size_t s = nextShard.fetch_add(1, std::memory_order_relaxed) % SHARDS;
+    Shard& shard = shards[s];
+    long long t = now();
+
+    std::unique_lock<std::mutex> lk(shard.mu);
+    advance(shard, t);
+    while (shard.live >= perShard.load(std::memory_order_relaxed)) {
+        if (!recycleIdlest(shard)) return Lease();
+    }
+
+    std::uint32_t index;
+    if (!shard.free.empty()) {
+        index = shard.free.back();
+        shard.free.pop_back();
+    } else {
+        index = static_cast<std::uint32_t>(shard.slots.size());
+        shard.slots.push_back(std::make_unique<Slot>());
+    }
+    Slot& slot = *shard.slots[index];
+    slot.generation = std::max<std::uint32_t>(1, (slot.generation + 1) & GENERATION_MASK);
+    slot.live = true;
+    slot.pins = 1;
+    slot.lastUsed = t;
+    slot.session.deal(shard.shoe);
+    ++shard.live;
+    schedule(shard, index, t + idleTicks.load(std::memory_order_relaxed));
+    Id id = makeId(s, index, slot.generation);
+    lk.unlock();
+
+    return Lease(*this, shard, slot, index, id);
+}
+
+HandStore::Lease HandStore::find(Id id) {
+    if (id <= 0) return Lease();
+    auto bits = static_cast<std::uint64_t>(id);
+    Shard& shard = shards[bits & (SHARDS - 1)];
+    auto index = static_cast<std::uint32_t>((bits >> SHARD_BITS) & SLOT_MASK);
+    auto generation = static_cast<std::uint32_t>(bits >> (SHARD_BITS + SLOT_BITS));
+    long long t = now();
+
+    std::unique_lock<std::mutex> lk(shard.mu);
+    advance(shard, t);
+    if (index >= shard.slots.size()) return Lease();
+    Slot& slot = *shard.slots[index];
+    if (!slot.live || slot.generation != generation) return Lease();
+    ++slot.pins;
+    slot.lastUsed = t;
+    lk.unlock();
+
+    return Lease(*this, shard, slot, index, id);
+}
+
+// --- Lease -----------------------------------------------------------------
+
+HandStore::Lease::Lease(HandStore& store, Shard& shard, Slot& slot, std::uint32_t index, Id id)
+    : store(&store), shard(&shard), slot(&slot), index(index), handId(id) {
+    slot.mu.lock();
+}
+
+HandStore::Lease::Lease(Lease&& other) noexcept
+    : store(other.store), shard(other.shard), slot(other.slot),
+      index(other.index), handId(other.handId), closing(other.closing) {
+    other.slot = nullptr;
+}
+
+HandStore::Lease::~Lease() {
+    if (!slot) return;
+    slot->mu.unlock();
+
+    std::lock_guard<std::mutex> lk(shard->mu);
+    --slot->pins;
+    if (closing && slot->live) {
+        store->retire(*shard, index);
+    } else if (!slot->live && slot->pins == 0) {
+        shard->free.push_back(index);   // expired or closed while we held it
+    }
+}
+
+void HandStore::Lease::hit() {
+    std::lock_guard<std::mutex> lk(shard->mu);
+    slot->session.hit();
+}
+
+void HandStore::Lease::stand() {
+    std::lock_guard<std::mutex> lk(shard->mu);
+    slot->session.stand();
+}
@@ -0,0 +1,157 @@
+//
+// The open interactive hands behind /api/hand/new and /api/hand/step.
+//
+// One map behind one mutex serialized every hand in the server and had to cap
+// the table at a couple of hundred. Here hands are spread over independent
+// shards by id, each with its own lock, shoe and pool of sessions: a request
+// holds its shard's lock only to look a hand up (or to draw cards from the
+// shard's shoe), and plays the hand under that hand's own lock, so hands never
+// wait on each other except for the few nanoseconds of a draw.
+//
+// Sessions are pooled. A closed or expired hand's slot goes on its shard's
+// free list and the next hand is dealt into it, reusing its storage; a slot's
+// generation is part of the id, so a stale id never reaches the new hand.
+//
+// Idle hands expire after a configurable time. Each shard keeps a timer wheel
+// of one-second buckets, advanced lazily by whichever request next touches the
+// shard, so there is no sweeper thread (the WebAssembly build has none to give)
+// and a touch is O(1): entries are not moved when a hand is used, only
+// re-filed when their bucket comes round and the hand turns out to be live.
+// A full shard first expires what it can, then recycles its longest-idle hand.
+//
+
+#ifndef BLACKJACK_AI_HANDSTORE_H
+#define BLACKJACK_AI_HANDSTORE_H
+
+#include "../../include/core/HandSession.h"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+class HandStore {
+public:
+    using Id = long long;
+
+    static constexpr std::size_t DEFAULT_CAPACITY = 16384;
+    static constexpr int DEFAULT_IDLE_SECONDS = 600;
+
+    static constexpr int SHARD_BITS = 4;
+    static constexpr int SLOT_BITS = 20;
+    static constexpr std::size_t SHARDS = std::size_t{1} << SHARD_BITS;
+    static constexpr std::size_t MAX_CAPACITY = SHARDS << SLOT_BITS;
+
+private:
+    static constexpr std::size_t WHEEL_BUCKETS = 64;   // seconds per revolution
+
+    struct Slot {
+        std::mutex mu;               // held by a Lease while a request plays the hand
+        HandSession session;
+        // The rest is guarded by the shard's lock.
+        std::uint32_t generation = 0;
+        bool live = false;
+        int pins = 0;                // Leases holding or waiting for `mu`
+        long long lastUsed = 0;      // tick of the last lookup
+    };
+
+    struct WheelEntry {
+        std::uint32_t index;
+        std::uint32_t generation;
+    };
+
+    struct alignas(64) Shard {
+        std::mutex mu;
+        Shoe shoe;
+        std::vector<std::unique_ptr<Slot>> slots;
+        std::vector<std::uint32_t> free;
+        std::size_t live = 0;
+        long long tick = -1;         // last wheel bucket processed
+        std::array<std::vector<WheelEntry>, WHEEL_BUCKETS> wheel;
+    };
+
+    std::array<Shard, SHARDS> shards;
+    std::atomic<std::size_t> perShard;
+    std::atomic<int> idleTicks;
+    std::atomic<std::size_t> nextShard{0};
+    std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+
+    long long now() const;
+    void schedule(Shard& shard, std::uint32_t index, long long due);
+    void advance(Shard& shard, long long t);
+    void retire(Shard& shard, std::uint32_t index);
+    bool recycleIdlest(Shard& shard);
+
+public:
+    // Exclusive access to one open hand for the length of a request. Empty
+    // (false) when the hand is unknown, expired or could not be opened.
+    class Lease {
+    private:
+        friend class HandStore;
+        HandStore* store = nullptr;
+        Shard* shard = nullptr;
+        Slot* slot = nullptr;
+        std::uint32_t index = 0;
+        Id handId = 0;
+        bool closing = false;
+
+        Lease(HandStore& store, Shard& shard, Slot& slot, std::uint32_t index, Id id);
+
+    public:
+        Lease() = default;
+        Lease(Lease&& other) noexcept;
+        ~Lease();
+
+        Lease(const Lease&) = delete;
+        Lease& operator=(const Lease&) = delete;
+
+        explicit operator bool() const { return slot != nullptr; }
+        Id id() const { return handId; }
+        const HandSession& session() const { return slot->session; }
+
+        // Play the hand; both draw from the shard's shoe under its lock.
+        void hit();
+        void stand();
+
+        // Ends the hand: its id stops resolving now, and its slot returns to
+        // the pool once the last request holding it is done.
+        void close() { closing = true; }
+    };
+
+    explicit HandStore(std::size_t capacity = DEFAULT_CAPACITY,
+                       int idleSeconds = DEFAULT_IDLE_SECONDS);
+
+    HandStore(const HandStore&) = delete;
+    HandStore& operator=(const HandStore&) = delete;
+
+    // Capacity is clamped to [SHARDS, MAX_CAPACITY] and split evenly between
+    // shards; idle time to [1 s, 1 day]. Takes effect for the next request;
+    // hands already open over a lowered capacity are recycled as new ones come.
+    void configure(std::size_t capacity, int idleSeconds);
+
+    // Reshuffles shard i's shoe from rng::derive(seed, i), so a fresh server
+    // given the same seed deals the same sequence of new hands. Hands already
+    // open keep their cards.
+    void reseed(std::uint64_t seed);
+
+    std::size_t capacity() const { return perShard.load() * SHARDS; }
+    int idleSeconds() const { return idleTicks.load(); }
+
+    // Hands currently open, summed shard by shard (so approximate under load).
+    // Expires whatever is due on the way.
+    std::size_t size();
+
+    // Deals a new hand. Empty only if the chosen shard is full of hands that
+    // other requests are playing at this very moment.
+    Lease open();
+
+    // The hand with this id, refreshing its idle timer.
+    Lease find(Id id);
+};
+
+#endif //BLACKJACK_AI_HANDSTORE_H
@@ -2,19 +2,30 @@
 // Minimal JSON *writer*. The API takes its inputs as query parameters, which
 // httplib already parses, so nothing here needs to parse JSON -- only emit it.
 //
+// Everything is appended to one std::string. Nested objects and arrays are
+// opened in place (obj/arr/kobj/karr ... end) rather than built in a Writer of
+// their own and copied in, numbers go through std::to_chars, and done() hands
+// the buffer over by move, so a response is one growing allocation -- or none
+// beyond the first, when the caller passes a SizeHint remembered from the
+// previous response of the same kind. raw()/kraw() still splice in text that
+// was serialized elsewhere (a cached body, a helper's output).
+//
 
 #ifndef BLACKJACK_AI_JSON_H
 #define BLACKJACK_AI_JSON_H
 
+#include <atomic>
+#include <cassert>
+#include <charconv>
 #include <cmath>
-#include <sstream>
+#include <cstdint>
+#include <cstdio>
 #include <string>
+#include <string_view>
 
 namespace json {
 
-inline std::string escape(const std::string& s) {
-    std::string out;
-    out.reserve(s.size() + 8);
+inline void escapeInto(std::string& out, std::string_view s) {
     for (char c : s) {
         switch (c) {
             case '"':  out += "\\\""; break;
@@ -32,75 +43,138 @@ inline std::string escape(const std::string& s) {
                 }
         }
     }
+}
+
+inline std::string escape(std::string_view s) {
+    std::string out;
+    out.reserve(s.size() + 8);
+    escapeInto(out, s);
     return out;
 }
 
 // Numbers: JSON has no NaN/Infinity, so degenerate values become null.
-inline std::string num(double v) {
+// Otherwise fixed with six decimals and the trailing zeros trimmed, so payloads
+// stay small and readable.
+inline void numInto(std::string& out, double v) {
     if (!std::isfinite(v)) {
-        return "null";
+        out += "null";
+        return;
     }
-    std::ostringstream os;
-    os.precision(6);
-    os << std::fixed << v;
-    std::string s = os.str();
-    // Trim trailing zeros so payloads stay small and readable.
-    if (s.find('.') != std::string::npos) {
-        s.erase(s.find_last_not_of('0') + 1);
-        if (!s.empty() && s.back() == '.') {
-            s.pop_back();
-        }
-    }
-    return s.empty() ? "0" : s;
+    char buf[330];   // DBL_MAX is 309 digits before the point
+    auto res = std::to_chars(buf, buf + sizeof(buf), v, std::chars_format::fixed, 6);
+    char* end = res.ptr;
+    while (end[-1] == '0') --end;   // there is always a '.' to stop at
+    if (end[-1] == '.') --end;
+    out.append(buf, end);
+}
+
+inline std::string num(double v) {
+    std::string out;
+    numInto(out, v);
+    return out;
 }
 
-// Builds a JSON object or array by appending pre-serialized pieces.
+inline void intInto(std::string& out, long long v) {
+    char buf[24];
+    auto res = std::to_chars(buf, buf + sizeof(buf), v);
+    out.append(buf, res.ptr);
+}
+
+// The size of the last response of one kind, so the next can reserve it up
+// front. Shared by every request for that kind; a stale hint only costs a
+// reallocation.
+struct SizeHint {
+    std::atomic<std::size_t> bytes{0};
+};
+
+// Builds a JSON object or array into a single buffer.
 class Writer {
 private:
-    std::ostringstream os;
+    static constexpr int MAX_DEPTH = 32;
+
+    std::string out;
+    SizeHint* hint = nullptr;
     bool needComma = false;
-    char closing;
+    int depth = 0;                  // open containers below the root
+    std::uint32_t arrayStack = 0;   // bit d set: level d is an array (0 = root)
 
     void sep() {
-        if (needComma) os << ',';
+        if (needComma) out += ',';
         needComma = true;
     }
 
+    Writer& open(bool array) {
+        assert(depth + 1 < MAX_DEPTH);
+        std::uint32_t bit = std::uint32_t{1} << ++depth;
+        arrayStack = array ? (arrayStack | bit) : (arrayStack & ~bit);
+        out += array ? '[' : '{';
+        needComma = false;
+        return *this;
+    }
+
 public:
-    explicit Writer(bool array = false) : closing(array ? ']' : '}') {
-        os << (array ? '[' : '{');
+    explicit Writer(bool array = false) {
+        out += array ? '[' : '{';
+        arrayStack = array ? 1u : 0u;
+    }
+
+    // Reserves the hinted size, and records this response's size in done().
+    explicit Writer(SizeHint& h, bool array = false) : hint(&h) {
+        out.reserve(h.bytes.load(std::memory_order_relaxed));
+        out += array ? '[' : '{';
+        arrayStack = array ? 1u : 0u;
     }
 
-    Writer& key(const std::string& k) {
+    Writer& key(std::string_view k) {
         sep();
-        os << '"' << escape(k) << "\":";
+        out += '"';
+        escapeInto(out, k);
+        out += "\":";
         needComma = false;   // the value that follows belongs to this key
         return *this;
     }
 
     // Raw already-serialized JSON (nested objects/arrays).
-    Writer& raw(const std::string& v) { sep(); os << v; return *this; }
-
-    Writer& str(const std::string& v)  { sep(); os << '"' << escape(v) << '"'; return *this; }
-    Writer& n(double v)                { sep(); os << num(v); return *this; }
-    Writer& i(long long v)             { sep(); os << v; return *this; }
-    Writer& b(bool v)                  { sep(); os << (v ? "true" : "false"); return *this; }
+    Writer& raw(std::string_view v) { sep(); out += v; return *this; }
+
+    Writer& str(std::string_view v) { sep(); out += '"'; escapeInto(out, v); out += '"'; return *this; }
+    Writer& n(double v)             { sep(); numInto(out, v); return *this; }
+    Writer& i(long long v)          { sep(); intInto(out, v); return *this; }
+    Writer& b(bool v)               { sep(); out += v ? "true" : "false"; return *this; }
+
+    // Nested containers, written in place: an array element, or a keyed
+    // member. Each is closed by end().
+    Writer& obj()                   { sep(); return open(false); }
+    Writer& arr()                   { sep(); return open(true); }
+    Writer& kobj(std::string_view k) { key(k); return obj(); }
+    Writer& karr(std::string_view k) { key(k); return arr(); }
+
+    Writer& end() {
+        assert(depth > 0);
+        out += ((arrayStack >> depth--) & 1u) ? ']' : '}';
+        needComma = true;   // the container just closed was a value
+        return *this;
+    }
 
-    Writer& kv(const std::string& k, const std::string& v) { return key(k).str(v); }
-    Writer& kv(const std::string& k, const char* v)        { return key(k).str(v); }
-    Writer& kv(const std::string& k, double v)             { return key(k).n(v); }
-    Writer& kv(const std::string& k, int v)                { return key(k).i(v); }
-    Writer& kv(const std::string& k, long long v)          { return key(k).i(v); }
-    Writer& kv(const std::string& k, bool v)               { return key(k).b(v); }
-    Writer& kraw(const std::string& k, const std::string& v) { return key(k).raw(v); }
+    Writer& kv(std::string_view k, std::string_view v) { return key(k).str(v); }
+    Writer& kv(std::string_view k, const std::string& v) { return key(k).str(v); }
+    Writer& kv(std::string_view k, const char* v)      { return key(k).str(v); }
+    Writer& kv(std::string_view k, double v)           { return key(k).n(v); }
+    Writer& kv(std::string_view k, int v)              { return key(k).i(v); }
+    Writer& kv(std::string_view k, long long v)        { return key(k).i(v); }
+    Writer& kv(std::string_view k, bool v)             { return key(k).b(v); }
+    Writer& kraw(std::string_view k, std::string_view v) { return key(k).raw(v); }
 
+    // Closes anything still open, then the root, and hands the buffer over.
     std::string done() {
-        os << closing;
-        return os.str();
+        while (depth > 0) end();
+        out += (arrayStack & 1u) ? ']' : '}';
+        if (hint) hint->bytes.store(out.size(), std::memory_order_relaxed);
+        return std::move(out);
     }
 };
 
-inline std::string error(const std::string& message) {
+inline std::string error(std::string_view message) {
     return Writer().kv("error", message).done();
 }
 
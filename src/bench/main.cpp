@@ -0,0 +1,419 @@
+//
+// Microbenchmarks for the simulation and learning hot paths.
+//
+// Self-contained: no framework, just a calibrated loop per benchmark. Each one
+// is run in growing batches until a batch takes --min-time, then measured
+// --repeat times; the median is reported as ns/op and ops/s (episodes/s for
+// the episode benchmarks), along with heap allocations per op, counted by the
+// replacement operator new below. Everything that deals or explores is seeded
+// from SEED (see core/Random.h), so two runs do the same work.
+//
+// Results go to stdout as a table and, with --json, as JSON meant to be kept
+// per commit and diffed:
+//
+//   blackjack_bench --json bench.json
+//   blackjack_bench --filter episode --min-time 0.5
+//
+// Run it from the repository root; the CSV benchmarks write to the system
+// temp directory.
+//
+
+#include "../../include/api/Api.h"
+#include "../../include/core/Deck.h"
+#include "../../include/core/Dealer.h"
+#include "../../include/core/Game.h"
+#include "../../include/core/Random.h"
+#include "../../include/core/Rules.h"
+#include "../../include/core/Shoe.h"
+#include "../../include/ai/QLearningAI.h"
+#include "../../include/ai/MonteCarloAI.h"
+#include "../api/Json.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <string>
+#include <vector>
+
+// ---------------------------------------------------------------------------
+// Allocation counting
+// ---------------------------------------------------------------------------
+
+namespace {
+std::atomic<std::uint64_t> gAllocations{0};
+
+// Every replacement below goes through this pair: with std::free called from
+// operator delete itself, g++ 12 at -O2 warns (-Wmismatched-new-delete) that
+// it frees what operator new returned.
+void* allocate(std::size_t size) {
+    gAllocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void release(void* p) noexcept { std::free(p); }
+}
+
+void* operator new(std::size_t size) { return allocate(size); }
+void* operator new[](std::size_t size) { return allocate(size); }
+void operator delete(void* p) noexcept { release(p); }
+void operator delete[](void* p) noexcept { release(p); }
+void operator delete(void* p, std::size_t) noexcept { release(p); }
+void operator delete[](void* p, std::size_t) noexcept { release(p); }
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// ---------------------------------------------------------------------------
+// Harness
+// ---------------------------------------------------------------------------
+
+struct Options {
+    double minSeconds = 0.2;   // per measured batch
+    int repeat = 5;
+    std::string filter;
+    std::string jsonPath;
+};
+
+struct Result {
+    std::string name;
+    const char* unit;          // what one op is: "op", "episode", "card", ...
+    std::uint64_t iterations;  // per measured batch
+    double nsPerOp;            // median over the repeats
+    double minNsPerOp;
+    double allocsPerOp;
+};
+
+// Keeps the optimizer from discarding a result it can see is unused.
+template <typename T>
+void keep(const T& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+// Silences std::cout (the agents report every save and load there) while a
+// benchmark runs, so the table stays readable.
+struct QuietCout {
+    QuietCout() { std::cout.setstate(std::ios::badbit); }
+    ~QuietCout() { std::cout.clear(); }
+};
+
+class Bench {
+private:
+    Options opt;
+    std::vector<Result> results;
+
+    // Seconds taken by `n` ops.
+    static double time(const std::function<void()>& op, std::uint64_t n) {
+        auto start = Clock::now();
+        for (std::uint64_t i = 0; i < n; ++i) op();
+        return std::chrono::duration<double>(Clock::now() - start).count();
+    }
+
+public:
+    explicit Bench(Options o) : opt(std::move(o)) {}
+
+    void run(const std::string& name, const char* unit, const std::function<void()>& op) {
+        if (!opt.filter.empty() && name.find(opt.filter) == std::string::npos) return;
+
+        std::uint64_t n = 1;
+        {
+            QuietCout quiet;
+            while (time(op, n) < opt.minSeconds && n < (std::uint64_t{1} << 40)) n *= 2;
+        }
+
+        std::vector<double> ns;
+        std::uint64_t allocs = 0;
+        {
+            QuietCout quiet;
+            for (int r = 0; r < opt.repeat; ++r) {
+                std::uint64_t before = gAllocations.load(std::memory_order_relaxed);
+                double secs = time(op, n);
+                allocs += gAllocations.load(std::memory_order_relaxed) - before;
+                ns.push_back(secs * 1e9 / static_cast<double>(n));
+            }
+        }
+        std::sort(ns.begin(), ns.end());
+        Result res{name, unit, n, ns[ns.size() / 2], ns.front(),
+                   static_cast<double>(allocs) / static_cast<double>(n * opt.repeat)};
+        results.push_back(res);
+
+        std::cout << std::left << std::setw(34) << name << std::right
+                  << std::setw(14) << std::fixed << std::setprecision(1) << res.nsPerOp
+                  << std::setw(16) << std::setprecision(0) << 1e9 / res.nsPerOp
+                  << " " << std::left << std::setw(10) << (std::string(unit) + "/s") << std::right
+                  << std::setw(10) << std::setprecision(2) << res.allocsPerOp << "\n";
+    }
+
+    void header() const {
+        std::cout << std::left << std::setw(34) << "benchmark" << std::right
+                  << std::setw(14) << "ns/op" << std::setw(16) << "rate"
+                  << " " << std::left << std::setw(10) << "" << std::right
+                  << std::setw(10) << "allocs/op" << "\n";
+    }
+
+    std::string json() const {
+        char when[32];
+        std::time_t now = std::time(nullptr);
+        std::strftime(when, sizeof(when), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+
+        json::Writer w;
+        w.kv("timestamp", when)
+#if defined(__clang__)
+         .kv("compiler", "clang " __clang_version__)
+#elif defined(__GNUC__)
+         .kv("compiler", "gcc " __VERSION__)
+#endif
+#ifdef __OPTIMIZE__
+         .kv("optimized", true)
+#else
+         .kv("optimized", false)
+#endif
+         .kv("minSeconds", opt.minSeconds)
+         .kv("repeat", opt.repeat)
+         .karr("results");
+        for (const Result& r : results) {
+            w.obj()
+                .kv("name", r.name)
+                .kv("unit", r.unit)
+                .kv("iterations", static_cast<long long>(r.iterations))
+                .kv("nsPerOp", r.nsPerOp)
+                .kv("minNsPerOp", r.minNsPerOp)
+                .kv("perSecond", 1e9 / r.nsPerOp)
+                .kv("allocsPerOp", r.allocsPerOp)
+                .end();
+        }
+        w.end();
+        return w.done();
+    }
+};
+
+bool parseArgs(int argc, char** argv, Options& o) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (i + 1 >= argc && arg != "--help") {
+            std::cerr << arg << " needs a value\n";
+            return false;
+        }
+        try {
+            if (arg == "--min-time") o.minSeconds = std::max(0.001, std::stod(argv[++i]));
+            else if (arg == "--repeat") o.repeat = std::max(1, std::stoi(argv[++i]));
+            else if (arg == "--filter") o.filter = argv[++i];
+            else if (arg == "--json") o.jsonPath = argv[++i];
+            else return false;
+        } catch (...) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// Benchmarks
+// ---------------------------------------------------------------------------
+
+constexpr std::uint64_t SEED = 20251026;
+
+// Every state the agents learn over, in a fixed scrambled order, so table
+// lookups do not just walk memory in sequence.
+std::vector<State> scrambledStates() {
+    std::vector<State> states;
+    for (int i = 0; i < STATE_COUNT; ++i) states.push_back(stateAt(i));
+    rng::Stream(SEED).shuffle(states.begin(), states.end());
+    return states;
+}
+
+void cards(Bench& b) {
+    Deck deck;
+    deck.reseed(SEED);
+    b.run("deck/shuffle", "shuffle", [&] { deck.shuffleDeck(); });
+    int dealt = 0;
+    b.run("deck/deal", "card", [&] {
+        if (++dealt == 52) {
+            deck.shuffleDeck();
+            dealt = 0;
+        }
+        keep(deck.dealCard());
+    });
+
+    Shoe shoe;
+    shoe.reseed(SEED);
+    b.run("shoe/deal", "card", [&] {
+        if (shoe.cutCardReached()) shoe.startHand();
+        keep(shoe.dealCard());
+    });
+
+    Player soft("AI");
+    soft.addCard(Card(Suit::Hearts, Rank::Ace));
+    soft.addCard(Card(Suit::Spades, Rank::Six));
+    soft.addCard(Card(Suit::Clubs, Rank::Ace));
+    b.run("player/getHandValue", "op", [&] { keep(soft.getHandValue()); });
+
+    Card upcard(Suit::Diamonds, Rank::Ten);
+    b.run("rules/computeState", "op", [&] { keep(rules::computeState(soft.getHand(), upcard)); });
+
+    Dealer dealer;
+    b.run("dealer/playTurn", "hand", [&] {
+        dealer.clearHand();
+        if (shoe.cutCardReached()) shoe.startHand();
+        dealer.addCard(shoe.dealCard());
+        dealer.addCard(shoe.dealCard());
+        dealer.playTurn(shoe);
+        keep(dealer.getHandValue());
+    });
+}
+
+void episodes(Bench& b) {
+    Game game(0);
+    game.getShoe().reseed(SEED);
+
+    QLearningAI q;
+    QLearningAI::Worker qView = q.worker(SEED);
+    qView.setEpsilon(0.1);
+    b.run("episode/q-learning/train", "episode", [&] { keep(game.playAIEpisode(qView, true)); });
+    b.run("episode/q-learning/greedy", "episode", [&] { keep(game.playAIEpisode(qView, false)); });
+
+    MonteCarloAI mc;
+    mc.reseed(SEED);
+    b.run("episode/monte-carlo/train", "episode", [&] { keep(game.playMonteCarloEpisode(mc, true)); });
+    b.run("episode/monte-carlo/greedy", "episode", [&] { keep(game.playMonteCarloEpisode(mc, false)); });
+}
+
+void updates(Bench& b) {
+    const std::vector<State> states = scrambledStates();
+
+    QLearningAI q;
+    std::size_t i = 0;
+    b.run("q-learning/updateQValue", "update", [&] {
+        const State& s = states[i++ % states.size()];
+        const State& next = states[i % states.size()];
+        q.updateQValue(s, Action::HIT, 0.0, next, false);
+    });
+
+    MonteCarloAI mc;
+    b.run("monte-carlo/updateFromEpisode", "episode", [&] {
+        const State& s = states[i++ % states.size()];
+        const State& next = states[i % states.size()];
+        mc.startEpisode();
+        mc.recordStep(s, Action::HIT, 0.0);
+        mc.recordStep(next, Action::STAND, 1.0);
+        mc.updateFromEpisode();
+    });
+}
+
+void persistence(Bench& b) {
+    // A fully visited table, so the files are their real size.
+    QLearningAI q;
+    MonteCarloAI mc;
+    for (const State& s : scrambledStates()) {
+        q.updateQValue(s, Action::HIT, -0.5, s, true);
+        q.updateQValue(s, Action::STAND, 0.25, s, true);
+        mc.startEpisode();
+        mc.recordStep(s, Action::STAND, 0.25);
+        mc.updateFromEpisode();
+    }
+
+    auto dir = std::filesystem::temp_directory_path();
+    std::string qCsv = (dir / "blackjack_bench_q.csv").string();
+    std::string qBin = (dir / "blackjack_bench_q.bin").string();
+    std::string mcCsv = (dir / "blackjack_bench_mc.csv").string();
+
+    b.run("q-learning/saveCsv", "save", [&] { q.saveQTable(qCsv); });
+    b.run("q-learning/loadCsv", "load", [&] { q.loadQTable(qCsv); });
+    b.run("q-learning/saveBinary", "save", [&] { q.saveQTable(qBin); });
+    b.run("q-learning/loadBinary", "load", [&] { q.loadQTable(qBin); });
+    b.run("monte-carlo/saveCsv", "save", [&] { mc.saveQTable(mcCsv); });
+    b.run("monte-carlo/loadCsv", "load", [&] { mc.loadQTable(mcCsv); });
+
+    for (const std::string& path : {qCsv, qBin, mcCsv}) std::filesystem::remove(path);
+}
+
+// Endpoints whose cost is mostly building JSON, through api::handle as both
+// front ends call it, and the binary decision protocol beside /api/decide.
+// The agents start untrained: no tables are loaded.
+void endpoints(Bench& b) {
+    std::string states;
+    for (int i = 0; i < STATE_COUNT; ++i) {
+        State s = stateAt(i);
+        if (i) states += ',';
+        states += std::to_string(s.playerSum) + ":" + std::to_string(s.dealerUpcard) + ":" +
+                  (s.usableAce ? "1" : "0");
+    }
+
+    api::setSeed(SEED);
+    auto endpoint = [&](const char* name, const char* path, api::Params params) {
+        b.run(name, "request", [&, path, params] { keep(api::handle(path, params).body.size()); });
+    };
+    endpoint("api/status", "/api/status", {});
+    endpoint("api/policy (cached)", "/api/policy", {{"agent", "q"}});
+    endpoint("api/decide (1 state)", "/api/decide", {{"agent", "q"}, {"states", "16:10:0"}});
+    endpoint("api/decide (360 states)", "/api/decide", {{"agent", "q"}, {"states", states}});
+
+    // The same lookups in the Unix socket's binary protocol, minus the socket:
+    // version 1, agent 0 (q), a u16 count, then u16 state indices.
+    auto packed = [](int count) {
+        std::string request = {1, 0, static_cast<char>(count & 0xff), static_cast<char>(count >> 8)};
+        for (int i = 0; i < count; ++i) {
+            int index = count == 1 ? stateIndex(State{16, 10, false}) : i;
+            request += static_cast<char>(index & 0xff);
+            request += static_cast<char>(index >> 8);
+        }
+        return request;
+    };
+    std::string reply;
+    for (int count : {1, STATE_COUNT}) {
+        std::string request = packed(count);
+        std::string name = "api::decidePacked (" + std::to_string(count) +
+                           (count == 1 ? " state)" : " states)");
+        b.run(name, "request", [&, request] {
+            reply.clear();
+            api::decidePacked(request, reply);
+            keep(reply.size());
+        });
+    }
+    endpoint("api/hand/autoplay", "/api/hand/autoplay", {{"agent", "q"}, {"seed", "1"}});
+    endpoint("api/hands/batch (100)", "/api/hands/batch",
+             {{"agent", "q"}, {"hands", "100"}, {"seed", "1"}, {"threads", "1"}});
+    endpoint("api/train/progress", "/api/train/progress", {});
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options opt;
+    if (!parseArgs(argc, argv, opt)) {
+        std::cerr << "usage: blackjack_bench [--filter SUBSTRING] [--min-time SECONDS]"
+                     " [--repeat N] [--json PATH|-]\n";
+        return 2;
+    }
+#ifndef __OPTIMIZE__
+    std::cerr << "warning: built without optimization; numbers will not be representative\n";
+#endif
+
+    Bench b(opt);
+    b.header();
+    cards(b);
+    episodes(b);
+    updates(b);
+    persistence(b);
+    endpoints(b);
+
+    if (!opt.jsonPath.empty()) {
+        std::string body = b.json();
+        if (opt.jsonPath == "-") {
+            std::cout << body << "\n";
+        } else {
+            std::ofstream(opt.jsonPath) << body << "\n";
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,349 @@
+//
+// Actor/learner pipeline; see ActorLearner.h.
+//
+
+#include "../../include/core/ActorLearner.h"
+#include "../../include/core/HandSession.h"
+#include "../../include/core/MpscRing.h"
+#include "../../include/core/Profile.h"
+#include "../../include/core/Random.h"
+#include "../../include/core/TaskPool.h"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// A hand can hold at most 21 one-point cards, so no episode has more steps.
+constexpr int MAX_STEPS = 24;
+
+// Records applied per acquisition of the agent lock.
+constexpr std::size_t LEARNER_BATCH = 256;
+
+// Actors re-read the published snapshot this often (in their own episodes).
+// Cheap, but not free: the shared_ptr atomics take a spinlock in libstdc++.
+constexpr long long ACTOR_REFRESH = 32;
+
+// One episode as the learner needs it: the (state, action) pairs to update, in
+// order, and the terminal payout. ~60 bytes against a Card vector per hand.
+struct EpisodeRecord {
+    std::uint64_t policyVersion = 0;   // snapshot version the actor played
+    float reward = 0.0f;               // payouts are -1, 0, 1, 1.5: exact in a float
+    std::uint8_t length = 0;
+    struct Step {
+        std::uint16_t state;           // stateIndex
+        std::uint8_t action;
+    } steps[MAX_STEPS];
+};
+
+// Replays one record through QLearningAI exactly as playAIEpisode would have
+// called updateQValue: a HIT bootstraps from the next recorded state, or is
+// the terminal bust if it is the last step; STAND is terminal with the payout.
+void learn(QLearningAI& ai, const EpisodeRecord& rec) {
+    for (int i = 0; i < rec.length; ++i) {
+        State s = stateAt(rec.steps[i].state);
+        if (static_cast<Action>(rec.steps[i].action) == Action::HIT) {
+            if (i + 1 < rec.length) {
+                ai.updateQValue(s, Action::HIT, 0.0, stateAt(rec.steps[i + 1].state), false);
+            } else {
+                ai.updateQValue(s, Action::HIT, -1.0, s, true);
+            }
+        } else {
+            ai.updateQValue(s, Action::STAND, rec.reward, s, true);
+        }
+    }
+    ai.recordEpisode(rec.reward);
+}
+
+// Monte Carlo's own episode API, so first-visit handling is untouched.
+void learn(MonteCarloAI& ai, const EpisodeRecord& rec) {
+    ai.startEpisode();
+    for (int i = 0; i < rec.length; ++i) {
+        ai.recordStep(stateAt(rec.steps[i].state), static_cast<Action>(rec.steps[i].action), 0.0);
+    }
+    ai.endEpisode(rec.reward);
+}
+
+} // namespace
+
+struct ActorLearner::Impl {
+    virtual ~Impl() = default;
+    virtual PipelineStats run(long long episodes) = 0;
+};
+
+template <typename AI>
+class ActorLearner::Pipeline : public ActorLearner::Impl {
+public:
+    Pipeline(AI& ai, double epsilonDecay, const Config& cfg, bool implicitStand)
+        : ai(ai), epsilonDecay(epsilonDecay), cfg(cfg), implicitStand(implicitStand),
+          actors(std::max(1u, cfg.actors)), ring(cfg.queueCapacity) {
+        threads.reserve(actors);
+        for (unsigned a = 0; a < actors; ++a) {
+            threads.emplace_back(&Pipeline::actor, this, a);
+        }
+    }
+
+    ~Pipeline() override {
+        {
+            std::lock_guard<std::mutex> lk(mu);
+            shutdown = true;
+        }
+        wake.notify_all();
+        for (auto& t : threads) t.join();
+    }
+
+    PipelineStats run(long long episodes) override;
+
+private:
+    AI& ai;
+    double epsilonDecay;
+    Config cfg;
+    bool implicitStand;   // Q-learning's final STAND update; see play()
+    unsigned actors;
+
+    MpscRing<EpisodeRecord> ring;
+    std::atomic<long long> nextEpisode{0};
+    std::atomic<bool> abort{false};
+    std::shared_ptr<const PolicySnapshot> snapshot;   // std::atomic_load/store only
+
+    // Hand-off between runs. run() writes these under mu only while every
+    // actor is parked; an actor reads them under mu as it wakes, so they are
+    // stable for the whole run.
+    std::mutex mu;
+    std::condition_variable wake;   // actors: a run has started, or shutdown
+    std::condition_variable idle;   // run(): the last actor has parked
+    long long limit = 0;            // episodes in the current run
+    std::uint64_t generation = 0;   // runs started
+    unsigned active = 0;            // actors still in the current run
+    bool shutdown = false;
+    std::vector<profile::Recorder> recorders;   // one per actor, this run
+
+    std::vector<std::thread> threads;
+
+    void actor(unsigned a);
+    void play(Shoe& shoe, rng::Stream& explore, long long& played);
+    void waitIdle();
+};
+
+// One actor for the pipeline's life: its shoe and exploration stream carry
+// over from run to run, so a run continues the actor's hands rather than
+// starting from a fresh seed.
+template <typename AI>
+void ActorLearner::Pipeline<AI>::actor(unsigned a) {
+    rng::Stream seeds(rng::derive(cfg.seed, a));
+    Shoe shoe(cfg.decks);
+    shoe.reseed(seeds());
+    rng::Stream explore(seeds());
+
+    long long played = 0;
+    std::uint64_t seen = 0;
+    for (;;) {
+        profile::Recorder* recorder;
+        {
+            std::unique_lock<std::mutex> lk(mu);
+            wake.wait(lk, [&] { return shutdown || generation != seen; });
+            if (shutdown) return;
+            seen = generation;
+            recorder = recorders.empty() ? nullptr : &recorders[a];
+        }
+        {
+            profile::Attach attach(recorder);
+            play(shoe, explore, played);
+        }
+        std::lock_guard<std::mutex> lk(mu);
+        if (--active == 0) idle.notify_all();
+    }
+}
+
+// Plays episodes against the latest snapshot until the run's counter runs out.
+//
+// The hand itself is HandSession, so actors follow exactly the flow of
+// Game::playAIEpisode. With implicitStand, a hand that reached 21 without
+// choosing STAND gets the STAND step Q-learning's final update applies there;
+// Monte Carlo records decisions only.
+template <typename AI>
+void ActorLearner::Pipeline<AI>::play(Shoe& shoe, rng::Stream& explore, long long& played) {
+    std::shared_ptr<const PolicySnapshot> snap = std::atomic_load(&snapshot);
+
+    for (;;) {
+        long long k = nextEpisode.fetch_add(1);
+        if (k >= limit || abort.load()) return;
+        if (++played % ACTOR_REFRESH == 0) {
+            snap = std::atomic_load(&snapshot);
+        }
+
+        PROFILE_SCOPE(Episode);
+        // ai's epsilon is the schedule's origin and is only written between
+        // runs, so actors may read it here.
+        double epsilon = ai.epsilonAfter(k, epsilonDecay);
+        EpisodeRecord rec;
+        rec.policyVersion = snap->version;
+
+        HandSession hand(shoe);
+        while (hand.playerCanAct() && rec.length < MAX_STEPS) {
+            State s = hand.state();
+            Action a;
+            {
+                PROFILE_SCOPE(Decide);
+                a = explore.uniform() < epsilon
+                    ? ((explore.uniform() < 0.5) ? Action::HIT : Action::STAND)
+                    : snap->best(s);
+            }
+            rec.steps[rec.length++] = {static_cast<std::uint16_t>(stateIndex(s)),
+                                       static_cast<std::uint8_t>(a)};
+            if (a == Action::STAND) break;
+            hand.hit();
+        }
+        if (!hand.finished()) hand.stand();
+
+        bool choseStand = rec.length > 0 &&
+            rec.steps[rec.length - 1].action == static_cast<std::uint8_t>(Action::STAND);
+        if (implicitStand && !hand.playerBusted() && !choseStand && rec.length < MAX_STEPS) {
+            rec.steps[rec.length++] = {static_cast<std::uint16_t>(stateIndex(hand.state())),
+                                       static_cast<std::uint8_t>(Action::STAND)};
+        }
+        rec.reward = static_cast<float>(hand.reward());
+
+        while (!ring.tryPush(rec)) {
+            if (abort.load()) return;
+            std::this_thread::yield();
+        }
+    }
+}
+
+template <typename AI>
+void ActorLearner::Pipeline<AI>::waitIdle() {
+    std::unique_lock<std::mutex> lk(mu);
+    idle.wait(lk, [&] { return active == 0; });
+}
+
+template <typename AI>
+PipelineStats ActorLearner::Pipeline<AI>::run(long long episodes) {
+    PipelineStats stats;
+    if (episodes <= 0) return stats;
+
+    // Whatever happened to the table since the last run (that run's final
+    // batches, a publish) is what the actors start from.
+    std::atomic_store(&snapshot, std::make_shared<const PolicySnapshot>(ai.snapshot()));
+
+    // Actors time their episodes into their own recorders, merged at the end;
+    // the learner's updates go to the caller's.
+    profile::Recorder* recorder = profile::current();
+    {
+        std::lock_guard<std::mutex> lk(mu);
+        limit = episodes;
+        nextEpisode.store(0);
+        recorders.clear();
+        if (recorder) {
+            for (unsigned a = 0; a < actors; ++a) recorders.push_back(recorder->fork(a + 1));
+        }
+        active = actors;
+        ++generation;
+    }
+    wake.notify_all();
+
+    std::vector<EpisodeRecord> batch;
+    batch.reserve(LEARNER_BATCH);
+    long long learned = 0, sinceRefresh = 0, samples = 0;
+    double depthSum = 0.0, lagSum = 0.0;
+
+    // Lowered when a stop is requested: to the episodes actors had claimed by
+    // then, every one of which is still played and learned.
+    long long target = episodes;
+    bool stopping = false;
+
+    try {
+        while (learned < target) {
+            if (!stopping && cfg.stop && cfg.stop->load(std::memory_order_relaxed)) {
+                // Claims from here on are past the end, so actors park; those
+                // below `claimed` were taken before and will still arrive.
+                long long claimed = nextEpisode.exchange(episodes);
+                target = std::min(claimed, episodes);
+                stopping = true;
+                continue;
+            }
+
+            std::size_t depth = ring.depth();
+            depthSum += static_cast<double>(depth);
+            stats.maxQueueDepth = std::max(stats.maxQueueDepth, depth);
+            ++samples;
+
+            batch.clear();
+            EpisodeRecord rec;
+            while (batch.size() < LEARNER_BATCH && ring.tryPop(rec)) {
+                batch.push_back(rec);
+            }
+            if (batch.empty()) {
+                std::this_thread::yield();
+                continue;
+            }
+
+            {
+                std::unique_lock<metrics::TimedSharedMutex> lk;
+                if (cfg.agentLock) lk = std::unique_lock<metrics::TimedSharedMutex>(*cfg.agentLock);
+                for (const EpisodeRecord& r : batch) {
+                    lagSum += static_cast<double>(
+                        static_cast<std::uint64_t>(ai.getEpisodeCount()) - r.policyVersion);
+                    learn(ai, r);
+                    stats.tally.add(r.reward);
+                }
+            }
+
+            learned += static_cast<long long>(batch.size());
+            sinceRefresh += static_cast<long long>(batch.size());
+            if (sinceRefresh >= cfg.refreshEpisodes && learned < target) {
+                std::atomic_store(&snapshot,
+                                  std::make_shared<const PolicySnapshot>(ai.snapshot()));
+                ++stats.snapshots;
+                sinceRefresh = 0;
+            }
+        }
+    } catch (...) {
+        // Park the actors and drop what they played, so the next run starts
+        // from an empty ring.
+        abort.store(true);
+        waitIdle();
+        EpisodeRecord rec;
+        while (ring.tryPop(rec)) {}
+        abort.store(false);
+        throw;
+    }
+
+    waitIdle();
+    for (const profile::Recorder& r : recorders) recorder->merge(r);
+
+    {
+        std::unique_lock<metrics::TimedSharedMutex> lk;
+        if (cfg.agentLock) lk = std::unique_lock<metrics::TimedSharedMutex>(*cfg.agentLock);
+        ai.setEpsilon(ai.epsilonAfter(learned, epsilonDecay));
+    }
+
+    stats.meanQueueDepth = samples > 0 ? depthSum / static_cast<double>(samples) : 0.0;
+    stats.meanActorLag = learned > 0 ? lagSum / static_cast<double>(learned) : 0.0;
+    return stats;
+}
+
+bool ActorLearner::supported() {
+#if defined(__EMSCRIPTEN__) && !defined(__EMSCRIPTEN_PTHREADS__)
+    return false;
+#else
+    return true;
+#endif
+}
+
+ActorLearner::ActorLearner(QLearningAI& ai, double epsilonDecay, const Config& cfg)
+    : impl(std::make_unique<Pipeline<QLearningAI>>(ai, epsilonDecay, cfg, true)) {}
+
+ActorLearner::ActorLearner(MonteCarloAI& ai, double epsilonDecay, const Config& cfg)
+    : impl(std::make_unique<Pipeline<MonteCarloAI>>(ai, epsilonDecay, cfg, false)) {}
+
+ActorLearner::~ActorLearner() = default;
+
+PipelineStats ActorLearner::run(long long episodes) {
+    return impl->run(episodes);
+}
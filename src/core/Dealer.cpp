@@ -3,10 +3,12 @@
 //
 
 #include "../../include/core/Dealer.h"
+#include "../../include/core/Profile.h"
 
-void Dealer::playTurn(Deck &deck) {
+void Dealer::playTurn(Shoe &shoe) {
+    PROFILE_SCOPE(Dealer);
     while (getHandValue() < 17) {
-        addCard(deck.dealCard());
+        addCard(shoe.dealCard());
     }
 }
 void Dealer::showHand(bool hideFirstCard) const {
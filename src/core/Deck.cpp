@@ -3,11 +3,10 @@
 //
 
 #include "../../include/core/Deck.h"
-#include <random>
 #include <algorithm>
 #include <stdexcept>
 
-Deck::Deck() {
+Deck::Deck() : stream(rng::nextSeed(rng::Domain::Deck)) {
     generateDeck();
     shuffleDeck();
     currentCardIndex = 0;
@@ -27,9 +26,7 @@ void Deck::generateDeck() {
 }
 
 void Deck::shuffleDeck() {
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::shuffle(cards.begin(), cards.end(), gen);
+    stream.shuffle(cards.begin(), cards.end());
     currentCardIndex = 0;
 }
 Card Deck::dealCard() {
@@ -3,14 +3,20 @@
 //
 
 #include "../../include/core/Game.h"
+#include "../../include/core/Profile.h"
+#include "../../include/core/Random.h"
 #include "../../include/core/Rules.h"
+#include "../../include/core/TaskPool.h"
+#include <algorithm>
+#include <atomic>
 #include <iostream>
 #include <limits>
 #include <iomanip>
 
 using namespace std;
 
-Game::Game(int numPlayers) : numPlayers(numPlayers) {
+Game::Game(int numPlayers, int numDecks, double penetration)
+    : shoe(numDecks, penetration), numPlayers(numPlayers) {
     players.reserve(numPlayers);
     for (int i = 0; i < numPlayers; ++i) {
         string name;
@@ -21,9 +27,9 @@ Game::Game(int numPlayers) : numPlayers(numPlayers) {
 }
 
 void Game::initializeGame() {
-    deck = Deck();
-    deck.generateDeck();
-    deck.shuffleDeck();
+    // The shoe persists across hands and only reshuffles once the cut card
+    // has come out, so most hands pay nothing here beyond clearing.
+    shoe.startHand();
     dealer.clearHand();
     for (auto& player : players) {
         player.clearHand();
@@ -33,9 +39,9 @@ void Game::initializeGame() {
 void Game::dealInitialCards() {
     for (int i = 0; i < 2; ++i) {
         for (auto& player : players) {
-            player.addCard(deck.dealCard());
+            player.addCard(shoe.dealCard());
         }
-        dealer.addCard(deck.dealCard());
+        dealer.addCard(shoe.dealCard());
     }
 }
 
@@ -62,7 +68,7 @@ void Game::playerTurn(Player& player) {
         }
 
         if (choice == 'h' || choice == 'H') {
-            player.addCard(deck.dealCard());
+            player.addCard(shoe.dealCard());
         } else if (choice == 's' || choice == 'S') {
             cout << player.getName() << " stands.\n";
             break;
@@ -75,7 +81,7 @@ void Game::playerTurn(Player& player) {
 void Game::dealerTurn() {
     cout << "\n--- Dealer's Turn ---" << endl;
     dealer.revealHand();
-    dealer.playTurn(deck);
+    dealer.playTurn(shoe);
 }
 
 void Game::determineWinners() {
@@ -139,6 +145,7 @@ void Game::playRound() {
 // State encoding and payout live in rules:: so that HandSession (which drives
 // the web demo one action at a time) shares them byte-for-byte with the CLI.
 State Game::getAIState(const Player& player) const {
+    PROFILE_SCOPE(Encode);
     const auto& dealerHand = dealer.getHand();
     if (dealerHand.empty()) {
         throw std::runtime_error("Dealer has no cards!");
@@ -147,34 +154,56 @@ State Game::getAIState(const Player& player) const {
 }
 
 double Game::calculateReward(const Player& player) const {
+    PROFILE_SCOPE(Settle);
     return rules::computeReward(player, dealer);
 }
 
 double Game::playAIEpisode(QLearningAI& ai, bool training) {
-    // Initialize fresh game
-    initializeGame();
+    return playQEpisode(ai, training);
+}
+
+double Game::playAIEpisode(QLearningAI::Worker& ai, bool training) {
+    return playQEpisode(ai, training);
+}
+
+template <typename Agent>
+double Game::playQEpisode(Agent& ai, bool training) {
+    PROFILE_SCOPE(Episode);
 
     // Create AI player
     Player aiPlayer("AI", false);
-    aiPlayer.addCard(deck.dealCard());
-    aiPlayer.addCard(deck.dealCard());
+    {
+        PROFILE_SCOPE(Deal);
+        // Clear hands; reshuffle only if the cut card came out last hand
+        initializeGame();
 
-    dealer.addCard(deck.dealCard());
-    dealer.addCard(deck.dealCard());
+        aiPlayer.addCard(shoe.dealCard());
+        aiPlayer.addCard(shoe.dealCard());
+
+        dealer.addCard(shoe.dealCard());
+        dealer.addCard(shoe.dealCard());
+    }
 
     // AI's turn
     while (!aiPlayer.isBusted() && aiPlayer.getHandValue() < 21) {
         State currentState = getAIState(aiPlayer);
 
         // Choose action
-        Action action = training ? ai.chooseAction(currentState) : ai.getBestAction(currentState);
+        Action action;
+        {
+            PROFILE_SCOPE(Decide);
+            action = training ? ai.chooseAction(currentState) : ai.getBestAction(currentState);
+        }
 
         if (action == Action::STAND) {
             break;
         }
 
         // HIT
-        aiPlayer.addCard(deck.dealCard());
+        {
+            PROFILE_SCOPE(Draw);
+            aiPlayer.addCard(shoe.dealCard());
+        }
         State nextState = getAIState(aiPlayer);
 
         // Exactly one update per transition. Drawing carries no intrinsic
@@ -195,7 +224,7 @@ double Game::playAIEpisode(QLearningAI& ai, bool training) {
     }
 
     // Dealer's turn
-    dealer.playTurn(deck);
+    dealer.playTurn(shoe);
 
     // Calculate final reward
     double reward = calculateReward(aiPlayer);
@@ -249,6 +278,113 @@ void Game::trainAI(QLearningAI& ai, int numEpisodes, bool verbose) {
     ai.printStats();
 }
 
+EpisodeTally Game::runParallelAIEpisodes(QLearningAI& ai, long long numEpisodes,
+                                        unsigned threads, double epsilonDecay,
+                                        std::uint64_t seed, int numDecks,
+                                        const std::atomic<bool>* stop) {
+    // Small enough that workers finish within a few episodes of each other,
+    // large enough that the shared counter is not contended.
+    constexpr long long BATCH = 64;
+
+    if (threads == 0) {
+        threads = TaskPool::shared().concurrency();
+    }
+
+    // Workers are made up front: ai itself is only read while they run.
+    // Their streams are replaced batch by batch below.
+    std::vector<QLearningAI::Worker> views;
+    views.reserve(threads);
+    for (unsigned w = 0; w < threads; ++w) {
+        views.push_back(ai.worker(seed));
+    }
+
+    std::atomic<long long> nextEpisode{0};
+    std::vector<EpisodeTally> parts(threads);
+
+    // Workers time their episodes into their own recorders, merged below.
+    profile::Recorder* recorder = profile::current();
+    std::vector<profile::Recorder> recorders;
+    if (recorder) {
+        for (unsigned w = 0; w < threads; ++w) recorders.push_back(recorder->fork(w + 1));
+    }
+
+    TaskPool::shared().parallelFor(threads, [&](std::size_t w) {
+        QLearningAI::Worker& view = views[w];
+        Game game(0, numDecks);
+        EpisodeTally local;
+        profile::Attach attach(recorder ? &recorders[w] : nullptr);
+
+        auto stopped = [stop] { return stop && stop->load(std::memory_order_relaxed); };
+        while (!stopped()) {
+            long long first = nextEpisode.fetch_add(BATCH);
+            if (first >= numEpisodes) break;
+            long long last = std::min(first + BATCH, numEpisodes);
+
+            // The batch's hands and exploration depend on its index alone.
+            rng::Stream batch(rng::derive(seed, static_cast<std::uint64_t>(first / BATCH)));
+            game.getShoe().reseed(batch());
+            view.reseed(batch());
+            view.setEpsilon(ai.epsilonAfter(first, epsilonDecay));
+            for (long long e = first; e < last && !stopped(); ++e) {
+                local.add(game.playAIEpisode(view, true));
+                view.decayEpsilon(epsilonDecay);
+            }
+        }
+        parts[w] = local;
+    }, threads);
+
+    EpisodeTally total;
+    for (const EpisodeTally& part : parts) {
+        total.merge(part);
+    }
+    for (const profile::Recorder& r : recorders) {
+        recorder->merge(r);
+    }
+    return total;
+}
+
+void Game::trainAIParallel(QLearningAI& ai, int numEpisodes, unsigned threads, bool verbose) {
+    if (threads == 0) {
+        threads = TaskPool::shared().concurrency();
+    }
+    cout << "\n=== Training Q-Learning AI (parallel) ===\n";
+    cout << "Episodes: " << numEpisodes << "\n";
+    cout << "Threads: " << threads << "\n\n";
+
+    // Ten slices so progress can be reported as trainAI does; the workers
+    // are re-spawned per slice, which costs nothing next to 10% of a run.
+    EpisodeTally total;
+    int slices = verbose ? 10 : 1;
+    long long done = 0;
+    std::uint64_t seed = rng::nextSeed(rng::Domain::Job);
+    for (int slice = 1; slice <= slices; ++slice) {
+        long long target = static_cast<long long>(numEpisodes) * slice / slices;
+        EpisodeTally t = runParallelAIEpisodes(ai, target - done, threads, 0.99995,
+                                               rng::derive(seed, static_cast<std::uint64_t>(slice)),
+                                               shoe.numDecks());
+        ai.recordEpisodes(static_cast<int>(t.episodes), t.reward);
+        ai.setEpsilon(ai.epsilonAfter(t.episodes, 0.99995));
+        total.merge(t);
+        done = target;
+
+        if (verbose) {
+            cout << "Episode " << done << "/" << numEpisodes
+                 << " | Wins: " << total.wins << " | Losses: " << total.losses
+                 << " | Pushes: " << total.pushes
+                 << " | Avg Reward: " << fixed << setprecision(3)
+                 << (total.reward / std::max<long long>(1, done)) << "\n";
+        }
+    }
+
+    cout << "\n=== Training Complete ===\n";
+    cout << "Total Wins: " << total.wins << " (" << (100.0 * total.wins / numEpisodes) << "%)\n";
+    cout << "Total Losses: " << total.losses << " (" << (100.0 * total.losses / numEpisodes) << "%)\n";
+    cout << "Total Pushes: " << total.pushes << " (" << (100.0 * total.pushes / numEpisodes) << "%)\n";
+    cout << "Average Reward: " << (total.reward / numEpisodes) << "\n\n";
+
+    ai.printStats();
+}
+
 void Game::evaluateAI(QLearningAI& ai, int numGames) {
     cout << "\n=== Evaluating AI (Greedy Policy) ===\n";
 
@@ -276,14 +412,19 @@ void Game::evaluateAI(QLearningAI& ai, int numGames) {
 }
 
 double Game::playMonteCarloEpisode(MonteCarloAI& ai, bool training) {
-    initializeGame();
+    PROFILE_SCOPE(Episode);
 
     Player aiPlayer("AI", false);
-    aiPlayer.addCard(deck.dealCard());
-    aiPlayer.addCard(deck.dealCard());
+    {
+        PROFILE_SCOPE(Deal);
+        initializeGame();
+
+        aiPlayer.addCard(shoe.dealCard());
+        aiPlayer.addCard(shoe.dealCard());
 
-    dealer.addCard(deck.dealCard());
-    dealer.addCard(deck.dealCard());
+        dealer.addCard(shoe.dealCard());
+        dealer.addCard(shoe.dealCard());
+    }
 
     if (training) {
         ai.startEpisode();
@@ -293,7 +434,11 @@ double Game::playMonteCarloEpisode(MonteCarloAI& ai, bool training) {
     while (!aiPlayer.isBusted() && aiPlayer.getHandValue() < 21) {
         State currentState = getAIState(aiPlayer);
 
-        Action action = training ? ai.chooseAction(currentState) : ai.getBestAction(currentState);
+        Action action;
+        {
+            PROFILE_SCOPE(Decide);
+            action = training ? ai.chooseAction(currentState) : ai.getBestAction(currentState);
+        }
 
         if (action == Action::STAND) {
             if (training) {
@@ -308,7 +453,10 @@ double Game::playMonteCarloEpisode(MonteCarloAI& ai, bool training) {
             ai.recordStep(currentState, action, 0.0);
         }
 
-        aiPlayer.addCard(deck.dealCard());
+        {
+            PROFILE_SCOPE(Draw);
+            aiPlayer.addCard(shoe.dealCard());
+        }
 
         if (aiPlayer.isBusted()) {
             if (training) {
@@ -319,7 +467,7 @@ double Game::playMonteCarloEpisode(MonteCarloAI& ai, bool training) {
     }
 
     // Dealer's turn
-    dealer.playTurn(deck);
+    dealer.playTurn(shoe);
 
     // Calculate final reward
     double reward = calculateReward(aiPlayer);
@@ -3,16 +3,31 @@
 //
 
 #include "../../include/core/HandSession.h"
+#include "../../include/core/Profile.h"
 
-HandSession::HandSession()
-    : player("AI", false), settled(false), finalReward(0.0) {
-    player.addCard(deck.dealCard());
-    player.addCard(deck.dealCard());
-    dealer.addCard(deck.dealCard());
-    dealer.addCard(deck.dealCard());
+HandSession::HandSession(Shoe& source) : HandSession() {
+    deal(source);
+}
+
+HandSession::HandSession() : player("AI", false), settled(true), finalReward(0.0) {}
+
+void HandSession::deal(Shoe& source) {
+    PROFILE_SCOPE(Deal);
+    shoe = &source;
+    player.clearHand();
+    dealer.clearHand();
+    settled = false;
+    finalReward = 0.0;
+
+    shoe->startHand();
+    player.addCard(shoe->dealCard());
+    player.addCard(shoe->dealCard());
+    dealer.addCard(shoe->dealCard());
+    dealer.addCard(shoe->dealCard());
 }
 
 State HandSession::state() const {
+    PROFILE_SCOPE(Encode);
     // dealerHand[0] is the upcard the agent conditions on, matching
     // Game::getAIState. (Dealer::showHand renders index 0 as the hidden card,
     // but the state encoding has always used it -- kept identical here so the
@@ -28,7 +43,8 @@ void HandSession::hit() {
     if (settled) {
         return;
     }
-    player.addCard(deck.dealCard());
+    PROFILE_SCOPE(Draw);
+    player.addCard(shoe->dealCard());
 
     // Matches playAIEpisode: a bust ends the hand at -1.0 without the dealer
     // ever drawing.
@@ -42,11 +58,12 @@ void HandSession::stand() {
     if (settled) {
         return;
     }
-    dealer.playTurn(deck);
+    dealer.playTurn(*shoe);
     settle();
 }
 
 void HandSession::settle() {
+    PROFILE_SCOPE(Settle);
     settled = true;
     finalReward = rules::computeReward(player, dealer);
 }
@@ -0,0 +1,250 @@
+//
+// Metrics registry and Prometheus text rendering; see Metrics.h.
+//
+
+#include "../../include/core/Metrics.h"
+
+#include <cstdio>
+#include <stdexcept>
+
+namespace metrics {
+
+namespace {
+
+std::atomic<std::size_t> gNextShard{0};
+
+// Prometheus label values escape backslash, double quote and newline.
+std::string escape(const std::string& s) {
+    std::string out;
+    out.reserve(s.size());
+    for (char c : s) {
+        if (c == '\\') out += "\\\\";
+        else if (c == '"') out += "\\\"";
+        else if (c == '\n') out += "\\n";
+        else out += c;
+    }
+    return out;
+}
+
+std::string labelText(const Labels& labels) {
+    if (labels.empty()) return std::string();
+    std::string out = "{";
+    for (std::size_t i = 0; i < labels.size(); ++i) {
+        if (i) out += ',';
+        out += labels[i].first + "=\"" + escape(labels[i].second) + "\"";
+    }
+    return out + "}";
+}
+
+// `labels` with one more label appended: {a="1"} + le -> {a="1",le="0.5"}.
+std::string withLabel(const std::string& labels, const std::string& extra) {
+    if (labels.empty()) return "{" + extra + "}";
+    return labels.substr(0, labels.size() - 1) + "," + extra + "}";
+}
+
+std::string number(double v) {
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "%.17g", v);
+    return buf;
+}
+
+std::string bound(double v) {
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "%g", v);
+    return buf;
+}
+
+thread_local std::chrono::steady_clock::time_point tSharedSince;
+
+} // namespace
+
+std::size_t shardIndex() {
+    thread_local std::size_t index =
+        gNextShard.fetch_add(1, std::memory_order_relaxed) % SHARDS;
+    return index;
+}
+
+// --- Counter / Histogram ----------------------------------------------------
+
+std::uint64_t Counter::value() const {
+    std::uint64_t total = 0;
+    for (const Cell& c : cells) total += c.value.load(std::memory_order_relaxed);
+    return total;
+}
+
+Histogram::Histogram(const std::vector<double>& bounds_) : bounds(bounds_) {
+    if (bounds.size() > MAX_BOUNDS) throw std::logic_error("too many histogram buckets");
+}
+
+Histogram::Totals Histogram::totals() const {
+    Totals t;
+    t.cumulative.assign(bounds.size() + 1, 0);
+    for (const Shard& s : shards) {
+        for (std::size_t b = 0; b <= bounds.size(); ++b) {
+            t.cumulative[b] += s.counts[b].load(std::memory_order_relaxed);
+        }
+        t.sum += s.sum.load(std::memory_order_relaxed);
+    }
+    for (std::size_t b = 1; b < t.cumulative.size(); ++b) t.cumulative[b] += t.cumulative[b - 1];
+    return t;
+}
+
+const std::vector<double>& latencyBuckets() {
+    static const std::vector<double> b = {
+        1e-5, 2.5e-5, 5e-5, 1e-4, 2.5e-4, 5e-4, 1e-3, 2.5e-3, 5e-3, 0.01,
+        0.025, 0.05, 0.1, 0.25, 0.5, 1, 2.5, 5, 10};
+    return b;
+}
+
+const std::vector<double>& lockBuckets() {
+    static const std::vector<double> b = {
+        1e-6, 2.5e-6, 5e-6, 1e-5, 2.5e-5, 5e-5, 1e-4, 2.5e-4, 5e-4, 1e-3,
+        2.5e-3, 5e-3, 0.01, 0.025, 0.05, 0.1, 0.25, 0.5, 1};
+    return b;
+}
+
+// --- Registry -----------------------------------------------------------------
+
+Registry& Registry::global() {
+    static Registry registry;
+    return registry;
+}
+
+Registry::Series& Registry::series(const std::string& name, const std::string& help, Type type,
+                                   const Labels& labels) {
+    auto it = families.find(name);
+    if (it == families.end()) {
+        it = families.emplace(name, Family{type, help, {}}).first;
+    } else if (it->second.type != type) {
+        throw std::logic_error("metric " + name + " registered with another type");
+    }
+    std::string text = labelText(labels);
+    for (Series& s : it->second.series) {
+        if (s.labels == text) return s;
+    }
+    it->second.series.push_back(Series{text, nullptr, nullptr, nullptr});
+    return it->second.series.back();
+}
+
+Counter& Registry::counter(const std::string& name, const std::string& help, const Labels& labels) {
+    std::lock_guard<std::mutex> lk(mu);
+    Series& s = series(name, help, Type::Counter, labels);
+    if (!s.counter) s.counter = std::make_unique<Counter>();
+    return *s.counter;
+}
+
+Gauge& Registry::gauge(const std::string& name, const std::string& help, const Labels& labels) {
+    std::lock_guard<std::mutex> lk(mu);
+    Series& s = series(name, help, Type::Gauge, labels);
+    if (!s.gauge) s.gauge = std::make_unique<Gauge>();
+    return *s.gauge;
+}
+
+Histogram& Registry::histogram(const std::string& name, const std::string& help,
+                               const std::vector<double>& bounds, const Labels& labels) {
+    std::lock_guard<std::mutex> lk(mu);
+    Series& s = series(name, help, Type::Histogram, labels);
+    if (!s.histogram) s.histogram = std::make_unique<Histogram>(bounds);
+    return *s.histogram;
+}
+
+std::string Registry::render() const {
+    static const char* const TYPE_NAMES[] = {"counter", "gauge", "histogram"};
+
+    std::lock_guard<std::mutex> lk(mu);
+    std::string out;
+    for (const auto& entry : families) {
+        const std::string& name = entry.first;
+        const Family& f = entry.second;
+        out += "# HELP " + name + " " + f.help + "\n";
+        out += "# TYPE " + name + " " + TYPE_NAMES[static_cast<int>(f.type)] + "\n";
+        for (const Series& s : f.series) {
+            switch (f.type) {
+            case Type::Counter:
+                out += name + s.labels + " " + std::to_string(s.counter->value()) + "\n";
+                break;
+            case Type::Gauge:
+                out += name + s.labels + " " + number(s.gauge->value()) + "\n";
+                break;
+            case Type::Histogram: {
+                Histogram::Totals t = s.histogram->totals();
+                const std::vector<double>& bounds = s.histogram->upperBounds();
+                for (std::size_t b = 0; b <= bounds.size(); ++b) {
+                    std::string le = b < bounds.size() ? bound(bounds[b]) : "+Inf";
+                    out += name + "_bucket" + withLabel(s.labels, "le=\"" + le + "\"") + " " +
+                           std::to_string(t.cumulative[b]) + "\n";
+                }
+                out += name + "_sum" + s.labels + " " + number(t.sum) + "\n";
+                out += name + "_count" + s.labels + " " + std::to_string(t.cumulative.back()) + "\n";
+                break;
+            }
+            }
+        }
+    }
+    return out;
+}
+
+// --- TimedSharedMutex ---------------------------------------------------------
+
+void TimedSharedMutex::instrument(Registry& registry, const std::string& waitName,
+                                  const std::string& holdName, const Labels& labels) {
+    Labels exclusive = labels, shared = labels;
+    exclusive.emplace_back("mode", "exclusive");
+    shared.emplace_back("mode", "shared");
+    const std::string waitHelp = "Time spent waiting to acquire the lock, in seconds.";
+    const std::string holdHelp = "Time the lock was held, in seconds (exclusive holds sampled 1 in " +
+                                 std::to_string(HOLD_SAMPLE) + ").";
+    waitExclusive = &registry.histogram(waitName, waitHelp, lockBuckets(), exclusive);
+    waitShared    = &registry.histogram(waitName, waitHelp, lockBuckets(), shared);
+    holdExclusive = &registry.histogram(holdName, holdHelp, lockBuckets(), exclusive);
+    holdShared    = &registry.histogram(holdName, holdHelp, lockBuckets(), shared);
+}
+
+void TimedSharedMutex::lock() {
+    if (mu.try_lock()) {
+        if (waitExclusive) waitExclusive->observe(0.0);
+    } else {
+        Clock::time_point start = Clock::now();
+        mu.lock();
+        if (waitExclusive) waitExclusive->observe(secondsSince(start));
+    }
+    timingHold = holdExclusive && ++acquisitions % HOLD_SAMPLE == 0;
+    if (timingHold) heldSince = Clock::now();
+}
+
+bool TimedSharedMutex::try_lock() {
+    if (!mu.try_lock()) return false;
+    timingHold = false;
+    return true;
+}
+
+void TimedSharedMutex::unlock() {
+    if (timingHold) holdExclusive->observe(secondsSince(heldSince));
+    mu.unlock();
+}
+
+// A thread holds at most one agent's lock shared at a time, so one start time
+// per thread is enough.
+void TimedSharedMutex::lock_shared() {
+    if (mu.try_lock_shared()) {
+        if (waitShared) waitShared->observe(0.0);
+    } else {
+        Clock::time_point start = Clock::now();
+        mu.lock_shared();
+        if (waitShared) waitShared->observe(secondsSince(start));
+    }
+    if (holdShared) tSharedSince = Clock::now();
+}
+
+bool TimedSharedMutex::try_lock_shared() {
+    if (!mu.try_lock_shared()) return false;
+    if (holdShared) tSharedSince = Clock::now();
+    return true;
+}
+
+void TimedSharedMutex::unlock_shared() {
+    if (holdShared) holdShared->observe(secondsSince(tSharedSince));
+    mu.unlock_shared();
+}
+
+} // namespace metrics
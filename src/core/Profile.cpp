@@ -0,0 +1,118 @@
+//
+// Phase timers and Chrome trace export; see Profile.h.
+//
+
+#include "../../include/core/Profile.h"
+
+#include <algorithm>
+#include <cstdio>
+
+namespace profile {
+
+namespace {
+
+thread_local Recorder* tCurrent = nullptr;
+
+// Trace timestamps count from here, so every thread's events share one clock.
+const Clock::time_point gEpoch = Clock::now();
+
+const char* const NAMES[PHASE_COUNT] = {
+    "episode", "deal", "encode", "decide", "draw",
+    "dealer", "settle", "update", "schedule", "publish"};
+
+} // namespace
+
+const char* name(Phase p) {
+    return NAMES[static_cast<std::size_t>(p)];
+}
+
+Recorder* current() {
+    return tCurrent;
+}
+
+Attach::Attach(Recorder* r) : previous(tCurrent) {
+    tCurrent = r;
+}
+
+Attach::~Attach() {
+    tCurrent = previous;
+}
+
+Recorder::Recorder(long long traceEvery_, std::uint32_t tid_)
+    : traceEvery(std::max(0LL, traceEvery_)), tid(tid_) {}
+
+// Inside an episode, a phase is traced if its episode is. Outside one -- the
+// learner's updates, scheduling, publication -- scheduling and publication
+// are rare enough to trace every time, and the rest one in `traceEvery`.
+void Recorder::record(Phase p, Clock::time_point start, Clock::time_point end) {
+    PhaseTotal& t = phases[static_cast<std::size_t>(p)];
+    long long ns = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+    ++t.count;
+    t.nanos += ns;
+    if (p == Phase::Episode) {
+        ++episodes;
+        inEpisode = false;
+    }
+    if (traceEvery == 0) return;
+
+    bool trace;
+    if (inEpisode || p == Phase::Episode) {
+        trace = sampling;
+    } else if (p == Phase::Schedule || p == Phase::Publish) {
+        trace = true;
+    } else {
+        trace = loose++ % traceEvery == 0;
+    }
+    if (trace && events.size() < MAX_TRACE_EVENTS) {
+        events.push_back({p, tid,
+                          std::chrono::duration_cast<std::chrono::nanoseconds>(
+                              start - gEpoch).count(),
+                          ns});
+    }
+}
+
+void Recorder::merge(const Recorder& other) {
+    for (std::size_t i = 0; i < PHASE_COUNT; ++i) {
+        phases[i].count += other.phases[i].count;
+        phases[i].nanos += other.phases[i].nanos;
+    }
+    std::size_t room = MAX_TRACE_EVENTS - std::min(MAX_TRACE_EVENTS, events.size());
+    std::size_t take = std::min(room, other.events.size());
+    events.insert(events.end(), other.events.begin(),
+                  other.events.begin() + static_cast<std::ptrdiff_t>(take));
+}
+
+std::string Recorder::table() const {
+    double episodeNs = static_cast<double>(total(Phase::Episode).nanos);
+    std::string out;
+    char line[128];
+    std::snprintf(line, sizeof(line), "%-10s %12s %12s %10s %8s\n",
+                  "phase", "count", "total ms", "mean ns", "share");
+    out += line;
+    for (std::size_t i = 0; i < PHASE_COUNT; ++i) {
+        const PhaseTotal& t = phases[i];
+        if (t.count == 0) continue;
+        double share = episodeNs > 0 ? 100.0 * static_cast<double>(t.nanos) / episodeNs : 0.0;
+        std::snprintf(line, sizeof(line), "%-10s %12lld %12.3f %10.1f %7.1f%%\n",
+                      NAMES[i], t.count, static_cast<double>(t.nanos) / 1e6,
+                      static_cast<double>(t.nanos) / static_cast<double>(t.count), share);
+        out += line;
+    }
+    return out;
+}
+
+std::string Recorder::chromeTrace() const {
+    std::string out = "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+    char buf[160];
+    for (std::size_t i = 0; i < events.size(); ++i) {
+        const TraceEvent& e = events[i];
+        std::snprintf(buf, sizeof(buf),
+                      "%s{\"name\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%u}",
+                      i ? "," : "", name(e.phase), static_cast<double>(e.startNs) / 1e3,
+                      static_cast<double>(e.durNs) / 1e3, e.tid);
+        out += buf;
+    }
+    return out + "]}";
+}
+
+} // namespace profile
@@ -0,0 +1,55 @@
+//
+// The process's master seed; see Random.h.
+//
+
+#include "../../include/core/Random.h"
+
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <random>
+
+namespace rng {
+
+namespace {
+
+constexpr std::size_t DOMAINS = static_cast<std::size_t>(Domain::Deck) + 1;
+
+// Function-local so that objects built during static initialization (the
+// server's agents and hand table) can already ask for seeds.
+struct Master {
+    std::once_flag drawn;
+    std::atomic<std::uint64_t> seed{0};
+    std::array<std::atomic<std::uint64_t>, DOMAINS> issued{};
+};
+
+Master& master() {
+    static Master m;
+    // 32 bits: short enough to read off a log and type back in.
+    std::call_once(m.drawn, [] { m.seed.store(std::random_device{}(), std::memory_order_relaxed); });
+    return m;
+}
+
+} // namespace
+
+void setMasterSeed(std::uint64_t seed) {
+    Master& m = master();
+    m.seed.store(seed, std::memory_order_relaxed);
+    for (auto& n : m.issued) n.store(0, std::memory_order_relaxed);
+}
+
+std::uint64_t masterSeed() {
+    return master().seed.load(std::memory_order_relaxed);
+}
+
+std::uint64_t seedFor(Domain d, std::uint64_t id) {
+    return derive(derive(masterSeed(), static_cast<std::uint64_t>(d)), id);
+}
+
+std::uint64_t nextSeed(Domain d) {
+    std::uint64_t n = master().issued[static_cast<std::size_t>(d)].fetch_add(
+        1, std::memory_order_relaxed);
+    return seedFor(d, n);
+}
+
+} // namespace rng
@@ -0,0 +1,72 @@
+//
+// Multi-deck shoe; see Shoe.h.
+//
+
+#include "../../include/core/Shoe.h"
+#include <algorithm>
+
+Shoe::Shoe(int numDecks, double pen)
+    : next(0), handStart(0), cutCard(0),
+      decks(std::max(MIN_DECKS, std::min(MAX_DECKS, numDecks))),
+      penetration(std::max(0.25, std::min(0.95, pen))),
+      stream(rng::nextSeed(rng::Domain::Shoe)) {
+    build();
+    shuffle();
+}
+
+void Shoe::build() {
+    cards.clear();
+    cards.reserve(static_cast<std::size_t>(decks) * 52);
+
+    for (int d = 0; d < decks; ++d) {
+        for (int s = 0; s < 4; s++) {
+            for (int r = static_cast<int>(Rank::Two); r <= static_cast<int>(Rank::Ace); r++) {
+                cards.emplace_back(static_cast<Suit>(s), static_cast<Rank>(r));
+            }
+        }
+    }
+
+    cutCard = static_cast<std::size_t>(penetration * static_cast<double>(cards.size()));
+}
+
+void Shoe::shuffle() {
+    // Cards are never removed from the vector, only stepped past, so
+    // reshuffling is just a permutation of the same storage.
+    stream.shuffle(cards.begin(), cards.end());
+    next = 0;
+    handStart = 0;
+}
+
+void Shoe::reseed(std::uint64_t seed) {
+    stream = rng::Stream(seed);
+    // Restore the factory order first: shuffling whatever order the previous
+    // stream left behind would make the result depend on history, not the seed.
+    build();
+    shuffle();
+}
+
+bool Shoe::startHand() {
+    if (!cutCardReached()) {
+        handStart = next;
+        return false;
+    }
+    shuffle();
+    return true;
+}
+
+Card Shoe::dealCard() {
+    if (next >= cards.size()) {
+        if (handStart == 0) {
+            // One hand has used the whole shoe; nothing was discarded before it.
+            shuffle();
+        } else {
+            // Move this hand's cards to the front, still counted as dealt, and
+            // shuffle the discards behind them.
+            std::rotate(cards.begin(), cards.begin() + static_cast<std::ptrdiff_t>(handStart), cards.end());
+            next = cards.size() - handStart;
+            handStart = 0;
+            stream.shuffle(cards.begin() + static_cast<std::ptrdiff_t>(next), cards.end());
+        }
+    }
+    return cards[next++];
+}
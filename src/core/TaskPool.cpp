@@ -0,0 +1,168 @@
+//
+// Work-stealing pool; see TaskPool.h.
+//
+
+#include "../../include/core/TaskPool.h"
+#include <algorithm>
+#include <atomic>
+#include <exception>
+
+// One parallelFor call. Each participant owns one run of indices; the mutex per
+// run is only ever contended when somebody is stealing, and a run is a whole
+// loop's worth of coarse tasks, so a plain lock is cheaper than it looks.
+struct TaskPool::Job {
+    struct Run {
+        std::mutex m;
+        std::size_t begin = 0;
+        std::size_t end = 0;
+    };
+
+    std::unique_ptr<Run[]> runs;
+    unsigned slots;
+    const std::function<void(std::size_t)>* body;
+
+    std::atomic<unsigned> joined{1};         // slot 0 belongs to the caller
+    std::atomic<std::size_t> remaining;
+
+    std::mutex doneMu;
+    std::condition_variable done;
+    std::exception_ptr error;
+
+    Job(std::size_t count, unsigned slots_, const std::function<void(std::size_t)>& fn)
+        : runs(new Run[slots_]), slots(slots_), body(&fn), remaining(count) {
+        std::size_t per = count / slots, extra = count % slots, at = 0;
+        for (unsigned s = 0; s < slots; ++s) {
+            runs[s].begin = at;
+            at += per + (s < extra ? 1 : 0);
+            runs[s].end = at;
+        }
+    }
+
+    // Own run from the front; otherwise steal from the back of another.
+    bool take(unsigned slot, std::size_t& out) {
+        {
+            std::lock_guard<std::mutex> lk(runs[slot].m);
+            if (runs[slot].begin < runs[slot].end) {
+                out = runs[slot].begin++;
+                return true;
+            }
+        }
+        for (unsigned k = 1; k < slots; ++k) {
+            Run& victim = runs[(slot + k) % slots];
+            std::lock_guard<std::mutex> lk(victim.m);
+            if (victim.begin < victim.end) {
+                out = --victim.end;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void work(unsigned slot) {
+        std::size_t i;
+        while (take(slot, i)) {
+            try {
+                (*body)(i);
+            } catch (...) {
+                std::lock_guard<std::mutex> lk(doneMu);
+                if (!error) error = std::current_exception();
+            }
+            if (remaining.fetch_sub(1) == 1) {
+                std::lock_guard<std::mutex> lk(doneMu);
+                done.notify_all();
+            }
+        }
+    }
+};
+
+TaskPool::TaskPool(unsigned threads) {
+    if (threads == 0) {
+        threads = hardwareThreads() - 1;
+    }
+    workers.reserve(threads);
+    for (unsigned t = 0; t < threads; ++t) {
+        workers.emplace_back([this, t] { workerLoop(t); });
+    }
+}
+
+TaskPool::~TaskPool() {
+    {
+        std::lock_guard<std::mutex> lk(mu);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (auto& w : workers) {
+        w.join();
+    }
+}
+
+void TaskPool::workerLoop(unsigned) {
+    for (;;) {
+        std::shared_ptr<Job> job;
+        unsigned slot;
+        {
+            std::unique_lock<std::mutex> lk(mu);
+            wake.wait(lk, [this] { return stopping || !jobs.empty(); });
+            if (stopping) return;
+
+            job = jobs.front();
+            slot = job->joined.fetch_add(1);
+            if (slot + 1 >= job->slots) {
+                jobs.pop_front();            // fully staffed
+            }
+            if (slot >= job->slots) continue;
+        }
+        job->work(slot);
+    }
+}
+
+void TaskPool::parallelFor(std::size_t count,
+                           const std::function<void(std::size_t)>& body,
+                           unsigned maxThreads) {
+    if (count == 0) return;
+
+    unsigned slots = concurrency();
+    if (maxThreads > 0) slots = std::min(slots, maxThreads);
+    if (count < slots) slots = static_cast<unsigned>(count);
+
+    if (slots <= 1) {
+        for (std::size_t i = 0; i < count; ++i) body(i);
+        return;
+    }
+
+    auto job = std::make_shared<Job>(count, slots, body);
+    {
+        std::lock_guard<std::mutex> lk(mu);
+        jobs.push_back(job);
+    }
+    wake.notify_all();
+
+    job->work(0);
+
+    {
+        std::unique_lock<std::mutex> lk(job->doneMu);
+        job->done.wait(lk, [&] { return job->remaining.load() == 0; });
+    }
+    {
+        // Workers that never got round to joining must not pick it up now.
+        std::lock_guard<std::mutex> lk(mu);
+        auto it = std::find(jobs.begin(), jobs.end(), job);
+        if (it != jobs.end()) jobs.erase(it);
+    }
+
+    if (job->error) std::rethrow_exception(job->error);
+}
+
+TaskPool& TaskPool::shared() {
+    static TaskPool pool;
+    return pool;
+}
+
+unsigned TaskPool::hardwareThreads() {
+#if defined(__EMSCRIPTEN__) && !defined(__EMSCRIPTEN_PTHREADS__)
+    return 1;
+#else
+    unsigned n = std::thread::hardware_concurrency();
+    return n > 0 ? n : 1;
+#endif
+}
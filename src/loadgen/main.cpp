@@ -0,0 +1,614 @@
+//
+// Load generator for blackjack_server.
+//
+// Drives a weighted mix of API requests over N keep-alive connections and
+// reports throughput and latency percentiles per endpoint, as a text table and
+// optionally as JSON. With --rate the offered load is fixed (open loop) and
+// each request's latency is measured from when it was *due*, not from when it
+// was finally sent, so a server that stalls shows up as latency rather than as
+// a quietly lower request rate. Without --rate every connection sends its next
+// request as soon as the last one returns (closed loop).
+//
+// --train keeps a training job running for the whole measurement, and
+// --compare runs the same load twice, idle and then training, to show what
+// training costs interactive requests.
+//
+// The decide and decide_all endpoints ask for one random state and for all of
+// them. They go to /api/decide, or with --socket to the server's binary
+// decision socket (DECIDE_SOCKET), so the two transports can be compared:
+//
+//   blackjack_loadgen --connections 16 --duration 10 --compare
+//   blackjack_loadgen --rate 2000 --mix step=60,new=20,status=20 --json out.json
+//   blackjack_loadgen --connections 1 --mix decide=1,decide_all=1 --socket /tmp/bj.sock
+//
+// The server must already be running (see --host and --port).
+//
+
+#include "httplib.h"
+#include "../../include/ai/AITypes.h"
+#include "../api/Json.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifndef _WIN32
+#include <cerrno>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// ---------------------------------------------------------------------------
+// Latency histogram
+// ---------------------------------------------------------------------------
+
+// Log-linear buckets over whole microseconds: exact below 32 us, then 16
+// buckets per power of two (about 3% wide), up to hours. Recording is an
+// increment, and per-connection histograms merge by adding counts.
+class Histogram {
+private:
+    static constexpr int HALF = 16;
+    static constexpr int BUCKETS = 64 * HALF;
+
+    std::array<std::uint64_t, BUCKETS> counts{};
+    std::uint64_t total = 0;
+    std::uint64_t max = 0;
+    double sum = 0.0;
+
+    static int index(std::uint64_t us) {
+        if (us < 2 * HALF) return static_cast<int>(us);
+        int msb = 63;
+        while (!(us >> msb)) --msb;
+        int shift = msb - 4;   // leaves (us >> shift) in [HALF, 2 * HALF)
+        return std::min(BUCKETS - 1, (shift + 1) * HALF + static_cast<int>((us >> shift) - HALF));
+    }
+
+    // The middle of bucket i, in microseconds.
+    static double value(int i) {
+        if (i < 2 * HALF) return i;
+        int shift = i / HALF - 1;
+        std::uint64_t low = static_cast<std::uint64_t>(i % HALF + HALF) << shift;
+        return static_cast<double>(low) + static_cast<double>(std::uint64_t{1} << shift) / 2;
+    }
+
+public:
+    void record(Clock::duration d) {
+        auto us = static_cast<std::uint64_t>(
+            std::max<long long>(0, std::chrono::duration_cast<std::chrono::microseconds>(d).count()));
+        ++counts[index(us)];
+        ++total;
+        max = std::max(max, us);
+        sum += static_cast<double>(us);
+    }
+
+    void merge(const Histogram& o) {
+        for (int i = 0; i < BUCKETS; ++i) counts[i] += o.counts[i];
+        total += o.total;
+        max = std::max(max, o.max);
+        sum += o.sum;
+    }
+
+    std::uint64_t count() const { return total; }
+    double maxUs() const { return static_cast<double>(max); }
+    double meanUs() const { return total ? sum / static_cast<double>(total) : 0.0; }
+
+    // The q-th quantile, q in [0, 1].
+    double percentileUs(double q) const {
+        if (total == 0) return 0.0;
+        auto rank = static_cast<std::uint64_t>(std::ceil(q * static_cast<double>(total)));
+        rank = std::max<std::uint64_t>(1, rank);
+        std::uint64_t seen = 0;
+        for (int i = 0; i < BUCKETS; ++i) {
+            seen += counts[i];
+            if (seen >= rank) return std::min(value(i), maxUs());
+        }
+        return maxUs();
+    }
+};
+
+// ---------------------------------------------------------------------------
+// Endpoints and options
+// ---------------------------------------------------------------------------
+
+enum Endpoint { HAND_NEW, HAND_STEP, POLICY, SIMULATE, STATUS, DECIDE, DECIDE_ALL, ENDPOINT_COUNT };
+
+const char* const ENDPOINT_NAMES[ENDPOINT_COUNT] = {
+    "new", "step", "policy", "simulate", "status", "decide", "decide_all"};
+const char* const ENDPOINT_PATHS[ENDPOINT_COUNT] = {
+    "/api/hand/new", "/api/hand/step", "/api/policy", "/api/simulate", "/api/status",
+    "/api/decide", "/api/decide"};
+
+struct Options {
+    std::string host = "localhost";
+    int port = 8080;
+    int connections = 8;
+    double seconds = 10.0;
+    double rate = 0.0;                 // total requests/s; 0 = closed loop
+    std::array<double, ENDPOINT_COUNT> mix{{20, 40, 15, 5, 20, 0, 0}};
+    std::string agent = "q";
+    std::string socketPath;            // decide requests go here instead of HTTP
+    int simulateGames = 1000;
+    bool train = false;
+    bool compare = false;
+    std::string trainParams = "agent=q&episodes=5000000";
+    std::string jsonPath;
+};
+
+void usage() {
+    std::cerr <<
+        "usage: blackjack_loadgen [options]\n"
+        "  --host H            server host (localhost)\n"
+        "  --port P            server port (8080)\n"
+        "  --connections N     concurrent keep-alive connections (8)\n"
+        "  --duration S        seconds per scenario (10)\n"
+        "  --rate R            total requests per second; 0 = as fast as possible (0)\n"
+        "  --mix LIST          weights, e.g. new=20,step=40,policy=15,simulate=5,status=20\n"
+        "                      (decide and decide_all are also available, weight 0)\n"
+        "  --agent A           agent for every request (q)\n"
+        "  --simulate-games N  games per /api/simulate request (1000)\n"
+        "  --train             keep a training job running during the run\n"
+        "  --train-params Q    query string for POST /api/train (agent=q&episodes=5000000)\n"
+        "  --compare           run idle, then again while training\n"
+        "  --socket PATH       send decide requests to the server's DECIDE_SOCKET\n"
+        "  --json PATH         also write the results as JSON (- for stdout)\n";
+}
+
+// The decision socket's agent byte, or -1.
+int agentByte(const std::string& agent) {
+    if (agent == "q") return 0;
+    if (agent == "mc") return 1;
+    if (agent == "optimal") return 2;
+    return -1;
+}
+
+bool parseMix(const std::string& text, std::array<double, ENDPOINT_COUNT>& mix) {
+    std::array<double, ENDPOINT_COUNT> out{};
+    std::stringstream in(text);
+    std::string item;
+    while (std::getline(in, item, ',')) {
+        auto eq = item.find('=');
+        if (eq == std::string::npos) return false;
+        std::string name = item.substr(0, eq);
+        auto it = std::find(std::begin(ENDPOINT_NAMES), std::end(ENDPOINT_NAMES), name);
+        if (it == std::end(ENDPOINT_NAMES)) return false;
+        try {
+            out[it - std::begin(ENDPOINT_NAMES)] = std::max(0.0, std::stod(item.substr(eq + 1)));
+        } catch (...) {
+            return false;
+        }
+    }
+    if (std::all_of(out.begin(), out.end(), [](double w) { return w == 0.0; })) return false;
+    mix = out;
+    return true;
+}
+
+bool parseArgs(int argc, char** argv, Options& o) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto next = [&]() -> std::string {
+            if (i + 1 >= argc) throw std::invalid_argument(arg + " needs a value");
+            return argv[++i];
+        };
+        try {
+            if (arg == "--host") o.host = next();
+            else if (arg == "--port") o.port = std::stoi(next());
+            else if (arg == "--connections") o.connections = std::max(1, std::stoi(next()));
+            else if (arg == "--duration") o.seconds = std::max(0.1, std::stod(next()));
+            else if (arg == "--rate") o.rate = std::max(0.0, std::stod(next()));
+            else if (arg == "--mix") {
+                if (!parseMix(next(), o.mix)) throw std::invalid_argument("bad --mix");
+            }
+            else if (arg == "--agent") o.agent = next();
+            else if (arg == "--simulate-games") o.simulateGames = std::max(1, std::stoi(next()));
+            else if (arg == "--train") o.train = true;
+            else if (arg == "--train-params") o.trainParams = next();
+            else if (arg == "--compare") o.compare = true;
+            else if (arg == "--socket") o.socketPath = next();
+            else if (arg == "--json") o.jsonPath = next();
+            else if (arg == "--help" || arg == "-h") return false;
+            else throw std::invalid_argument("unknown option " + arg);
+        } catch (const std::exception& e) {
+            std::cerr << e.what() << "\n";
+            return false;
+        }
+    }
+    if (!o.socketPath.empty() && agentByte(o.agent) < 0) {
+        std::cerr << "--socket needs --agent q, mc or optimal\n";
+        return false;
+    }
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// Decide requests
+// ---------------------------------------------------------------------------
+
+// `states=` for /api/decide: one state, or every state when index < 0.
+std::string statesParam(int index) {
+    auto text = [](int i) {
+        State s = stateAt(i);
+        return std::to_string(s.playerSum) + ":" + std::to_string(s.dealerUpcard) + ":" +
+               (s.usableAce ? "1" : "0");
+    };
+    if (index >= 0) return text(index);
+    std::string all;
+    for (int i = 0; i < STATE_COUNT; ++i) {
+        if (i) all += ',';
+        all += text(i);
+    }
+    return all;
+}
+
+// One framed decidePacked request (see the README): the u32 length, then the
+// version, agent, count and state indices, little-endian throughout.
+std::string packedRequest(int agent, int index) {
+    std::vector<int> states;
+    if (index >= 0) states.push_back(index);
+    else for (int i = 0; i < STATE_COUNT; ++i) states.push_back(i);
+
+    std::string out;
+    auto put = [&out](std::uint32_t v, int bytes) {
+        for (int i = 0; i < bytes; ++i) out += static_cast<char>(v >> (8 * i));
+    };
+    put(static_cast<std::uint32_t>(4 + 2 * states.size()), 4);
+    put(1, 1);
+    put(static_cast<std::uint32_t>(agent), 1);
+    put(static_cast<std::uint32_t>(states.size()), 2);
+    for (int i : states) put(static_cast<std::uint32_t>(i), 2);
+    return out;
+}
+
+#ifndef _WIN32
+// A connection to the server's decision socket, kept open for the whole run.
+class DecideSocket {
+private:
+    int fd = -1;
+
+    bool readFull(char* buf, std::size_t n) {
+        while (n > 0) {
+            ssize_t got = ::read(fd, buf, n);
+            if (got < 0 && errno == EINTR) continue;
+            if (got <= 0) return false;
+            buf += got;
+            n -= static_cast<std::size_t>(got);
+        }
+        return true;
+    }
+
+    bool writeFull(const char* buf, std::size_t n) {
+        while (n > 0) {
+            ssize_t sent = ::write(fd, buf, n);
+            if (sent < 0 && errno == EINTR) continue;
+            if (sent <= 0) return false;
+            buf += sent;
+            n -= static_cast<std::size_t>(sent);
+        }
+        return true;
+    }
+
+public:
+    DecideSocket() = default;
+    DecideSocket(const DecideSocket&) = delete;
+    DecideSocket& operator=(const DecideSocket&) = delete;
+    ~DecideSocket() { if (fd >= 0) ::close(fd); }
+
+    bool open(const std::string& path) {
+        sockaddr_un addr{};
+        if (path.size() >= sizeof(addr.sun_path)) return false;
+        addr.sun_family = AF_UNIX;
+        std::copy(path.begin(), path.end(), addr.sun_path);
+        fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        return fd >= 0 && ::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0;
+    }
+
+    // Sends one framed request and reads the reply into `reply`. False if the
+    // connection failed or the reply's status byte is not 0.
+    bool roundTrip(const std::string& request, std::string& reply) {
+        char prefix[4];
+        if (!writeFull(request.data(), request.size()) || !readFull(prefix, sizeof(prefix))) return false;
+        std::uint32_t n = 0;
+        for (int i = 3; i >= 0; --i) n = n << 8 | static_cast<std::uint8_t>(prefix[i]);
+        reply.resize(n);
+        return readFull(reply.data(), n) && n >= 2 && reply[1] == 0;
+    }
+};
+#else
+struct DecideSocket {
+    bool open(const std::string&) { return false; }
+    bool roundTrip(const std::string&, std::string&) { return false; }
+};
+#endif
+
+// ---------------------------------------------------------------------------
+// Running a scenario
+// ---------------------------------------------------------------------------
+
+struct Stats {
+    std::array<Histogram, ENDPOINT_COUNT> latency;
+    std::array<std::uint64_t, ENDPOINT_COUNT> errors{};
+
+    void merge(const Stats& o) {
+        for (int e = 0; e < ENDPOINT_COUNT; ++e) {
+            latency[e].merge(o.latency[e]);
+            errors[e] += o.errors[e];
+        }
+    }
+};
+
+struct Scenario {
+    std::string name;
+    double seconds = 0.0;
+    Stats stats;
+};
+
+// The number after `"key":` in a JSON body, or 0.
+long long jsonNumber(const std::string& body, const std::string& key) {
+    auto at = body.find("\"" + key + "\":");
+    if (at == std::string::npos) return 0;
+    return std::atoll(body.c_str() + at + key.size() + 3);
+}
+
+// One connection's share of the load. A step needs an open hand, so a
+// connection with none deals one instead (and records it as a new hand); an
+// auto step that finishes the hand closes it.
+void connection(const Options& o, int index, Clock::time_point start, Clock::time_point end,
+                Stats& stats) {
+    httplib::Client cli(o.host, o.port);
+    cli.set_keep_alive(true);
+    cli.set_tcp_nodelay(true);
+    cli.set_read_timeout(std::chrono::seconds(60));
+
+    std::mt19937 rng(static_cast<unsigned>(index) * 7919u + 1u);
+    std::discrete_distribution<int> pick(o.mix.begin(), o.mix.end());
+    std::uniform_int_distribution<int> pickState(0, STATE_COUNT - 1);
+    const std::string agent = "agent=" + o.agent;
+    long long hand = 0;
+    long long seed = index * 1000003LL;
+
+    // Decide requests are built ahead of the clock, so only the round trip is
+    // timed; the one-state ones are picked from a ring of random states.
+    const bool useSocket = !o.socketPath.empty();
+    DecideSocket sock;
+    if (useSocket && !sock.open(o.socketPath)) {
+        std::cerr << "Cannot connect to " << o.socketPath << "\n";
+        std::exit(1);
+    }
+    std::vector<std::string> decideOne(256);
+    for (std::string& r : decideOne) {
+        int i = pickState(rng);
+        r = useSocket ? packedRequest(agentByte(o.agent), i) : agent + "&states=" + statesParam(i);
+    }
+    const std::string decideAll = useSocket ? packedRequest(agentByte(o.agent), -1)
+                                            : agent + "&states=" + statesParam(-1);
+    std::size_t nextDecide = 0;
+    std::string reply;
+
+    // Open loop: connections share the rate and are staggered across one
+    // interval so their requests interleave instead of arriving in bursts.
+    Clock::duration interval{};
+    Clock::time_point due = start;
+    if (o.rate > 0) {
+        interval = std::chrono::duration_cast<Clock::duration>(
+            std::chrono::duration<double>(o.connections / o.rate));
+        due += interval * index / o.connections;
+    }
+
+    for (;;) {
+        Clock::time_point sent;
+        if (o.rate > 0) {
+            if (due >= end) break;
+            std::this_thread::sleep_until(due);
+            sent = due;
+            due += interval;
+        } else {
+            sent = Clock::now();
+            if (sent >= end) break;
+        }
+
+        int e = pick(rng);
+        if (e == HAND_STEP && hand == 0) e = HAND_NEW;
+        if (e == DECIDE || e == DECIDE_ALL) {
+            const std::string& request =
+                e == DECIDE ? decideOne[nextDecide++ % decideOne.size()] : decideAll;
+            bool ok;
+            if (useSocket) {
+                ok = sock.roundTrip(request, reply);
+            } else {
+                // Form-encoded POST: all 360 states make a long URL.
+                httplib::Result res = cli.Post(ENDPOINT_PATHS[e], request,
+                                               "application/x-www-form-urlencoded");
+                ok = res && res->status == 200;
+            }
+            stats.latency[e].record(Clock::now() - sent);
+            if (!ok) ++stats.errors[e];
+            continue;
+        }
+        std::string path = ENDPOINT_PATHS[e];
+        switch (e) {
+            case HAND_NEW:  path += "?" + agent; break;
+            case HAND_STEP: path += "?" + agent + "&action=auto&id=" + std::to_string(hand); break;
+            case POLICY:    path += "?" + agent; break;
+            case SIMULATE:
+                path += "?" + agent + "&games=" + std::to_string(o.simulateGames) +
+                        "&seed=" + std::to_string(++seed);
+                break;
+            default: break;
+        }
+
+        httplib::Result res = (e == HAND_NEW || e == HAND_STEP) ? cli.Post(path) : cli.Get(path);
+        stats.latency[e].record(Clock::now() - sent);
+        if (!res || res->status >= 400) {
+            ++stats.errors[e];
+            if (e == HAND_STEP) hand = 0;   // expired or recycled: deal afresh
+            continue;
+        }
+        if (e == HAND_NEW) hand = jsonNumber(res->body, "handId");
+        if (e == HAND_STEP && res->body.find("\"finished\":true") != std::string::npos) hand = 0;
+    }
+}
+
+Scenario run(const Options& o, const std::string& name, bool training) {
+    long long job = 0;
+    httplib::Client control(o.host, o.port);
+    if (training) {
+        auto res = control.Post("/api/train?" + o.trainParams);
+        if (!res || res->status != 200) {
+            std::cerr << "POST /api/train failed" << (res ? ": " + res->body : std::string()) << "\n";
+            std::exit(1);
+        }
+        job = jsonNumber(res->body, "job");
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));   // let it get going
+    }
+
+    Scenario s;
+    s.name = name;
+    std::vector<Stats> perConnection(static_cast<std::size_t>(o.connections));
+    std::vector<std::thread> threads;
+    Clock::time_point start = Clock::now();
+    Clock::time_point end = start + std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double>(o.seconds));
+    for (int i = 0; i < o.connections; ++i) {
+        threads.emplace_back(connection, std::cref(o), i, start, end, std::ref(perConnection[i]));
+    }
+    for (auto& t : threads) t.join();
+    s.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    for (const Stats& st : perConnection) s.stats.merge(st);
+
+    if (training) control.Post("/api/train/stop?job=" + std::to_string(job));
+    return s;
+}
+
+// ---------------------------------------------------------------------------
+// Reports
+// ---------------------------------------------------------------------------
+
+const double QUANTILES[] = {0.50, 0.90, 0.99, 0.999};
+const char* const QUANTILE_NAMES[] = {"p50", "p90", "p99", "p999"};
+
+void printScenario(const Options& o, const Scenario& s) {
+    std::cout << "\n== " << s.name << ": " << o.connections << " connections, "
+              << (o.rate > 0 ? std::to_string(static_cast<long long>(o.rate)) + " req/s offered"
+                             : std::string("closed loop"))
+              << (o.socketPath.empty() ? std::string() : ", decide over " + o.socketPath)
+              << ", " << std::fixed << std::setprecision(1) << s.seconds << " s\n";
+    std::cout << std::left << std::setw(12) << "endpoint" << std::right
+              << std::setw(9) << "count" << std::setw(8) << "errors" << std::setw(10) << "req/s";
+    for (const char* q : QUANTILE_NAMES) std::cout << std::setw(10) << q;
+    std::cout << std::setw(10) << "max" << "   (ms)\n";
+
+    Histogram all;
+    std::uint64_t errors = 0;
+    auto row = [&](const char* name, const Histogram& h, std::uint64_t errs) {
+        std::cout << std::left << std::setw(12) << name << std::right
+                  << std::setw(9) << h.count() << std::setw(8) << errs
+                  << std::setw(10) << std::setprecision(1) << h.count() / s.seconds
+                  << std::setprecision(3);
+        for (double q : QUANTILES) std::cout << std::setw(10) << h.percentileUs(q) / 1000.0;
+        std::cout << std::setw(10) << h.maxUs() / 1000.0 << "\n";
+    };
+    for (int e = 0; e < ENDPOINT_COUNT; ++e) {
+        if (s.stats.latency[e].count() == 0) continue;
+        row(ENDPOINT_NAMES[e], s.stats.latency[e], s.stats.errors[e]);
+        all.merge(s.stats.latency[e]);
+        errors += s.stats.errors[e];
+    }
+    row("total", all, errors);
+}
+
+void writeLatency(json::Writer& w, const Histogram& h, std::uint64_t errors, double seconds) {
+    w.kv("count", static_cast<long long>(h.count()))
+     .kv("errors", static_cast<long long>(errors))
+     .kv("perSecond", h.count() / seconds)
+     .kv("meanUs", h.meanUs());
+    for (int i = 0; i < 4; ++i) {
+        w.kv(std::string(QUANTILE_NAMES[i]) + "Us", h.percentileUs(QUANTILES[i]));
+    }
+    w.kv("maxUs", h.maxUs());
+}
+
+std::string resultsJson(const Options& o, const std::vector<Scenario>& scenarios) {
+    json::Writer w;
+    w.kobj("config")
+        .kv("host", o.host)
+        .kv("port", o.port)
+        .kv("connections", o.connections)
+        .kv("seconds", o.seconds)
+        .kv("rate", o.rate)
+        .kv("agent", o.agent)
+        .kv("simulateGames", o.simulateGames)
+        .kv("trainParams", o.trainParams)
+        .kv("socket", o.socketPath)
+        .kobj("mix");
+    for (int e = 0; e < ENDPOINT_COUNT; ++e) w.kv(ENDPOINT_NAMES[e], o.mix[e]);
+    w.end().end().karr("scenarios");
+    for (const Scenario& s : scenarios) {
+        w.obj().kv("name", s.name).kv("seconds", s.seconds).kobj("endpoints");
+        Histogram all;
+        std::uint64_t errors = 0;
+        for (int e = 0; e < ENDPOINT_COUNT; ++e) {
+            if (s.stats.latency[e].count() == 0) continue;
+            writeLatency(w.kobj(ENDPOINT_NAMES[e]), s.stats.latency[e], s.stats.errors[e], s.seconds);
+            w.end();
+            all.merge(s.stats.latency[e]);
+            errors += s.stats.errors[e];
+        }
+        w.end();
+        writeLatency(w.kobj("total"), all, errors, s.seconds);
+        w.end().end();
+    }
+    w.end();
+    return w.done();
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options o;
+    if (!parseArgs(argc, argv, o)) {
+        usage();
+        return 2;
+    }
+
+    httplib::Client probe(o.host, o.port);
+    if (!probe.Get("/api/status")) {
+        std::cerr << "No server at " << o.host << ":" << o.port << "\n";
+        return 1;
+    }
+
+    std::vector<Scenario> scenarios;
+    if (o.compare) {
+        scenarios.push_back(run(o, "idle", false));
+        printScenario(o, scenarios.back());
+        scenarios.push_back(run(o, "training", true));
+        printScenario(o, scenarios.back());
+    } else {
+        scenarios.push_back(run(o, o.train ? "training" : "idle", o.train));
+        printScenario(o, scenarios.back());
+    }
+
+    if (!o.jsonPath.empty()) {
+        std::string body = resultsJson(o, scenarios);
+        if (o.jsonPath == "-") {
+            std::cout << body << "\n";
+        } else {
+            std::ofstream(o.jsonPath) << body << "\n";
+        }
+    }
+    return 0;
+}
@@ -3,11 +3,21 @@
 //
 
 #include "../include/core/Game.h"
+#include "../include/core/Profile.h"
+#include "../include/core/Random.h"
+#include "../include/core/Rules.h"
 #include "../include/ai/QLearningAI.h"
 #include "../include/ai/MonteCarloAI.h"
+#include "../include/ai/OptimalAI.h"
+#include "../include/ai/TableFile.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
 #include <iostream>
 #include <limits>
 #include <iomanip>
+#include <string>
 
 using namespace std;
 
@@ -28,7 +38,8 @@ void displayMenu() {
     cout << "11. Save Monte Carlo Q-Table\n";
     cout << "12. View Monte Carlo Statistics\n";
     cout << "13. Compare Q-Learning vs Monte Carlo\n";
-    cout << "14. Exit\n";
+    cout << "14. Solve Optimal Strategy (exact)\n";
+    cout << "15. Exit\n";
     cout << "=========================\n";
     cout << "Enter choice: ";
 }
@@ -66,6 +77,30 @@ void playHumanMode() {
     } while (choice == 'y' || choice == 'Y');
 }
 
+// With the phase timers compiled in (BLACKJACK_PROFILE), a training run ends
+// with where its episodes spent their time. PROFILE_TRACE=path also writes a
+// Chrome trace of one episode in every PROFILE_TRACE_EVERY (default 1000).
+profile::Recorder phaseRecorder() {
+    long long every = 0;
+    if (std::getenv("PROFILE_TRACE")) {
+        every = 1000;
+        if (const char* env = std::getenv("PROFILE_TRACE_EVERY")) {
+            try { every = std::max(1LL, std::stoll(env)); } catch (...) {}
+        }
+    }
+    return profile::Recorder(every);
+}
+
+void reportPhases(const profile::Recorder& recorder) {
+    if (!profile::ENABLED) return;
+    cout << "\n=== Phase Breakdown ===\n" << recorder.table();
+    if (recorder.tracing()) {
+        const char* path = std::getenv("PROFILE_TRACE");
+        std::ofstream(path) << recorder.chromeTrace();
+        cout << "Trace of " << recorder.traceEvents() << " phases written to " << path << "\n";
+    }
+}
+
 void trainAIMode(QLearningAI& ai) {
     int numEpisodes;
     cout << "\nEnter number of training episodes (recommended: 10000-100000): ";
@@ -82,8 +117,29 @@ void trainAIMode(QLearningAI& ai) {
     cout << "Show progress during training? (y/n): ";
     cin >> verbose;
 
+    int threads;
+    cout << "Worker threads (1 = serial, 0 = all cores): ";
+    cin >> threads;
+
+    if (cin.fail() || threads < 0) {
+        cin.clear();
+        cin.ignore(numeric_limits<streamsize>::max(), '\n');
+        cout << "Invalid input. Training serially.\n";
+        threads = 1;
+    }
+
     Game trainingGame(0); // 0 human players for training
-    trainingGame.trainAI(ai, numEpisodes, (verbose == 'y' || verbose == 'Y'));
+    profile::Recorder recorder = phaseRecorder();
+    {
+        profile::Attach attach(&recorder);
+        if (threads == 1) {
+            trainingGame.trainAI(ai, numEpisodes, (verbose == 'y' || verbose == 'Y'));
+        } else {
+            trainingGame.trainAIParallel(ai, numEpisodes, static_cast<unsigned>(threads),
+                                         (verbose == 'y' || verbose == 'Y'));
+        }
+    }
+    reportPhases(recorder);
 
     cout << "\nTraining complete! Don't forget to save the Q-table (option 6).\n";
 }
@@ -128,12 +184,12 @@ void watchAIPlay(QLearningAI& ai) {
 
 void loadQTable(QLearningAI& ai) {
     string filename;
-    cout << "\nEnter filename to load (default: data/q_table.csv): ";
+    cout << "\nEnter filename to load (default: data/q_table.bin; .csv imports CSV): ";
     cin.ignore(numeric_limits<streamsize>::max(), '\n');
     getline(cin, filename);
 
     if (filename.empty()) {
-        filename = "data/q_table.csv";
+        filename = "data/q_table.bin";
     }
 
     ai.loadQTable(filename);
@@ -141,12 +197,12 @@ void loadQTable(QLearningAI& ai) {
 
 void saveQTable(QLearningAI& ai) {
     string filename;
-    cout << "\nEnter filename to save (default: data/q_table.csv): ";
+    cout << "\nEnter filename to save (default: data/q_table.bin; .csv exports CSV): ";
     cin.ignore(numeric_limits<streamsize>::max(), '\n');
     getline(cin, filename);
 
     if (filename.empty()) {
-        filename = "data/q_table.csv";
+        filename = "data/q_table.bin";
     }
 
     ai.saveQTable(filename);
@@ -170,7 +226,12 @@ void trainMonteCarloMode(MonteCarloAI& ai) {
     cin >> verbose;
 
     Game trainingGame(0);
-    trainingGame.trainMonteCarlo(ai, numEpisodes, (verbose == 'y' || verbose == 'Y'));
+    profile::Recorder recorder = phaseRecorder();
+    {
+        profile::Attach attach(&recorder);
+        trainingGame.trainMonteCarlo(ai, numEpisodes, (verbose == 'y' || verbose == 'Y'));
+    }
+    reportPhases(recorder);
 
     cout << "\nTraining complete! Don't forget to save the Q-table (option 11).\n";
 }
@@ -193,12 +254,12 @@ void evaluateMonteCarloMode(MonteCarloAI& ai) {
 
 void loadMonteCarloQTable(MonteCarloAI& ai) {
     string filename;
-    cout << "\nEnter filename to load (default: data/mc_q_table.csv): ";
+    cout << "\nEnter filename to load (default: data/mc_q_table.bin; .csv imports CSV): ";
     cin.ignore(numeric_limits<streamsize>::max(), '\n');
     getline(cin, filename);
 
     if (filename.empty()) {
-        filename = "data/mc_q_table.csv";
+        filename = "data/mc_q_table.bin";
     }
 
     ai.loadQTable(filename);
@@ -206,33 +267,74 @@ void loadMonteCarloQTable(MonteCarloAI& ai) {
 
 void saveMonteCarloQTable(MonteCarloAI& ai) {
     string filename;
-    cout << "\nEnter filename to save (default: data/mc_q_table.csv): ";
+    cout << "\nEnter filename to save (default: data/mc_q_table.bin; .csv exports CSV): ";
     cin.ignore(numeric_limits<streamsize>::max(), '\n');
     getline(cin, filename);
 
     if (filename.empty()) {
-        filename = "data/mc_q_table.csv";
+        filename = "data/mc_q_table.bin";
     }
 
     ai.saveQTable(filename);
 }
 
+// Exact expected return of each greedy policy on a fresh six-deck shoe (the
+// shoe Game deals from), with basic strategy and the optimum for reference.
+// Win/loss/push rates need the simulation; the number that matters does not.
+void compareAIsExact(const QLearningAI& qLearning, const MonteCarloAI& monteCarlo) {
+    OptimalAI optimal(Shoe::DEFAULT_DECKS);
+    double qEv = optimal.expectedReturn([&](const State& s) { return qLearning.getBestAction(s); });
+    double mcEv = optimal.expectedReturn([&](const State& s) { return monteCarlo.getBestAction(s); });
+    double basicEv = optimal.expectedReturn(rules::basicStrategy);
+    double bestEv = optimal.expectedReturn();
+
+    cout << "\n========================================\n";
+    cout << "     EXACT EXPECTED RETURN PER HAND\n";
+    cout << "========================================\n\n";
+
+    cout << fixed << setprecision(5);
+    cout << "Policy                  | Avg Reward    | Gap to optimal\n";
+    cout << "------------------------|---------------|---------------\n";
+    cout << "Q-Learning              | " << setw(13) << qEv << " | " << setw(13) << (qEv - bestEv) << "\n";
+    cout << "Monte Carlo             | " << setw(13) << mcEv << " | " << setw(13) << (mcEv - bestEv) << "\n";
+    cout << "Basic strategy          | " << setw(13) << basicEv << " | " << setw(13) << (basicEv - bestEv) << "\n";
+    cout << "Optimal                 | " << setw(13) << bestEv << " | " << setw(13) << 0.0 << "\n";
+
+    cout << "\n========================================\n\n";
+
+    if (qEv > mcEv) {
+        cout << "Winner: Q-Learning AI! 🏆\n";
+    } else if (mcEv > qEv) {
+        cout << "Winner: Monte Carlo AI! 🏆\n";
+    } else {
+        cout << "Result: Tie! Both AIs play the same policy. 🤝\n";
+    }
+
+    cout << "\n";
+}
+
 void compareAIs(QLearningAI& qLearning, MonteCarloAI& monteCarlo) {
     cout << "\n========================================\n";
     cout << "   Q-Learning vs Monte Carlo Comparison\n";
     cout << "========================================\n\n";
 
     int numGames;
-    cout << "Enter number of evaluation games for each AI (recommended: 5000-10000): ";
+    cout << "Enter number of evaluation games for each AI (recommended: 5000-10000,\n"
+         << "or 0 for exact expected returns without simulating): ";
     cin >> numGames;
 
-    if (cin.fail() || numGames < 1) {
+    if (cin.fail() || numGames < 0) {
         cin.clear();
         cin.ignore(numeric_limits<streamsize>::max(), '\n');
         cout << "Invalid input. Defaulting to 5000 games.\n";
         numGames = 5000;
     }
 
+    if (numGames == 0) {
+        compareAIsExact(qLearning, monteCarlo);
+        return;
+    }
+
     Game evalGame(0);
 
     // Evaluate Q-Learning
@@ -335,17 +437,68 @@ void compareAIs(QLearningAI& qLearning, MonteCarloAI& monteCarlo) {
     cout << "\n";
 }
 
-int main() {
+void solveOptimalMode() {
+    int numDecks;
+    cout << "\nNumber of decks (1-8, 0 = infinite deck): ";
+    cin >> numDecks;
+
+    if (cin.fail() || numDecks < 0) {
+        cin.clear();
+        cin.ignore(numeric_limits<streamsize>::max(), '\n');
+        cout << "Invalid input. Defaulting to " << Shoe::DEFAULT_DECKS << " decks.\n";
+        numDecks = Shoe::DEFAULT_DECKS;
+    }
+
+    OptimalAI optimal(numDecks);
+    optimal.printStats();
+    optimal.printStrategy();
+
+    cout << "Save the exact Q-table? (y/n): ";
+    char save;
+    cin >> save;
+    if (save == 'y' || save == 'Y') {
+        optimal.saveQTable("data/optimal_q_table.bin");
+    }
+}
+
+// --seed N (or --seed=N) fixes the master seed that every shoe and agent
+// draws from, so a session repeated with the same seed and the same menu
+// choices deals and trains exactly the same. Without it a seed is drawn, and
+// printed so the session can be repeated anyway.
+void applySeedFlag(int argc, char** argv) {
+    for (int i = 1; i < argc; ++i) {
+        const char* value = nullptr;
+        if (std::strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            value = argv[++i];
+        } else if (std::strncmp(argv[i], "--seed=", 7) == 0) {
+            value = argv[i] + 7;
+        } else {
+            cerr << "Unknown argument '" << argv[i] << "' (usage: blackjack_ai [--seed N])\n";
+            continue;
+        }
+        try {
+            rng::setMasterSeed(std::stoull(value));
+        } catch (...) {
+            cerr << "Invalid seed '" << value << "', drawing one instead\n";
+        }
+    }
+    cout << "Seed: " << rng::masterSeed() << "\n";
+}
+
+int main(int argc, char** argv) {
+    applySeedFlag(argc, argv);
+
     // Initialize AI agents with default hyperparameters
     QLearningAI qLearningAI(0.01, 1.0, 1.0); // alpha floor=0.01, gamma=1.0, epsilon=1.0
     MonteCarloAI monteCarloAI(0.1, 1.0);     // epsilon=0.1, gamma=1.0
 
-    // Try to load existing Q-tables on startup
+    // Try to load existing Q-tables on startup: the binary table if there is
+    // one, else a CSV from before it existed
     cout << "Attempting to load existing Q-Learning Q-table...\n";
-    qLearningAI.loadQTable("data/q_table.csv");
+    qLearningAI.loadQTable(tablefile::preferBinary("data/q_table.bin", "data/q_table.csv"));
 
     cout << "Attempting to load existing Monte Carlo Q-table...\n";
-    monteCarloAI.loadQTable("data/mc_q_table.csv");
+    monteCarloAI.loadQTable(tablefile::preferBinary("data/mc_q_table.bin", "data/mc_q_table.csv"));
 
     int choice;
     bool running = true;
@@ -415,18 +568,22 @@ int main() {
                 break;
 
             case 14:
+                solveOptimalMode();
+                break;
+
+            case 15:
                 cout << "\nSave Q-Learning Q-table before exiting? (y/n): ";
                 char saveQ;
                 cin >> saveQ;
                 if (saveQ == 'y' || saveQ == 'Y') {
-                    qLearningAI.saveQTable("data/q_table.csv");
+                    qLearningAI.saveQTable("data/q_table.bin");
                 }
 
                 cout << "Save Monte Carlo Q-table before exiting? (y/n): ";
                 char saveMC;
                 cin >> saveMC;
                 if (saveMC == 'y' || saveMC == 'Y') {
-                    monteCarloAI.saveQTable("data/mc_q_table.csv");
+                    monteCarloAI.saveQTable("data/mc_q_table.bin");
                 }
 
                 cout << "\nThanks for playing Blackjack with AI!\n";
@@ -434,7 +591,7 @@ int main() {
                 break;
 
             default:
-                cout << "Invalid choice. Please select 1-14.\n";
+                cout << "Invalid choice. Please select 1-15.\n";
                 break;
         }
     }
@@ -8,12 +8,29 @@
 
 #include "httplib.h"
 #include "../../include/api/Api.h"
+#include "../../include/core/Metrics.h"
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
 #include <cstdlib>
+#include <cstring>
 #include <iostream>
+#include <limits>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <thread>
 
+#ifndef _WIN32
+#include <cerrno>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
 namespace {
 
 api::Params paramsOf(const httplib::Request& req) {
@@ -24,36 +41,263 @@ api::Params paramsOf(const httplib::Request& req) {
     return p;
 }
 
-void send(httplib::Response& res, const api::Response& r) {
+// Moves the body into httplib's response rather than copying it.
+void send(httplib::Response& res, api::Response& r) {
     res.status = r.status;
-    res.set_content(r.body, r.contentType.c_str());
-    res.set_header("Cache-Control", "no-store");
+    if (r.status != 304) res.set_content(std::move(r.body), r.contentType);
+    // Versioned responses may be kept, but must be revalidated every time:
+    // the browser sends If-None-Match and gets a 304 while the version stands.
+    if (!r.etag.empty()) {
+        res.set_header("ETag", r.etag);
+        res.set_header("Cache-Control", "no-cache");
+    } else {
+        res.set_header("Cache-Control", "no-store");
+    }
     if (!r.downloadName.empty()) {
         res.set_header("Content-Disposition",
                        "attachment; filename=\"" + r.downloadName + "\"");
     }
 }
 
-// Training runs on its own thread here so long runs don't block the request
-// handlers. The browser build has no threads and drives api::advanceTraining
-// from its own event loop instead -- same function, same episodes.
-std::thread gTrainer;
+// Latency and responses by status class for one route, in /api/metrics.
+// Latency runs from the handler's start to the response being handed to
+// httplib, so it leaves out parsing and the write to the socket.
+class RouteMetrics {
+private:
+    metrics::Histogram* latency;
+    metrics::Counter* responses[4];   // 2xx .. 5xx
+
+public:
+    explicit RouteMetrics(const std::string& route) {
+        metrics::Registry& reg = metrics::Registry::global();
+        latency = &reg.histogram("blackjack_api_request_seconds",
+                                 "Time to handle an API request, in seconds.",
+                                 metrics::latencyBuckets(), {{"route", route}});
+        for (int c = 0; c < 4; ++c) {
+            responses[c] = &reg.counter("blackjack_api_responses_total",
+                                        "API responses by route and status class.",
+                                        {{"route", route}, {"code", std::to_string(c + 2) + "xx"}});
+        }
+    }
+
+    void record(std::chrono::steady_clock::time_point start, int status) {
+        latency->observe(metrics::secondsSince(start));
+        responses[std::max(2, std::min(5, status / 100)) - 2]->add();
+    }
+};
+
+// Training runs on worker threads here so long runs don't block the request
+// handlers. Each worker runs jobs until there are none it can take, then sleeps
+// until the next POST /api/train. There is one per job that can run at once
+// (TRAIN_WORKERS overrides; fewer than that and running jobs take turns). The
+// browser build has no threads and drives api::advanceTraining from its own
+// event loop instead -- same function, same episodes.
+std::mutex gTrainMu;
+std::condition_variable gTrainWake;
+std::uint64_t gTrainSubmitted = 0;   // POST /api/train calls, guarded by gTrainMu
+
+void trainerLoop() {
+    std::uint64_t seen = 0;
+    for (;;) {
+        {
+            std::lock_guard<std::mutex> lk(gTrainMu);
+            seen = gTrainSubmitted;
+        }
+        api::advanceTraining(std::numeric_limits<long long>::max());
+        std::unique_lock<std::mutex> lk(gTrainMu);
+        gTrainWake.wait(lk, [&] { return gTrainSubmitted != seen; });
+    }
+}
+
+void startTrainers() {
+    unsigned workers = api::maxConcurrentJobs();
+    if (const char* env = std::getenv("TRAIN_WORKERS")) {
+        try { workers = static_cast<unsigned>(std::max(1, std::stoi(env))); } catch (...) {}
+    }
+    for (unsigned i = 0; i < workers; ++i) std::thread(trainerLoop).detach();
+}
+
+// HAND_CAPACITY and HAND_IDLE_SECONDS size the interactive hand table for
+// load tests; unset, the defaults in api::setHandLimits apply.
+void configureHands() {
+    long long capacity = 0;
+    int idleSeconds = 0;
+    if (const char* env = std::getenv("HAND_CAPACITY")) {
+        try { capacity = std::max(0LL, std::stoll(env)); } catch (...) {}
+    }
+    if (const char* env = std::getenv("HAND_IDLE_SECONDS")) {
+        try { idleSeconds = std::max(0, std::stoi(env)); } catch (...) {}
+    }
+    api::setHandLimits(static_cast<std::size_t>(capacity), idleSeconds);
+}
+
+// SEED fixes the master seed, so the seeds the server picks for jobs,
+// simulations and new hands repeat from one run to the next.
+void configureSeed() {
+    if (const char* env = std::getenv("SEED")) {
+        try {
+            api::setSeed(static_cast<std::uint64_t>(std::stoull(env)));
+        } catch (...) {
+            std::cerr << "Invalid SEED '" << env << "', ignoring it\n";
+        }
+    }
+}
 
-void startTrainerThread() {
-    if (gTrainer.joinable()) gTrainer.join();
-    gTrainer = std::thread([] {
+void wakeTrainers() {
+    {
+        std::lock_guard<std::mutex> lk(gTrainMu);
+        ++gTrainSubmitted;
+    }
+    gTrainWake.notify_all();
+}
+
+// /api/train/events holds one of httplib's worker threads for as long as the
+// browser listens, so only a few streams may be open at once; the rest of the
+// API keeps the remaining workers.
+constexpr int MAX_EVENT_STREAMS = 4;
+// How often an idle stream checks for new events -- one atomic load, so the
+// trainer never notices -- and how often it proves the client is still there.
+constexpr auto EVENT_POLL      = std::chrono::milliseconds(50);
+constexpr auto EVENT_HEARTBEAT = std::chrono::seconds(15);
+
+std::atomic<int> gEventStreams{0};
+
+void serveTrainingEvents(const httplib::Request& req, httplib::Response& res) {
+    if (gEventStreams.fetch_add(1) >= MAX_EVENT_STREAMS) {
+        gEventStreams.fetch_sub(1);
+        res.status = 503;
+        res.set_header("Retry-After", "5");
+        res.set_content("{\"error\":\"too many event streams\"}", "application/json");
+        return;
+    }
+
+    auto cursor = std::make_shared<std::uint64_t>(
+        api::trainingEventsFrom(req.get_header_value("Last-Event-ID")));
+    res.set_header("Cache-Control", "no-store");
+    res.set_header("X-Accel-Buffering", "no");
+    res.set_chunked_content_provider(
+        "text/event-stream",
+        [cursor, first = true](std::size_t, httplib::DataSink& sink) mutable {
+            std::string out;
+            if (first) {
+                out = "retry: 2000\n\n";   // EventSource reconnect delay
+                first = false;
+            }
+            auto idleSince = std::chrono::steady_clock::now();
+            while (!api::readTrainingEvents(*cursor, out) && out.empty()) {
+                if (!sink.is_writable()) return false;
+                if (std::chrono::steady_clock::now() - idleSince >= EVENT_HEARTBEAT) {
+                    out = ": keep-alive\n\n";
+                    break;
+                }
+                std::this_thread::sleep_for(EVENT_POLL);
+            }
+            return sink.write(out.data(), out.size());
+        },
+        [](bool) { gEventStreams.fetch_sub(1); });
+}
+
+#ifndef _WIN32
+// Co-located clients can skip HTTP and JSON altogether: with DECIDE_SOCKET set
+// to a path, the server also listens on a Unix socket for api::decidePacked
+// requests, each payload framed by a little-endian u32 byte count, replies
+// framed the same way. A connection carries any number of requests in turn and
+// gets a thread of its own, so a client keeps one open rather than connecting
+// per batch.
+
+bool readFull(int fd, char* buf, std::size_t n) {
+    while (n > 0) {
+        ssize_t got = ::read(fd, buf, n);
+        if (got < 0 && errno == EINTR) continue;
+        if (got <= 0) return false;
+        buf += got;
+        n -= static_cast<std::size_t>(got);
+    }
+    return true;
+}
+
+bool writeFull(int fd, const char* buf, std::size_t n) {
+#ifdef MSG_NOSIGNAL
+    constexpr int flags = MSG_NOSIGNAL;   // a vanished client must not SIGPIPE us
+#else
+    constexpr int flags = 0;
+#endif
+    while (n > 0) {
+        ssize_t sent = ::send(fd, buf, n, flags);
+        if (sent < 0 && errno == EINTR) continue;
+        if (sent <= 0) return false;
+        buf += sent;
+        n -= static_cast<std::size_t>(sent);
+    }
+    return true;
+}
+
+void serveDecisions(int fd) {
+#ifdef SO_NOSIGPIPE
+    int yes = 1;
+    setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &yes, sizeof(yes));
+#endif
+    static RouteMetrics m("unix:decide");
+    std::string request, reply;
+    char prefix[4];
+    while (readFull(fd, prefix, sizeof(prefix))) {
+        std::uint32_t n = 0;
+        for (int i = 3; i >= 0; --i) n = n << 8 | static_cast<std::uint8_t>(prefix[i]);
+        if (n > api::maxDecideRequestBytes()) break;   // not our protocol: hang up
+        request.resize(n);
+        if (!readFull(fd, request.data(), n)) break;
+
+        auto start = std::chrono::steady_clock::now();
+        reply.assign(4, '\0');
+        api::decidePacked(request, reply);
+        std::uint32_t len = static_cast<std::uint32_t>(reply.size() - 4);
+        for (int i = 0; i < 4; ++i) reply[i] = static_cast<char>(len >> (8 * i));
+        if (!writeFull(fd, reply.data(), reply.size())) break;
+        m.record(start, reply[5] == 0 ? 200 : 400);   // the reply's status byte
+    }
+    ::close(fd);
+}
+
+bool listenDecisions(const std::string& path) {
+    sockaddr_un addr{};
+    if (path.size() >= sizeof(addr.sun_path)) {
+        std::cerr << "DECIDE_SOCKET path too long: " << path << "\n";
+        return false;
+    }
+    addr.sun_family = AF_UNIX;
+    std::copy(path.begin(), path.end(), addr.sun_path);
+
+    int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) return false;
+    ::unlink(path.c_str());   // a socket file left by a previous run
+    if (::bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 ||
+        ::listen(fd, SOMAXCONN) != 0) {
+        std::cerr << "Cannot listen on " << path << ": " << std::strerror(errno) << "\n";
+        ::close(fd);
+        return false;
+    }
+    std::thread([fd] {
         for (;;) {
-            long long chunk = api::trainingChunkSize();
-            if (chunk == 0) break;             // job finished or was cancelled
-            api::advanceTraining(chunk);
+            int client = ::accept(fd, nullptr, nullptr);
+            if (client < 0) {
+                if (errno == EINTR || errno == ECONNABORTED) continue;
+                std::cerr << "Decision socket: " << std::strerror(errno) << "\n";
+                return;
+            }
+            std::thread(serveDecisions, client).detach();
         }
-    });
+    }).detach();
+    return true;
 }
+#endif
 
 void route(httplib::Server& svr, const char* path) {
-    auto handler = [path](const httplib::Request& req, httplib::Response& res) {
-        api::Response r = api::handle(path, paramsOf(req));
+    auto handler = [path, m = std::make_shared<RouteMetrics>(path)](
+                       const httplib::Request& req, httplib::Response& res) {
+        auto start = std::chrono::steady_clock::now();
+        api::Response r = api::handle(path, paramsOf(req), req.get_header_value("If-None-Match"));
         send(res, r);
+        m->record(start, res.status);
     };
     svr.Get(path, handler);
     svr.Post(path, handler);
@@ -75,21 +319,40 @@ int main(int argc, char** argv) {
     }
 
     api::init();
+    configureHands();
+    configureSeed();
+    startTrainers();
+
+#ifndef _WIN32
+    if (const char* path = std::getenv("DECIDE_SOCKET")) {
+        if (listenDecisions(path)) std::cout << "Decisions on unix:" << path << "\n";
+    }
+#endif
 
     httplib::Server svr;
 
-    for (const char* p : {"/api/status", "/api/hand/new", "/api/hand/step", "/api/policy",
+    for (const char* p : {"/api/status", "/api/hand/new", "/api/hand/step",
+                          "/api/hand/autoplay", "/api/hands/batch", "/api/decide",
+                          "/api/policy",
                           "/api/simulate", "/api/compare", "/api/train/step",
-                          "/api/train/progress", "/api/train/stop", "/api/save",
-                          "/api/reset", "/api/qtable.csv"}) {
+                          "/api/train/progress", "/api/train/stop", "/api/train/priority",
+                          "/api/train/trace",
+                          "/api/train/jobs", "/api/save",
+                          "/api/reset", "/api/qtable.csv", "/api/optimal",
+                          "/api/metrics"}) {
         route(svr, p);
     }
 
-    // Starting a job also kicks off the worker thread that runs it.
-    svr.Post("/api/train", [](const httplib::Request& req, httplib::Response& res) {
+    svr.Get("/api/train/events", serveTrainingEvents);
+
+    // Submitting a job wakes the workers that run it.
+    svr.Post("/api/train", [m = std::make_shared<RouteMetrics>("/api/train")](
+                               const httplib::Request& req, httplib::Response& res) {
+        auto start = std::chrono::steady_clock::now();
         api::Response r = api::handle("/api/train", paramsOf(req));
         send(res, r);
-        if (r.status == 200) startTrainerThread();
+        if (r.status == 200) wakeTrainers();
+        m->record(start, res.status);
     });
 
     svr.set_mount_point("/", "./web");
@@ -115,6 +378,11 @@ int main(int argc, char** argv) {
                    reinterpret_cast<const char*>(&yes), sizeof(yes));
     });
 
+    // httplib writes a response's headers and body separately. Under Nagle the
+    // body then waits for the client's delayed ACK of the headers -- about 40 ms
+    // on every keep-alive request -- so send segments as soon as they are ready.
+    svr.set_tcp_nodelay(true);
+
     svr.set_exception_handler([](const httplib::Request&, httplib::Response& res, std::exception_ptr ep) {
         std::string what = "internal error";
         try {
@@ -61,6 +61,24 @@ api::Params parseQuery(const std::string& query) {
     return params;
 }
 
+// Binary bodies (format=binary) cannot ride in a JSON string as they are.
+std::string base64(const std::string& in) {
+    static const char* digits =
+        "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    std::string out;
+    out.reserve((in.size() + 2) / 3 * 4);
+    for (size_t i = 0; i < in.size(); i += 3) {
+        unsigned v = static_cast<unsigned char>(in[i]) << 16;
+        if (i + 1 < in.size()) v |= static_cast<unsigned char>(in[i + 1]) << 8;
+        if (i + 2 < in.size()) v |= static_cast<unsigned char>(in[i + 2]);
+        out += digits[(v >> 18) & 63];
+        out += digits[(v >> 12) & 63];
+        out += i + 1 < in.size() ? digits[(v >> 6) & 63] : '=';
+        out += i + 2 < in.size() ? digits[v & 63] : '=';
+    }
+    return out;
+}
+
 // The returned buffer is owned by this module and stays valid until the next
 // call, which is all the JS side needs -- it copies the string immediately.
 std::string gLastResponse;
@@ -75,11 +93,18 @@ void api_init() {
 }
 
 // Returns a JSON envelope: {"status":<int>,"body":<string>} so the JS side can
-// mirror the HTTP status codes the server would have produced.
+// mirror the HTTP status codes the server would have produced. A binary body
+// is base64-encoded and the envelope says so with "encoding":"base64".
 EMSCRIPTEN_KEEPALIVE
 const char* api_request(const char* path, const char* query) {
     api::Response r = api::handle(path ? path : "", parseQuery(query ? query : ""));
 
+    if (r.contentType == "application/octet-stream") {
+        gLastResponse = "{\"status\":" + std::to_string(r.status) +
+                        ",\"encoding\":\"base64\",\"body\":\"" + base64(r.body) + "\"}";
+        return gLastResponse.c_str();
+    }
+
     std::string escaped;
     escaped.reserve(r.body.size() + 16);
     for (char c : r.body) {
@@ -0,0 +1,29 @@
+//
+// The API through api::handle, as both front ends call it: request parsing
+// and seeded replay. No tables are loaded, so the learners play from empty
+// ones -- enough for these, which depend only on the input and the seed.
+//
+
+#include "Check.h"
+#include "Api.h"
+
+TEST(api, decide_rejects_a_trailing_comma) {
+    CHECK(api::handle("/api/decide", {{"states", "16:10:0,"}}).status == 400);
+    CHECK(api::handle("/api/decide", {{"states", "16:10:0"}}).status == 200);
+    CHECK(api::handle("/api/decide", {{"states", "16:10:0,12:2:1"}}).status == 200);
+}
+
+TEST(api, seeded_simulate_is_the_same_at_any_thread_count) {
+    // The pool caps threads= at the machine's hardware threads, so on a
+    // single-core machine both runs are serial.
+    for (const char* agent : {"q", "basic"}) {
+        api::Params one = {{"agent", agent}, {"games", "20000"}, {"seed", "42"}, {"threads", "1"}};
+        api::Params four = one;
+        four["threads"] = "4";
+
+        api::Response a = api::handle("/api/simulate", one);
+        api::Response b = api::handle("/api/simulate", four);
+        CHECK(a.status == 200);
+        CHECK(a.body == b.body);
+    }
+}
@@ -0,0 +1,60 @@
+//
+// AppendLog: segment growth and the full log, then a reader following the
+// writer.
+//
+
+#include "Check.h"
+#include "AppendLog.h"
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+
+namespace {
+
+// Two words that must always be seen together: a torn copy breaks the pairing.
+struct Pair {
+    std::uint64_t value;
+    std::uint64_t check;
+};
+
+Pair pairOf(std::uint64_t n) { return {n, ~n}; }
+
+} // namespace
+
+TEST(append_log, grows_by_segment_and_stops_when_full) {
+    AppendLog<int, 4, 3> log;
+    CHECK(log.capacity() == 12);
+    CHECK(log.size() == 0);
+
+    for (int i = 0; i < 12; ++i) CHECK(log.push(i * 10));
+    CHECK(!log.push(999));
+    CHECK(log.size() == 12);
+
+    // Earlier items stay put as later segments are added.
+    const int& first = log[0];
+    for (std::size_t i = 0; i < log.size(); ++i) CHECK(log[i] == static_cast<int>(i) * 10);
+    CHECK(&first == &log[0]);
+}
+
+TEST(append_log, readers_see_only_complete_items) {
+    constexpr std::size_t ITEMS = 64 * 64;
+    AppendLog<Pair> log;
+    std::atomic<int> bad{0};
+
+    std::thread reader([&] {
+        std::size_t seen = 0;
+        while (seen < ITEMS) {
+            std::size_t n = log.size();
+            for (; seen < n; ++seen) {
+                const Pair& p = log[seen];
+                if (p.value != seen || p.check != ~p.value) ++bad;
+            }
+        }
+    });
+    for (std::size_t i = 0; i < ITEMS; ++i) CHECK(log.push(pairOf(i)));
+    reader.join();
+
+    CHECK(bad.load() == 0);
+    CHECK(!log.push(pairOf(ITEMS)));
+}
@@ -0,0 +1,82 @@
+//
+// BroadcastRing: ordered reads and Lost after an overwrite on one thread, then
+// readers racing the writer.
+//
+
+#include "Check.h"
+#include "BroadcastRing.h"
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// Two words that must always be seen together: a torn copy breaks the pairing.
+struct Pair {
+    std::uint64_t value;
+    std::uint64_t check;
+};
+
+Pair pairOf(std::uint64_t n) { return {n, ~n}; }
+
+} // namespace
+
+TEST(broadcast_ring, reads_in_order_then_reports_overwrites_as_lost) {
+    BroadcastRing<Pair> ring(4);
+    CHECK(ring.capacity() == 4);
+
+    Pair p{};
+    CHECK(ring.read(0, p) == BroadcastRing<Pair>::Read::Empty);
+    for (std::uint64_t n = 0; n < 4; ++n) CHECK(ring.push(pairOf(n)) == n);
+    for (std::uint64_t n = 0; n < 4; ++n) {
+        CHECK(ring.read(n, p) == BroadcastRing<Pair>::Read::Ok);
+        CHECK(p.value == n && p.check == ~n);
+    }
+
+    // Item 4 takes item 0's slot.
+    ring.push(pairOf(4));
+    CHECK(ring.read(0, p) == BroadcastRing<Pair>::Read::Lost);
+    CHECK(ring.oldest() == 1);
+    CHECK(ring.read(1, p) == BroadcastRing<Pair>::Read::Ok && p.value == 1);
+    CHECK(ring.read(4, p) == BroadcastRing<Pair>::Read::Ok && p.value == 4);
+    CHECK(ring.read(5, p) == BroadcastRing<Pair>::Read::Empty);
+    CHECK(ring.end() == 5);
+}
+
+TEST(broadcast_ring, racing_readers_never_see_a_torn_item) {
+    constexpr std::uint64_t ITEMS = 200000;
+    BroadcastRing<Pair> ring(64);
+    std::atomic<bool> done{false};
+    std::atomic<int> torn{0}, wrong{0};
+
+    std::vector<std::thread> readers;
+    for (int r = 0; r < 2; ++r) {
+        readers.emplace_back([&] {
+            std::uint64_t n = 0;
+            Pair p{};
+            while (!done.load() || n < ring.end()) {
+                switch (ring.read(n, p)) {
+                    case BroadcastRing<Pair>::Read::Ok:
+                        if (p.check != ~p.value) ++torn;
+                        if (p.value != n) ++wrong;
+                        ++n;
+                        break;
+                    case BroadcastRing<Pair>::Read::Lost:
+                        n = ring.oldest();   // fell behind: skip ahead
+                        break;
+                    case BroadcastRing<Pair>::Read::Empty:
+                        std::this_thread::yield();
+                        break;
+                }
+            }
+        });
+    }
+    for (std::uint64_t n = 0; n < ITEMS; ++n) ring.push(pairOf(n));
+    done.store(true);
+    for (auto& t : readers) t.join();
+
+    CHECK(torn.load() == 0);
+    CHECK(wrong.load() == 0);
+}
@@ -0,0 +1,54 @@
+//
+// A minimal test harness: no framework, just named test functions and a CHECK
+// macro that reports file:line and carries on, so one run shows every failure.
+// tests/main.cpp runs the registered tests, a suite at a time if asked, and
+// exits non-zero if any check failed -- all ctest needs.
+//
+
+#ifndef BLACKJACK_AI_TESTS_CHECK_H
+#define BLACKJACK_AI_TESTS_CHECK_H
+
+#include <iostream>
+#include <vector>
+
+namespace check {
+
+struct Test {
+    const char* suite;
+    const char* name;
+    void (*run)();
+};
+
+inline std::vector<Test>& registry() {
+    static std::vector<Test> tests;
+    return tests;
+}
+
+inline int& failures() {
+    static int n = 0;
+    return n;
+}
+
+struct Register {
+    Register(const char* suite, const char* name, void (*run)()) {
+        registry().push_back({suite, name, run});
+    }
+};
+
+inline void fail(const char* file, int line, const char* expr) {
+    std::cerr << file << ":" << line << ": CHECK failed: " << expr << "\n";
+    ++failures();
+}
+
+} // namespace check
+
+#define CHECK(cond) \
+    do { if (!(cond)) ::check::fail(__FILE__, __LINE__, #cond); } while (0)
+
+#define TEST(suite, name)                                                   \
+    static void suite##_##name();                                           \
+    static ::check::Register suite##_##name##_registered(#suite, #name,     \
+                                                          suite##_##name); \
+    static void suite##_##name()
+
+#endif //BLACKJACK_AI_TESTS_CHECK_H
@@ -0,0 +1,132 @@
+//
+// HandStore: generation ids, the capacity limit, pinning and timer-wheel
+// expiry. The expiry tests sleep through real seconds (the wheel's tick), so
+// they take a few seconds between them.
+//
+
+#include "Check.h"
+#include "HandStore.h"
+
+#include <chrono>
+#include <thread>
+#include <vector>
+
+namespace {
+
+std::size_t shardOf(HandStore::Id id) {
+    return static_cast<std::size_t>(id) & (HandStore::SHARDS - 1);
+}
+
+std::size_t slotOf(HandStore::Id id) {
+    return (static_cast<std::size_t>(id) >> HandStore::SHARD_BITS) &
+           ((std::size_t{1} << HandStore::SLOT_BITS) - 1);
+}
+
+// Opens a hand and lets go of it at once, leaving it open but unpinned.
+HandStore::Id openIdle(HandStore& store) {
+    HandStore::Lease lease = store.open();
+    CHECK(lease);
+    return lease ? lease.id() : 0;
+}
+
+void sleepSeconds(double s) {
+    std::this_thread::sleep_for(std::chrono::duration<double>(s));
+}
+
+} // namespace
+
+TEST(hand_store, closed_id_is_stale_once_its_slot_is_reused) {
+    HandStore store;
+    HandStore::Id first;
+    {
+        HandStore::Lease lease = store.open();
+        CHECK(lease);
+        first = lease.id();
+        lease.close();
+    }
+    CHECK(!store.find(first));
+
+    // Hands go to the shards in turn, so the next hand in the first one's
+    // shard is dealt into its freed slot, under a new generation.
+    HandStore::Id reused = 0;
+    for (std::size_t i = 0; i < HandStore::SHARDS; ++i) {
+        HandStore::Id id = openIdle(store);
+        if (shardOf(id) == shardOf(first)) reused = id;
+    }
+    CHECK(reused != 0);
+    CHECK(slotOf(reused) == slotOf(first));
+    CHECK(reused != first);
+    CHECK(!store.find(first));
+    CHECK(store.find(reused));
+}
+
+TEST(hand_store, ids_fit_in_a_javascript_number) {
+    HandStore store;
+    for (int i = 0; i < 100; ++i) {
+        HandStore::Lease lease = store.open();
+        CHECK(lease.id() > 0 && lease.id() < (HandStore::Id{1} << 53));
+        lease.close();
+    }
+}
+
+TEST(hand_store, full_shard_recycles_its_idlest_hand) {
+    // The minimum capacity: one hand per shard.
+    HandStore store(HandStore::SHARDS);
+    CHECK(store.capacity() == HandStore::SHARDS);
+
+    std::vector<HandStore::Id> ids;
+    for (std::size_t i = 0; i < HandStore::SHARDS; ++i) ids.push_back(openIdle(store));
+    CHECK(store.size() == HandStore::SHARDS);
+
+    // The next hand lands in the first one's shard and takes its place.
+    HandStore::Id next = openIdle(store);
+    CHECK(shardOf(next) == shardOf(ids[0]));
+    CHECK(store.size() == HandStore::SHARDS);
+    CHECK(!store.find(ids[0]));
+    CHECK(store.find(next));
+    for (std::size_t i = 1; i < ids.size(); ++i) CHECK(store.find(ids[i]));
+}
+
+TEST(hand_store, hands_in_play_are_never_recycled) {
+    HandStore store(HandStore::SHARDS);
+    std::vector<HandStore::Lease> held;
+    for (std::size_t i = 0; i < HandStore::SHARDS; ++i) held.push_back(store.open());
+    for (const HandStore::Lease& lease : held) CHECK(lease);
+
+    // Every shard is full of hands that requests are playing.
+    CHECK(!store.open());
+
+    held.clear();
+    CHECK(store.open());
+}
+
+TEST(hand_store, idle_hands_expire_but_pinned_ones_wait) {
+    HandStore store(HandStore::DEFAULT_CAPACITY, 1);
+    HandStore::Id idle = openIdle(store);
+    HandStore::Id pinnedId;
+    {
+        HandStore::Lease pinned = store.open();
+        CHECK(pinned);
+        pinnedId = pinned.id();
+
+        // Both are past their deadline; only the one nobody holds goes.
+        sleepSeconds(2.2);
+        CHECK(store.size() == 1);
+        CHECK(!store.find(idle));
+    }
+
+    // Released, it expires on the wheel's next tick.
+    sleepSeconds(1.2);
+    CHECK(store.size() == 0);
+    CHECK(!store.find(pinnedId));
+}
+
+TEST(hand_store, lookups_keep_a_hand_alive) {
+    HandStore store(HandStore::DEFAULT_CAPACITY, 2);
+    HandStore::Id id = openIdle(store);
+    for (int i = 0; i < 3; ++i) {
+        sleepSeconds(1.1);
+        CHECK(store.find(id));
+    }
+    CHECK(store.size() == 1);
+}
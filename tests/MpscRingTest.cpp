@@ -0,0 +1,79 @@
+//
+// MpscRing: FIFO order and the capacity bound on one thread, then several
+// producers feeding one consumer.
+//
+
+#include "Check.h"
+#include "MpscRing.h"
+
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// Which producer pushed an item, and its count of items pushed before it.
+struct Item {
+    std::uint64_t producer;
+    std::uint64_t sequence;
+};
+
+} // namespace
+
+TEST(mpsc_ring, fifo_and_bounded) {
+    MpscRing<int> ring(3);
+    CHECK(ring.capacity() == 4);
+
+    int v = 0;
+    CHECK(!ring.tryPop(v));
+    for (int i = 0; i < 4; ++i) CHECK(ring.tryPush(i));
+    CHECK(!ring.tryPush(4));
+    CHECK(ring.depth() == 4);
+
+    for (int i = 0; i < 4; ++i) {
+        CHECK(ring.tryPop(v));
+        CHECK(v == i);
+    }
+    CHECK(!ring.tryPop(v));
+
+    // Wraps round the same slots.
+    for (int i = 0; i < 10; ++i) {
+        CHECK(ring.tryPush(i));
+        CHECK(ring.tryPop(v) && v == i);
+    }
+    CHECK(ring.depth() == 0);
+}
+
+TEST(mpsc_ring, every_item_arrives_once_and_in_producer_order) {
+    constexpr int PRODUCERS = 4;
+    constexpr std::uint64_t EACH = 50000;
+    MpscRing<Item> ring(64);
+
+    std::vector<std::thread> producers;
+    for (int p = 0; p < PRODUCERS; ++p) {
+        producers.emplace_back([&ring, p] {
+            for (std::uint64_t i = 0; i < EACH; ++i) {
+                while (!ring.tryPush({static_cast<std::uint64_t>(p), i})) std::this_thread::yield();
+            }
+        });
+    }
+
+    std::vector<std::uint64_t> next(PRODUCERS, 0);
+    int outOfOrder = 0;
+    for (std::uint64_t got = 0; got < PRODUCERS * EACH;) {
+        Item item{};
+        if (!ring.tryPop(item)) {
+            std::this_thread::yield();
+            continue;
+        }
+        if (item.sequence != next[item.producer]) ++outOfOrder;
+        next[item.producer] = item.sequence + 1;
+        ++got;
+    }
+    for (auto& t : producers) t.join();
+
+    CHECK(outOfOrder == 0);
+    for (std::uint64_t n : next) CHECK(n == EACH);
+    Item extra{};
+    CHECK(!ring.tryPop(extra));
+}
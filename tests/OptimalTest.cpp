@@ -0,0 +1,72 @@
+//
+// OptimalAI: the dealer's outcome odds, the solved EVs against published
+// figures for this rule set (S17, no peek, hit/stand only), and the exact
+// policy evaluator agreeing with the solver and ranking basic strategy no
+// better than it.
+//
+
+#include "Check.h"
+#include "OptimalAI.h"
+#include "Rules.h"
+
+#include <cmath>
+
+namespace {
+
+bool near(double a, double b, double tolerance) {
+    return std::fabs(a - b) <= tolerance;
+}
+
+// Solving a six-deck shoe takes a while in an unoptimised build, so each shoe
+// is solved once and shared by the tests.
+const OptimalAI& solved(int decks) {
+    static const OptimalAI infinite(OptimalAI::INFINITE_DECK), one(1), six(6);
+    return decks == 1 ? one : decks == 6 ? six : infinite;
+}
+
+} // namespace
+
+TEST(optimal, dealer_odds_sum_to_one) {
+    for (int decks : {OptimalAI::INFINITE_DECK, 1, 6}) {
+        const OptimalAI& ai = solved(decks);
+        for (int upcard = 2; upcard <= 11; ++upcard) {
+            const OptimalAI::DealerOdds& odds = ai.dealerOdds(upcard);
+            double sum = odds.bust;
+            for (double p : odds.total) sum += p;
+            CHECK(near(sum, 1.0, 1e-9));
+            CHECK(odds.natural <= odds.total[4]);
+        }
+    }
+}
+
+TEST(optimal, infinite_deck_bust_odds_match_the_standard_table) {
+    // Dealer bust probability by upcard 2..A, S17, no peek.
+    const double bust[10] = {0.3536, 0.3739, 0.3945, 0.4164, 0.4232,
+                             0.2623, 0.2447, 0.2284, 0.2121, 0.1153};
+    const OptimalAI& ai = solved(OptimalAI::INFINITE_DECK);
+    for (int upcard = 2; upcard <= 11; ++upcard)
+        CHECK(near(ai.dealerOdds(upcard).bust, bust[upcard - 2], 1e-4));
+}
+
+TEST(optimal, expected_returns_are_pinned) {
+    CHECK(near(solved(OptimalAI::INFINITE_DECK).expectedReturn(), -0.02057, 5e-5));
+    CHECK(near(solved(1).expectedReturn(), -0.01587, 5e-5));
+    CHECK(near(solved(6).expectedReturn(), -0.01979, 5e-5));
+}
+
+TEST(optimal, evaluating_its_own_policy_gives_its_ev) {
+    for (int decks : {OptimalAI::INFINITE_DECK, 1, 6}) {
+        const OptimalAI& ai = solved(decks);
+        double own = ai.expectedReturn([&ai](const State& s) { return ai.getBestAction(s); });
+        CHECK(near(own, ai.expectedReturn(), 1e-9));
+    }
+}
+
+TEST(optimal, no_policy_beats_it) {
+    for (int decks : {OptimalAI::INFINITE_DECK, 1, 6}) {
+        const OptimalAI& ai = solved(decks);
+        CHECK(ai.expectedReturn(rules::basicStrategy) <= ai.expectedReturn() + 1e-9);
+        double neverHit = ai.expectedReturn([](const State&) { return Action::STAND; });
+        CHECK(neverHit < ai.expectedReturn());
+    }
+}
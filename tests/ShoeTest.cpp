@@ -0,0 +1,56 @@
+//
+// Shoe: seeded replay, and a hand that runs the shoe dry finishing from the
+// discards without dealing any card twice.
+//
+
+#include "Check.h"
+#include "Shoe.h"
+
+#include <set>
+#include <utility>
+
+namespace {
+
+std::pair<int, int> keyOf(const Card& c) {
+    return {static_cast<int>(c.getSuit()), static_cast<int>(c.getRank())};
+}
+
+} // namespace
+
+TEST(shoe, same_seed_deals_the_same_cards) {
+    Shoe a(2), b(2);
+    a.reseed(99);
+    b.reseed(99);
+    for (int i = 0; i < 500; ++i) {
+        a.startHand();
+        b.startHand();
+        CHECK(keyOf(a.dealCard()) == keyOf(b.dealCard()));
+    }
+}
+
+TEST(shoe, hand_that_empties_the_shoe_never_repeats_a_card) {
+    // One deck cut at 95%: two or three cards behind the cut card, so long
+    // hands regularly run past the end of the shoe.
+    Shoe shoe(1, 0.95);
+    shoe.reseed(3);
+    int repeats = 0;
+    for (int hand = 0; hand < 20000; ++hand) {
+        shoe.startHand();
+        std::set<std::pair<int, int>> dealt;
+        int cards = 3 + hand % 9;
+        for (int i = 0; i < cards; ++i) {
+            if (!dealt.insert(keyOf(shoe.dealCard())).second) ++repeats;
+        }
+    }
+    CHECK(repeats == 0);
+}
+
+TEST(shoe, cut_card_reshuffles_between_hands) {
+    Shoe shoe(1, 0.5);
+    shoe.reseed(5);
+    CHECK(!shoe.startHand());
+    while (!shoe.cutCardReached()) shoe.dealCard();
+    CHECK(shoe.remaining() == 26);
+    CHECK(shoe.startHand());
+    CHECK(shoe.remaining() == 52);
+}
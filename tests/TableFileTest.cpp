@@ -0,0 +1,146 @@
+//
+// The binary table format: a round trip, and each kind of damaged or foreign
+// file the loader must refuse while leaving the caller's table alone.
+//
+
+#include "Check.h"
+#include "TableFile.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+namespace {
+
+const std::string PATH = "tablefile_test.bin";
+
+// Offsets into the 88-byte header (see TableFile.cpp).
+constexpr std::size_t VERSION_OFFSET = 8;
+constexpr std::size_t AGENT_OFFSET = 20;
+constexpr std::size_t HEADER_BYTES = 88;
+
+std::vector<char> readFile(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    return std::vector<char>(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+void writeFile(const std::string& path, const std::vector<char>& bytes) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+}
+
+tablefile::Meta sampleMeta() {
+    tablefile::Meta meta;
+    meta.agent = tablefile::AgentType::QLearning;
+    meta.episodes = 123456;
+    meta.epsilon = 0.25;
+    meta.totalReward = -42.5;
+    return meta;
+}
+
+void fillSample(StateTable<QEntry>& table) {
+    QEntry& a = table[State{16, 10, false}];
+    a.q = {-0.5, -0.25};
+    a.visits = {7, 3};
+    QEntry& b = table[State{13, 2, true}];
+    b.q = {0.125, -1.0};
+    b.visits = {0, 12};
+}
+
+// A table holding a single marker entry, to show a failed load left it alone.
+void fillMarker(StateTable<QEntry>& table) {
+    QEntry& m = table[State{20, 11, false}];
+    m.q = {9.0, 9.0};
+}
+
+bool hasMarker(const StateTable<QEntry>& table) {
+    const QEntry* m = table.find(State{20, 11, false});
+    return m != nullptr && m->q[0] == 9.0 && table.find(State{16, 10, false}) == nullptr;
+}
+
+// Saves the sample, applies `damage` to the bytes, and expects the load to
+// fail with an error mentioning `expected`.
+template <typename Damage>
+void expectRejected(Damage damage, const std::string& expected,
+                    tablefile::AgentType agent = tablefile::AgentType::QLearning) {
+    StateTable<QEntry> source;
+    fillSample(source);
+    CHECK(tablefile::save(PATH, sampleMeta(), source));
+
+    std::vector<char> bytes = readFile(PATH);
+    damage(bytes);
+    writeFile(PATH, bytes);
+
+    StateTable<QEntry> table;
+    fillMarker(table);
+    tablefile::Meta meta;
+    std::string error;
+    CHECK(!tablefile::load(PATH, agent, meta, table, error));
+    CHECK(error.find(expected) != std::string::npos);
+    CHECK(hasMarker(table));
+    CHECK(meta.episodes == 0);
+    std::remove(PATH.c_str());
+}
+
+} // namespace
+
+TEST(table_file, round_trip_keeps_values_visits_and_meta) {
+    StateTable<QEntry> source;
+    fillSample(source);
+    CHECK(tablefile::save(PATH, sampleMeta(), source));
+    CHECK(tablefile::isBinary(PATH));
+    CHECK(readFile(PATH).size() == HEADER_BYTES + 6 * 8 + STATE_COUNT * 24);
+
+    StateTable<QEntry> table;
+    fillMarker(table);
+    tablefile::Meta meta;
+    std::string error;
+    CHECK(tablefile::load(PATH, tablefile::AgentType::QLearning, meta, table, error));
+    CHECK(error.empty());
+    CHECK(meta.episodes == 123456 && meta.epsilon == 0.25 && meta.totalReward == -42.5);
+
+    // The load replaces the table: the marker is gone, the sample is back.
+    CHECK(table.find(State{20, 11, false}) == nullptr);
+    int learned = 0;
+    table.forEach([&](const State&, const QEntry&) { ++learned; });
+    CHECK(learned == 2);
+    const QEntry* a = table.find(State{16, 10, false});
+    CHECK(a && a->q[0] == -0.5 && a->q[1] == -0.25 && a->visits[0] == 7 && a->visits[1] == 3);
+    const QEntry* b = table.find(State{13, 2, true});
+    CHECK(b && b->q[0] == 0.125 && b->q[1] == -1.0 && b->visits[0] == 0 && b->visits[1] == 12);
+    std::remove(PATH.c_str());
+}
+
+TEST(table_file, rejects_a_bad_checksum) {
+    expectRejected([](std::vector<char>& b) { b[HEADER_BYTES + 100] ^= 0x01; }, "checksum");
+}
+
+TEST(table_file, rejects_a_bad_magic) {
+    expectRejected([](std::vector<char>& b) { b[0] = 'X'; }, "not a binary Q-table");
+}
+
+TEST(table_file, rejects_another_format_version) {
+    expectRejected([](std::vector<char>& b) { b[VERSION_OFFSET] += 1; }, "format version");
+}
+
+TEST(table_file, rejects_another_agents_table) {
+    expectRejected([](std::vector<char>&) {}, "different agent",
+                   tablefile::AgentType::MonteCarlo);
+    expectRejected([](std::vector<char>& b) { b[AGENT_OFFSET] = 2; }, "different agent");
+}
+
+TEST(table_file, rejects_a_truncated_file) {
+    expectRejected([](std::vector<char>& b) { b.resize(b.size() - 24); }, "size");
+    expectRejected([](std::vector<char>& b) { b.resize(HEADER_BYTES / 2); }, "too short");
+}
+
+TEST(table_file, csv_is_not_binary) {
+    writeFile(PATH, std::vector<char>{'p', 'l', 'a', 'y', 'e', 'r', 'S', 'u', 'm', '\n'});
+    CHECK(!tablefile::isBinary(PATH));
+    std::remove(PATH.c_str());
+    CHECK(tablefile::isCsvPath("data/q_table.csv"));
+    CHECK(!tablefile::isCsvPath("data/q_table.bin"));
+}
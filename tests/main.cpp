@@ -0,0 +1,30 @@
+//
+// Test runner. With no arguments runs every test; otherwise only the suites
+// named (ctest registers one entry per suite).
+//
+
+#include "Check.h"
+
+#include <cstring>
+#include <iostream>
+
+int main(int argc, char** argv) {
+    int ran = 0;
+    for (const check::Test& t : check::registry()) {
+        bool wanted = argc < 2;
+        for (int i = 1; i < argc && !wanted; ++i) wanted = std::strcmp(argv[i], t.suite) == 0;
+        if (!wanted) continue;
+
+        int before = check::failures();
+        t.run();
+        ++ran;
+        std::cout << (check::failures() == before ? "ok   " : "FAIL ")
+                  << t.suite << "." << t.name << "\n";
+    }
+
+    if (ran == 0) {
+        std::cerr << "no tests matched\n";
+        return 1;
+    }
+    return check::failures() == 0 ? 0 : 1;
+}
@@ -26,7 +26,7 @@ const state = {
   agree: { total: 0, same: 0 },
   policyCells: null,
   baselineEV: null,   // basic strategy's measured EV, the target to beat
-  training: { cursor: 0, points: [], poll: null },
+  training: { job: null, cursor: 0, points: [], poll: null, events: null },
 };
 
 const $ = (id) => document.getElementById(id);
@@ -103,6 +103,44 @@ async function apiText(path) {
 
 const post = (path) => api(path, { method: 'POST' });
 
+// The grid and the training series are fetched with format=columns -- one
+// array per field instead of a repeated object per cell -- and unzipped here
+// into the rows the rest of the page works with.
+function columnsToRows(res, keys) {
+  const n = res[keys[0]].length;
+  const rows = new Array(n);
+  for (let i = 0; i < n; i++) {
+    const row = {};
+    for (const k of keys) row[k] = res[k][i];
+    rows[i] = row;
+  }
+  return rows;
+}
+
+async function fetchPolicyCells(agent) {
+  const res = await api(`/api/policy?agent=${agent}&format=columns`);
+  const n = res.count;
+  const cells = new Array(n);
+  for (let i = 0; i < n; i++) {
+    cells[i] = {
+      playerSum: res.playerSum[i],
+      dealerUpcard: res.dealerUpcard[i],
+      usableAce: res.usableAce[i] === 1,
+      action: res.hit[i] ? 'hit' : 'stand',
+      basic: res.basicHit[i] ? 'hit' : 'stand',
+      qHit: res.qHit[i],
+      qStand: res.qStand[i],
+      margin: res.qHit[i] - res.qStand[i],
+      learned: res.learned[i] === 1,
+      visits: res.visits[i],
+    };
+  }
+  return cells;
+}
+
+const PROGRESS_FIELDS = ['episode', 'winRate', 'avgReward', 'epsilon', 'statesLearned',
+                         'queueDepth', 'actorLag'];
+
 function setEngine(live, text) {
   const dot = $('engine-dot');
   dot.classList.toggle('is-live', live);
@@ -480,8 +518,7 @@ function buildPolicyTable(cells, soft) {
 
 async function loadPolicy() {
   try {
-    const res = await api(`/api/policy?agent=${state.agent}`);
-    state.policyCells = res.cells;
+    state.policyCells = await fetchPolicyCells(state.agent);
     renderPolicy();
   } catch (err) {
     setEngine(false, err.message);
@@ -691,6 +728,25 @@ function redrawCharts() {
   });
 }
 
+// Progress readout and chart for the points collected so far.
+function showTrainingProgress(done) {
+  $('s-progress').textContent = Number(done).toLocaleString();
+  if (state.training.points.length) {
+    const last = state.training.points[state.training.points.length - 1];
+    $('s-ev').textContent = last.avgReward.toFixed(3);
+    $('s-winrate').textContent = `${(last.winRate * 100).toFixed(1)}%`;
+    $('s-epsilon').textContent = last.epsilon.toFixed(4);
+    $('s-states').textContent = last.statesLearned;
+  }
+  redrawCharts();
+}
+
+async function refreshMiniGrid() {
+  const cells = await fetchPolicyCells(state.agent);
+  buildGrid($('mini-grid'), cells, { mini: true });
+  if (state.policyCells) { state.policyCells = cells; renderPolicy(); }
+}
+
 async function pollTraining() {
   try {
     // In WASM mode there is no worker thread, so this loop *is* the trainer:
@@ -700,26 +756,15 @@ async function pollTraining() {
       await api(`/api/train/step?episodes=${WASM_STEP_EPISODES}`);
     }
 
-    const res = await api(`/api/train/progress?since=${state.training.cursor}`);
-    state.training.cursor = res.cursor;
-    state.training.points.push(...res.points);
-
-    $('s-progress').textContent = res.done.toLocaleString();
-    if (state.training.points.length) {
-      const last = state.training.points[state.training.points.length - 1];
-      $('s-ev').textContent = last.avgReward.toFixed(3);
-      $('s-winrate').textContent = `${(last.winRate * 100).toFixed(1)}%`;
-      $('s-epsilon').textContent = last.epsilon.toFixed(4);
-      $('s-states').textContent = last.statesLearned;
-    }
-    redrawCharts();
+    const t = state.training;
+    const res = await api(`/api/train/progress?job=${t.job}&since=${t.cursor}&format=columns`);
+    const points = columnsToRows(res, PROGRESS_FIELDS);
+    t.cursor = res.cursor;
+    t.points.push(...points);
+    showTrainingProgress(res.done);
 
     // Refresh the live grid a few times a second at most.
-    if (res.points.length) {
-      const p = await api(`/api/policy?agent=${state.agent}`);
-      buildGrid($('mini-grid'), p.cells, { mini: true });
-      if (state.policyCells) { state.policyCells = p.cells; renderPolicy(); }
-    }
+    if (points.length) await refreshMiniGrid();
 
     if (!res.running) {
       finishTraining(res);
@@ -734,8 +779,91 @@ async function pollTraining() {
   }
 }
 
+// The local server pushes each progress point as a server-sent event the
+// moment the trainer records it (/api/train/events), so there is nothing to
+// poll. Points can arrive faster than the grid is worth redrawing; that is
+// refetched at most every GRID_REFRESH_MS, and only when it has changed.
+const GRID_REFRESH_MS = 400;
+
+function streamTraining() {
+  const es = new EventSource('/api/train/events');
+  const t = state.training;
+  t.events = es;
+  let gridDue = false;
+
+  const scheduleGrid = () => {
+    gridDue = true;
+    if (t.poll) return;
+    t.poll = setTimeout(async () => {
+      t.poll = null;
+      if (!gridDue || t.events !== es) return;
+      gridDue = false;
+      await refreshMiniGrid().catch(() => {});
+    }, GRID_REFRESH_MS);
+  };
+
+  // The stream carries every job's events; this page follows its own.
+  const mine = (ev) => {
+    const d = JSON.parse(ev.data);
+    return d.job === t.job ? d : null;
+  };
+
+  es.addEventListener('start', (ev) => {
+    if (mine(ev)) $('mini-note').textContent = 'Training…';
+  });
+
+  es.addEventListener('progress', (ev) => {
+    const p = mine(ev);
+    if (!p) return;
+    const last = t.points[t.points.length - 1];
+    if (last && p.episode <= last.episode) return;   // already have it
+    t.points.push(p);
+    t.cursor = t.points.length;
+    showTrainingProgress(p.done);
+    scheduleGrid();
+  });
+
+  // This page fell a whole buffer behind: take the series from the top.
+  es.addEventListener('lagged', async () => {
+    const res = await api(`/api/train/progress?job=${t.job}&format=columns`).catch(() => null);
+    if (!res) return;
+    t.points = columnsToRows(res, PROGRESS_FIELDS);
+    t.cursor = res.cursor;
+    showTrainingProgress(res.done);
+    // The skipped span may have held this job's finish or cancel event, which
+    // will never arrive now; end here as pollTraining does.
+    if (!res.running) {
+      es.close();
+      t.events = null;
+      finishTraining(res);
+    }
+  });
+
+  const end = (ev) => {
+    const d = mine(ev);
+    if (!d) return;
+    es.close();
+    t.events = null;
+    finishTraining(d);
+  };
+  es.addEventListener('finish', end);
+  es.addEventListener('cancel', end);
+
+  // EventSource reconnects by itself (resuming from the last event id). If
+  // the server refuses the stream outright, poll instead.
+  es.onerror = () => {
+    if (es.readyState !== EventSource.CLOSED || t.events !== es) return;
+    t.events = null;
+    pollTraining();
+  };
+}
+
 function finishTraining(res) {
   clearTimeout(state.training.poll);
+  if (state.training.events) {
+    state.training.events.close();
+    state.training.events = null;
+  }
   $('btn-train').disabled = false;
   $('btn-train').textContent = 'Start';
   $('btn-train-stop').disabled = true;
@@ -750,7 +878,7 @@ async function startTraining() {
   const episodes = Number($('train-episodes').value) || 100000;
   const reset = $('chk-reset').checked;
 
-  state.training = { cursor: 0, points: [], poll: null };
+  state.training = { job: null, cursor: 0, points: [], poll: null, events: null };
   $('btn-train').disabled = true;
   $('btn-train').textContent = 'Running…';
   $('btn-train-stop').disabled = false;
@@ -758,8 +886,15 @@ async function startTraining() {
   redrawCharts();
 
   try {
-    await post(`/api/train?agent=${state.agent}&episodes=${episodes}&reset=${reset}`);
-    pollTraining();
+    const res = await post(`/api/train?agent=${state.agent}&episodes=${episodes}&reset=${reset}`);
+    state.training.job = res.job;
+    // Another job on this agent (from another tab, or a sweep) runs first.
+    if (res.queuedBehind) $('mini-note').textContent = `Queued behind ${res.queuedBehind} job(s)…`;
+    if (transport.mode === 'http' && typeof EventSource === 'function') {
+      streamTraining();
+    } else {
+      pollTraining();
+    }
   } catch (err) {
     setEngine(false, err.message);
     $('mini-note').textContent = err.message;
@@ -925,7 +1060,10 @@ async function init() {
   $('speed').addEventListener('input', (e) => { $('speed-val').textContent = `${e.target.value}ms`; });
 
   $('btn-train').addEventListener('click', startTraining);
-  $('btn-train-stop').addEventListener('click', () => post('/api/train/stop').catch(() => {}));
+  $('btn-train-stop').addEventListener('click', () => {
+    const job = state.training.job;
+    post(job ? `/api/train/stop?job=${job}` : '/api/train/stop').catch(() => {});
+  });
   $('btn-save').addEventListener('click', async () => {
     const btn = $('btn-save');
     const label = btn.textContent;